@@ -26,6 +26,7 @@ namespace Firebolt {
         Timedout = 2,
         NotConnected = 3,
         AlreadyConnected = 4,
+        NotSubscribed = 5,
         //AuthenticationError, ?
         InvalidRequest = -32600,
         MethodNotFound = -32601,
@@ -36,4 +37,16 @@ namespace Firebolt {
         CapabilityNotPermitted = -40300,
     };
 
+    // Outcome of an asynchronous call, value is only meaningful if error is None
+    template <typename T>
+    struct Result {
+        Error error;
+        T value;
+    };
+
+    template <>
+    struct Result<void> {
+        Error error;
+    };
+
 }
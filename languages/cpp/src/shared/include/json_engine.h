@@ -1,15 +1,18 @@
 #include<iostream>
 #include <fstream>
-
-#include "gtest/gtest.h"
-#include "gmock/gmock.h"
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 #include <nlohmann/json-schema.hpp>
 
 using nlohmann::json;
 using nlohmann::json_schema::json_validator;
-using namespace ::testing;
 
 #define REMOVE_QUOTES(s) (s.substr(1, s.length() - 2))
 #define STRING_TO_BOOL(s) (s == "true" ? true : false)
@@ -26,35 +29,142 @@ inline std::string capitalizeFirstChar(std::string str) {
 class JsonEngine
 {
     private:
-        std::ifstream _file;
-        nlohmann::json _data;
+        struct Param
+        {
+            std::string name;
+            std::unique_ptr<json_validator> validator;
+            std::string error; // why there is no validator
+        };
+
+        struct Method
+        {
+            const json* definition = nullptr;
+            std::string result; // examples[0].result.value, dumped
+            bool event = false;
+            std::vector<Param> params;
+        };
+
+        /* The openrpc document and everything looked up in it per request: methods indexed
+           by name, their example results and a validator per parameter, with all $refs
+           resolved up front. Built once per file, read only afterwards, so any number of
+           engines on any number of threads share it.
+        */
+        class Document
+        {
+            public:
+                Document(const Document&) = delete;
+                Document& operator=(const Document&) = delete;
+
+                Document(const std::string &filename)
+                    : _data(read_json_from_file(filename))
+                {
+                    std::unordered_map<std::string, json> resolved;
+
+                    const json &methods = _data["methods"];
+                    for (const auto &method : methods)
+                    {
+                        if (method.contains("name") == false)
+                        {
+                            continue;
+                        }
+                        auto added = _methods.emplace(method["name"].get<std::string>(), Method());
+                        if (added.second == false)
+                        {
+                            continue;
+                        }
+                        Method &entry = added.first->second;
+                        entry.definition = &method;
+
+                        if (method.contains("examples") && !method["examples"].empty() && method["examples"][0].contains("result"))
+                        {
+                            entry.result = method["examples"][0]["result"].value("value", json()).dump();
+                        }
+                        else
+                        {
+                            entry.result = json().dump();
+                        }
+
+                        for (const auto &tag : method.value("tags", json::array()))
+                        {
+                            entry.event = entry.event || (tag.value("name", "") == "event");
+                        }
+
+                        for (const auto &param : method.value("params", json::array()))
+                        {
+                            Param compiled;
+                            compiled.name = param.value("name", "");
+                            try
+                            {
+                                const json dereferenced = process_schema(param, _data, resolved);
+                                compiled.validator = std::make_unique<json_validator>(nullptr, nlohmann::json_schema::default_string_format_check);
+                                compiled.validator->set_root_schema(dereferenced.value("schema", json::object()));
+                            }
+                            catch (const std::exception &e)
+                            {
+                                compiled.validator.reset();
+                                compiled.error = e.what();
+                            }
+                            entry.params.push_back(std::move(compiled));
+                        }
+                    }
+                }
+                ~Document() = default;
+
+            public:
+                // Loaded by the first engine asking for the file, kept for the rest of the process
+                static const Document& Instance(const std::string &filename)
+                {
+                    static std::mutex lock;
+                    static std::unordered_map<std::string, std::unique_ptr<const Document>> documents;
+
+                    std::lock_guard<std::mutex> guard(lock);
+                    std::unique_ptr<const Document> &document = documents[filename];
+                    if (document == nullptr)
+                    {
+                        // Throws for a file that cannot be read, the next engine asking tries again
+                        std::unique_ptr<const Document> loaded(new Document(filename));
+                        document = std::move(loaded);
+                    }
+                    return *document;
+                }
+
+                const Method* Find(const std::string &name) const
+                {
+                    auto index = _methods.find(name);
+                    return (index != _methods.end() ? &(index->second) : nullptr);
+                }
+
+            private:
+                json _data;
+                std::unordered_map<std::string, Method> _methods;
+        };
 
     public:
 
         JsonEngine()
+            : JsonEngine("../../firebolt-core-open-rpc.json")
         {
-            _data = read_json_from_file("../../firebolt-core-open-rpc.json");
         }
+        JsonEngine(const std::string &filename)
+            : _document(Document::Instance(filename))
+        {
+        }
+
+        ~JsonEngine() = default;
 
-        ~JsonEngine(){
-            if (_file.is_open())
-                _file.close();
+        std::string get_value(const std::string& method_name) const
+        {
+            const Method* method = _document.Find(method_name);
+            return (method != nullptr ? method->result : "");
         }
 
-        std::string get_value(const std::string& method_name)
+        bool is_event(const std::string& method_name) const
         {
-            for (const auto &method : _data["methods"])
-                {
-                    if (method.contains("name") && (method["name"] == method_name))
-                    {
-                        auto value = method["examples"][0]["result"]["value"];
-                        return value.dump();
-                    }
-                }
-            return "";
+            const Method* method = _document.Find(method_name);
+            return ((method != nullptr) && (method->event == true));
         }
 
-        json read_json_from_file(const std::string &filename)
+        static json read_json_from_file(const std::string &filename)
         {
             std::ifstream file(filename);
             if (!file.is_open())
@@ -67,7 +177,7 @@ class JsonEngine
             return j;
         }
 
-        json resolve_reference(const json &full_schema, const std::string &ref)
+        static json resolve_reference(const json &full_schema, const std::string &ref)
         {
             if (ref.find("#/") != 0)
             {
@@ -77,13 +187,13 @@ class JsonEngine
             std::string path = ref.substr(2);
             std::istringstream ss(path);
             std::string token;
-            json current = full_schema;
+            const json* current = &full_schema;
 
             while (std::getline(ss, token, '/'))
             {
-                if (current.contains(token))
+                if (current->contains(token))
                 {
-                    current = current[token];
+                    current = &((*current)[token]);
                 }
                 else
                 {
@@ -91,101 +201,112 @@ class JsonEngine
                 }
             }
 
-            return current;
+            return *current;
+        }
+
+        static json process_schema(const json &schema, const json &full_schema)
+        {
+            std::unordered_map<std::string, json> resolved;
+            return process_schema(schema, full_schema, resolved);
         }
 
-        json process_schema(json schema, const json &full_schema)
+        // As above, remembering every $ref expanded in resolved, so each is only expanded once
+        static json process_schema(const json &schema, const json &full_schema, std::unordered_map<std::string, json> &resolved)
         {
-            if (schema.is_object())
+            json result;
+
+            if (schema.is_object() && schema.contains("$ref"))
             {
-                if (schema.contains("$ref"))
+                const std::string ref = schema["$ref"];
+                auto found = resolved.find(ref);
+                if (found == resolved.end())
                 {
-                    std::string ref = schema["$ref"];
-                    schema = resolve_reference(full_schema, ref);
+                    found = resolved.emplace(ref, process_schema(resolve_reference(full_schema, ref), full_schema, resolved)).first;
                 }
-
+                result = found->second;
+            }
+            else if (schema.is_object())
+            {
+                result = json::object();
                 for (auto &el : schema.items())
                 {
-                    el.value() = process_schema(el.value(), full_schema);
+                    result[el.key()] = process_schema(el.value(), full_schema, resolved);
                 }
             }
             else if (schema.is_array())
             {
+                result = json::array();
                 for (auto &el : schema)
                 {
-                    el = process_schema(el, full_schema);
+                    result.push_back(process_schema(el, full_schema, resolved));
                 }
             }
+            else
+            {
+                result = schema;
+            }
 
-            return schema;
+            return result;
         }
 
 
- #ifdef UNIT_TEST    
-
-        // template <typename RESPONSE>
-        void MockRequest(const WPEFramework::Core::JSONRPC::Message* message)
+        // What is wrong with parameters, the JSON object sent along with a call of method_name:
+        // one line per problem, none if they are fine or the method is unknown
+        std::vector<std::string> validate_params(const std::string& method_name, const std::string& parameters) const
         {
-            std::string methodName = capitalizeFirstChar(message->Designator.Value().c_str());
+            std::vector<std::string> problems;
 
-            /* TODO: Add a flag here that will be set to true if the method name is found in the rpc block, u
-               Use the flag to validate "Method not found" or other errors from SDK if applicable */
-            for (const auto &method : _data["methods"])
+            const Method* method = _document.Find(method_name);
+            if (method != nullptr)
             {
-                if (method.contains("name") && (method["name"] == methodName))
-                {   
-                    // Method name validation
-                    EXPECT_EQ(methodName, method["name"]);
-
-                    // ID Validation
-                    // TODO: Check if id gets incremented by 1 for each request
-                    EXPECT_THAT(message->Id, AllOf(Ge(1),Le(std::numeric_limits<int>::max())));
-
-                    // Schema validation
-                    const json requestParams = json::parse(message->Parameters.Value());
-                    if(method["params"].empty()) {
-                        std::cout << "Schema validation for empty parameters" << std::endl;
-                        EXPECT_EQ(requestParams, "{}"_json);
-                    }
-                    else {
-                        json_validator validator(nullptr, nlohmann::json_schema::default_string_format_check);
-                        const json openRPCParams = method["params"];
-                        for (auto& item : openRPCParams.items()) {
-                            std::string key = item.key();
-                            json currentSchema = item.value();
-                            std::string paramName = currentSchema["name"];
-                            if (requestParams.contains(paramName)) {
-                                json dereferenced_schema = process_schema(currentSchema, _data);
-                                try{
-                                    validator.set_root_schema(dereferenced_schema["schema"]);
-                                    validator.validate(requestParams[paramName]);
-                                    std::cout << "Schema validation succeeded" << std::endl;
-                                }
-                                catch (const std::exception &e){
-                                    FAIL() << "Schema validation error: " << e.what() << std::endl;
-                                }
-                            }
-                        }
+                json requestParams = json::object();
+                try
+                {
+                    if (parameters.empty() == false)
+                    {
+                        requestParams = json::parse(parameters);
                     }
                 }
-            }
-        }
-        
-        template <typename RESPONSE>
-        Firebolt::Error MockResponse(WPEFramework::Core::JSONRPC::Message &message, RESPONSE &response)
-        {
-                std::string methodName = capitalizeFirstChar(message.Designator.Value().c_str());
+                catch (const std::exception &e)
+                {
+                    problems.push_back(std::string("Invalid parameters: ") + e.what());
+                    return problems;
+                }
 
-                // Loop through the methods to find the one with the given name
-                for (const auto &method : _data["methods"])
+                if (method->params.empty())
+                {
+                    if (requestParams != json::object())
+                    {
+                        problems.push_back("Unexpected parameters: " + requestParams.dump());
+                    }
+                }
+                else
                 {
-                    if (method.contains("name") && (method["name"] == methodName))
+                    for (const Param& param : method->params)
                     {
-                        message.Result = method["examples"][0]["result"]["value"].dump();
+                        if (requestParams.contains(param.name))
+                        {
+                            if (param.validator == nullptr)
+                            {
+                                problems.push_back("Schema validation error: " + param.error);
+                                continue;
+                            }
+                            try
+                            {
+                                param.validator->validate(requestParams[param.name]);
+                            }
+                            catch (const std::exception &e)
+                            {
+                                problems.push_back(std::string("Schema validation error: ") + e.what());
+                            }
+                        }
                     }
                 }
-            return Firebolt::Error::None;
+            }
+
+            return problems;
         }
-#endif
-};
 
+    private:
+        const Document& _document;
+};
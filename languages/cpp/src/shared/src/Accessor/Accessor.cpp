@@ -17,8 +17,9 @@
  */
 
 #include "Accessor.h"
+#include "Properties/Properties.h"
 
-#include <chrono>
+#include <algorithm>
 
 namespace FireboltSDK {
 
@@ -26,8 +27,20 @@ namespace FireboltSDK {
 
     Accessor::Accessor(const string& configLine)
         : _workerPool()
-        , _transport(nullptr)
+        , _transport()
         , _config()
+        , _adminLock()
+        , _reconnectJob()
+        , _resubscribeJob()
+        , _online(false)
+        , _reconnecting(false)
+        , _reconnectDelay(0)
+        , _connected(false)
+        , _connectionChanged(false, false)
+        , _generation(0)
+        , _published(0)
+        , _lost(0)
+        , _lostError(Firebolt::Error::None)
     {
         ASSERT(_singleton == nullptr);
         _singleton = this;
@@ -36,13 +49,32 @@ namespace FireboltSDK {
         Logger::SetLogLevel(WPEFramework::Core::EnumerateType<Logger::LogLevel>(_config.LogLevel.Value().c_str()).Value());
 
         FIREBOLT_LOG_INFO(Logger::Category::OpenRPC, Logger::Module<Accessor>(), "Url = %s", _config.WsUrl.Value().c_str());
-        _workerPool = WPEFramework::Core::ProxyType<WorkerPoolImplementation>::Create(_config.WorkerPool.ThreadCount.Value(), _config.WorkerPool.StackSize.Value(), _config.WorkerPool.QueueSize.Value());
+        _workerPool = WPEFramework::Core::ProxyType<WorkerPoolImplementation>::Create(_config.WorkerPool.ThreadCount.Value(), _config.WorkerPool.StackSize.Value(), _config.WorkerPool.QueueSize.Value(), _config.WorkerPool.MaxThreadCount.Value(), _config.WorkerPool.IdleTime.Value());
         WPEFramework::Core::WorkerPool::Assign(&(*_workerPool));
         _workerPool->Run();
+
+        _reconnectDelay = _config.ReconnectDelay.Value();
+        _reconnectJob = WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>(WPEFramework::Core::ProxyType<ReconnectJob>::Create(this));
+        _resubscribeJob = WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>(WPEFramework::Core::ProxyType<ResubscribeJob>::Create(this));
+
+        WPEFramework::Core::JSON::ArrayType<WPEFramework::Core::JSON::String>::Iterator index = _config.CachedProperties.Elements();
+        while (index.Next() == true) {
+            Properties::EnableCache(index.Current().Value());
+        }
     }
 
     Accessor::~Accessor()
     {
+        _online = false;
+        WPEFramework::Core::IWorkerPool::Instance().Revoke(_reconnectJob);
+        _reconnectJob.Release();
+        WPEFramework::Core::IWorkerPool::Instance().Revoke(_resubscribeJob);
+        _resubscribeJob.Release();
+
+        // Its destructor still needs the worker pool, and nobody is listening anymore
+        ++_generation;
+        DestroyTransport();
+
         WPEFramework::Core::IWorkerPool::Assign(nullptr);
         _workerPool->Stop();
 
@@ -52,12 +84,13 @@ namespace FireboltSDK {
 
     Firebolt::Error Accessor::CreateEventHandler()
     {
-         Event::Instance().Configure(_transport);
+         Event::Instance().Configure(_transport.Load());
          return Firebolt::Error::None;
     }
 
     Firebolt::Error Accessor::DestroyEventHandler()
     {
+         PropertyCache::Instance().Detach();
          Event::Dispose();
          return Firebolt::Error::None;
     }
@@ -69,61 +102,168 @@ namespace FireboltSDK {
 
     Firebolt::Error Accessor::CreateTransport(const string& url, const uint32_t waitTime = DefaultWaitTime)
     {
-        if (_transport != nullptr) {
-            delete _transport;
-        }
+        // The transport being replaced may close later, once its last user is done with it
+        const uint32_t generation = ++_generation;
+        DestroyTransport();
+        // Nor do they keep it, the channel it shares with the new one included, any longer than that
+        Async::Instance().Configure(nullptr);
+        Event::Instance().Configure(nullptr);
+        _connected = false;
 
-        _transport = new Transport<WPEFramework::Core::JSON::IElement>(
-                static_cast<WPEFramework::Core::URL>(url),
+        // Until Publish(), the state changes of the new transport are only recorded: it may
+        // change state from its constructor on, before anyone can reach it.
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = std::make_shared<Transport<WPEFramework::Core::JSON::IElement>>(
+                url,
                 waitTime,
-                std::bind(&Accessor::ConnectionChanged, this, std::placeholders::_1, std::placeholders::_2));
+                [this, generation](const bool connected, const Firebolt::Error error) {
+                    if (generation == _generation.load()) {
+                        if (connected == false) {
+                            _lostError = error;
+                            _lost = generation;
+                        }
+                        if (generation == _published.load()) {
+                            Report(generation, connected, error);
+                        }
+                    }
+                });
 
-        ASSERT(_transport != nullptr);
-        return ((_transport != nullptr) ? Firebolt::Error::None : Firebolt::Error::Timedout);
+        ASSERT(transport != nullptr);
+        _transport.Store(transport);
+        return ((transport != nullptr) ? Firebolt::Error::None : Firebolt::Error::Timedout);
     }
 
     Firebolt::Error Accessor::DestroyTransport()
     {
-        if (_transport != nullptr) {
-            delete _transport;
-            _transport = nullptr;
-        }
+        // Deleted by whoever lets go of it last, here or a call still using it
+        _transport.Store(nullptr);
         return Firebolt::Error::None;
     }
 
+    // Called with _adminLock taken
+    Firebolt::Error Accessor::Open()
+    {
+        Firebolt::Error status = CreateTransport(_config.WsUrl.Value().c_str(), _config.WaitTime.Value());
+        if (status == Firebolt::Error::None) {
+            Async::Instance().Configure(_transport.Load());
+            status = CreateEventHandler();
+            if (status == Firebolt::Error::None) {
+                Publish(_generation.load());
+            }
+        }
+        return status;
+    }
+
+    // Called with _adminLock taken, once the transport is reachable through Async and Event too.
+    // A state change racing with this one is reported by whichever of the two sees the other.
+    void Accessor::Publish(const uint32_t generation)
+    {
+        _published = generation;
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = _transport.Load();
+        if ((transport != nullptr) && (transport->IsOpen() == true)) {
+            Report(generation, true, Firebolt::Error::None);
+        } else if (_lost.load() == generation) {
+            Report(generation, false, _lostError.load());
+        }
+    }
+
+    // The connected state is reported once, a loss once per time it is recorded
+    void Accessor::Report(const uint32_t generation, const bool connected, const Firebolt::Error error)
+    {
+        if (connected == true) {
+            if (_connected.exchange(true) == false) {
+                ConnectionChanged(true, error);
+            }
+        } else {
+            uint32_t lost = generation;
+            if (_lost.compare_exchange_strong(lost, 0) == true) {
+                ConnectionChanged(false, error);
+            }
+        }
+    }
+
+    void Accessor::Reconnect()
+    {
+        _adminLock.Lock();
+        // Cleared first: if this attempt fails too, its ConnectionChanged schedules the next one
+        _reconnecting = false;
+        if ((_online == true) && (_connected == false)) {
+            FIREBOLT_LOG_INFO(Logger::Category::OpenRPC, Logger::Module<Accessor>(), "Reconnecting to %s", _config.WsUrl.Value().c_str());
+            Open();
+        }
+        _adminLock.Unlock();
+    }
+
+    void Accessor::Resubscribe()
+    {
+        // The event handler only exists between Open and Disconnect, both done under this lock
+        _adminLock.Lock();
+        if ((_connected == true) && (_transport.IsSet() == true)) {
+            Event::Instance().Resubscribe();
+        }
+        _adminLock.Unlock();
+    }
+
+    void Accessor::ScheduleReconnect()
+    {
+        bool idle = false;
+        if ((_online == true) && (_reconnecting.compare_exchange_strong(idle, true) == true)) {
+            const uint32_t delay = _reconnectDelay.load();
+            _reconnectDelay = std::min(std::max(delay * 2, _config.ReconnectDelay.Value()), _config.MaxReconnectDelay.Value());
+            WPEFramework::Core::IWorkerPool::Instance().Schedule(WPEFramework::Core::Time::Now().Add(delay), _reconnectJob);
+        }
+    }
+
     void Accessor::ConnectionChanged(const bool connected, const Firebolt::Error error)
     {
-        _connectionChangeSync.signal(); // Signal waiting thread that the connection changed
         _connected = connected;
+        _connectionChanged.SetEvent();
+        PropertyCache::Instance().InvalidateAll(); // Missed change events can not be told apart from quiet properties
+        if (connected == true) {
+            _reconnectDelay = _config.ReconnectDelay.Value();
+            // The server does not know the listeners of the previous connection
+            WPEFramework::Core::IWorkerPool::Instance().Submit(_resubscribeJob);
+        } else {
+            ScheduleReconnect();
+        }
         if (_connectionChangeListener != nullptr) { // Notify a listener about the connection change
              _connectionChangeListener(connected, error);
         }
     }
 
-    Transport<WPEFramework::Core::JSON::IElement>* Accessor::GetTransport()
+    std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> Accessor::GetTransport()
     {
-        if (_transport == nullptr || ! _connected) { // Try to connect if not connected: application has not yet connected or connection has been lost
-            DestroyTransport(); // Clean the transport if necessary
-
-            _connectionChangeSync.reset();
-            Firebolt::Error status = CreateTransport( // Recreate the transport with the configuration passed to CTor
-                _config.WsUrl.Value().c_str(),
-                _config.WaitTime.Value());
-
-            bool ret = _connectionChangeSync.wait_for(_config.WaitTime.Value()); // Wait for the signal that the connection has changed, but no more than `WaitTime`
-
-            if (ret) { // Check if the connection successfully established
-                ASSERT(_transport != nullptr);
-                if (status == Firebolt::Error::None) { // If yes, proceed with the configuration of Async and Event-Handler
-                    Async::Instance().Configure(_transport);
-                    status = CreateEventHandler();
-                }
-            } else { // If the connection cannot be established, clean the transport
-                DestroyTransport();
+        if ((_connected.load(std::memory_order_acquire) == false) && (_online.load() == false)) {
+            // The application never connected, or disconnected: connect on first use, as before.
+            // Whoever calls in meanwhile waits for the same attempt.
+            _adminLock.Lock();
+            if (_online == false) {
+                _online = true;
+                _connectionChanged.ResetEvent();
+                Open();
             }
+            _adminLock.Unlock();
+            _connectionChanged.Lock(_config.WaitTime.Value());
         }
 
-        return _transport;
+        return (_connected.load(std::memory_order_acquire) == true ? _transport.Load() : nullptr);
+    }
+
+    void Accessor::GetStatistics(string& text) const
+    {
+        const WorkerPoolImplementation::Metrics metrics = GetWorkerPoolMetrics();
+
+        text += _T("{\"transport\":");
+        Statistics::Instance().ToString(text);
+        text += _T(",\"workerPool\":{\"threads\":") + std::to_string(metrics.threads);
+        text += _T(",\"busy\":") + std::to_string(metrics.busy);
+        text += _T(",\"urgentDepth\":") + std::to_string(metrics.urgentDepth);
+        text += _T(",\"normalDepth\":") + std::to_string(metrics.normalDepth);
+        text += _T(",\"maxDepth\":") + std::to_string(metrics.maxDepth);
+        text += _T(",\"overflows\":") + std::to_string(metrics.overflows);
+        text += _T(",\"rejected\":") + std::to_string(metrics.rejected);
+        text += _T(",\"dispatched\":") + std::to_string(metrics.dispatched);
+        text += _T(",\"averageWait\":") + std::to_string(metrics.averageWait);
+        text += _T(",\"maxWait\":") + std::to_string(metrics.maxWait) + _T("}}");
     }
 
 }
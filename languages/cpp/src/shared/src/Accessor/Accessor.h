@@ -20,13 +20,14 @@
 
 #include "Module.h"
 #include "WorkerPool.h"
+#include "Published.h"
 #include "Transport/Transport.h"
 #include "Async/Async.h"
 #include "Event/Event.h"
 #include "Logger/Logger.h"
 
-#include <condition_variable>
-#include <mutex>
+#include <atomic>
+#include <memory>
 
 namespace FireboltSDK {
     class Accessor {
@@ -52,10 +53,14 @@ namespace FireboltSDK {
                         , QueueSize(8)
                         , ThreadCount(3)
                         , StackSize(WPEFramework::Core::Thread::DefaultStackSize())
+                        , MaxThreadCount(8)
+                        , IdleTime(WorkerPoolImplementation::DefaultIdleTime)
                     {
                         Add("queueSize", &QueueSize);
                         Add("threadCount", &ThreadCount);
                         Add("stackSize", &StackSize);
+                        Add("maxThreadCount", &MaxThreadCount);
+                        Add("idleTime", &IdleTime);
                     }
 
                     virtual ~WorkerPoolConfig() = default;
@@ -64,6 +69,9 @@ namespace FireboltSDK {
                     WPEFramework::Core::JSON::DecUInt32 QueueSize;
                     WPEFramework::Core::JSON::DecUInt32 ThreadCount;
                     WPEFramework::Core::JSON::DecUInt32 StackSize;
+                    // Above threadCount, the pool grows with its backlog up to this many threads
+                    WPEFramework::Core::JSON::DecUInt32 MaxThreadCount;
+                    WPEFramework::Core::JSON::DecUInt32 IdleTime;
                 };
 
 
@@ -73,11 +81,17 @@ namespace FireboltSDK {
                 , LogLevel(_T("Info"))
                 , WorkerPool()
                 , WsUrl(_T("ws://127.0.0.1:9998"))
+                , CachedProperties()
+                , ReconnectDelay(500)
+                , MaxReconnectDelay(30000)
             {
                 Add(_T("waitTime"), &WaitTime);
                 Add(_T("logLevel"), &LogLevel);
                 Add(_T("workerPool"), &WorkerPool);
                 Add(_T("wsUrl"), &WsUrl);
+                Add(_T("cachedProperties"), &CachedProperties);
+                Add(_T("reconnectDelay"), &ReconnectDelay);
+                Add(_T("maxReconnectDelay"), &MaxReconnectDelay);
             }
 
         public:
@@ -85,6 +99,10 @@ namespace FireboltSDK {
             WPEFramework::Core::JSON::String LogLevel;
             WorkerPoolConfig WorkerPool;
             WPEFramework::Core::JSON::String WsUrl;
+            WPEFramework::Core::JSON::ArrayType<WPEFramework::Core::JSON::String> CachedProperties;
+            // In ms, doubled after every failed attempt up to the maximum
+            WPEFramework::Core::JSON::DecUInt32 ReconnectDelay;
+            WPEFramework::Core::JSON::DecUInt32 MaxReconnectDelay;
         };
 
         Accessor(const Accessor&) = delete;
@@ -111,11 +129,16 @@ namespace FireboltSDK {
         Firebolt::Error Connect(const Transport<WPEFramework::Core::JSON::IElement>::Listener& listener)
         {
             RegisterConnectionChangeListener(listener);
-            Firebolt::Error status = CreateTransport(_config.WsUrl.Value().c_str(), _config.WaitTime.Value());
-            if (status == Firebolt::Error::None) {
-                Async::Instance().Configure(_transport);
-                status = CreateEventHandler();
-            }
+
+            // Connecting right now, a pending retry would only tear this attempt down
+            WPEFramework::Core::IWorkerPool::Instance().Revoke(_reconnectJob);
+            _reconnecting = false;
+
+            _adminLock.Lock();
+            _online = true;
+            Firebolt::Error status = Open();
+            _adminLock.Unlock();
+
             return status;
         }
 
@@ -131,15 +154,21 @@ namespace FireboltSDK {
 
         Firebolt::Error Disconnect()
         {
-            if (_transport == nullptr) {
-                return Firebolt::Error::None;
-            }
+            // No reconnecting behind the application's back anymore
+            _online = false;
+            WPEFramework::Core::IWorkerPool::Instance().Revoke(_reconnectJob);
+            _reconnecting = false;
+
             Firebolt::Error status = Firebolt::Error::None;
-            status = DestroyTransport();
-            if (status == Firebolt::Error::None) {
-                Async::Dispose();
-                status = DestroyEventHandler();
+            _adminLock.Lock();
+            if (_transport.IsSet() == true) {
+                status = DestroyTransport();
+                if (status == Firebolt::Error::None) {
+                    Async::Dispose();
+                    status = DestroyEventHandler();
+                }
             }
+            _adminLock.Unlock();
             return status;
         }
 
@@ -149,43 +178,103 @@ namespace FireboltSDK {
         }
 
         Event& GetEventManager();
-        Transport<WPEFramework::Core::JSON::IElement>* GetTransport();
+        // nullptr while there is no connection, which is then being re-established in the background.
+        // Only if the application never connected, the first call connects and waits for it, up to waitTime.
+        // Hold on to the result for the whole call: a reconnect replaces the transport, it does not
+        // go away before its last user lets go of it.
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> GetTransport();
+
+        WorkerPoolImplementation::Metrics GetWorkerPoolMetrics() const
+        {
+            return _workerPool->GetMetrics();
+        }
+        // Per method call counts and latencies, plus the worker pool, as a JSON document. Times are in us.
+        void GetStatistics(string& text) const;
 
     private:
+        class ReconnectJob : public WPEFramework::Core::IDispatch {
+        protected:
+            ReconnectJob(Accessor* parent)
+                : _parent(parent)
+            {
+            }
+
+        public:
+            ReconnectJob() = delete;
+            ReconnectJob(const ReconnectJob&) = delete;
+            ReconnectJob& operator=(const ReconnectJob&) = delete;
+
+            ~ReconnectJob() = default;
+
+        public:
+            void Dispatch() override
+            {
+                _parent->Reconnect();
+            }
+
+        private:
+            Accessor* _parent;
+        };
+
+        class ResubscribeJob : public WPEFramework::Core::IDispatch {
+        protected:
+            ResubscribeJob(Accessor* parent)
+                : _parent(parent)
+            {
+            }
+
+        public:
+            ResubscribeJob() = delete;
+            ResubscribeJob(const ResubscribeJob&) = delete;
+            ResubscribeJob& operator=(const ResubscribeJob&) = delete;
+
+            ~ResubscribeJob() = default;
+
+        public:
+            void Dispatch() override
+            {
+                _parent->Resubscribe();
+            }
+
+        private:
+            Accessor* _parent;
+        };
+
+    private:
+        Firebolt::Error Open();
+        void Reconnect();
+        void Resubscribe();
+        void ScheduleReconnect();
         Firebolt::Error CreateEventHandler();
         Firebolt::Error DestroyEventHandler();
         Firebolt::Error CreateTransport(const string& url, const uint32_t waitTime);
         Firebolt::Error DestroyTransport();
 
+        void Publish(const uint32_t generation);
+        void Report(const uint32_t generation, const bool connected, const Firebolt::Error error);
         void ConnectionChanged(const bool connected, const Firebolt::Error error);
 
     private:
         WPEFramework::Core::ProxyType<WorkerPoolImplementation> _workerPool;
-        Transport<WPEFramework::Core::JSON::IElement>* _transport;
+        Published<Transport<WPEFramework::Core::JSON::IElement>> _transport;
         static Accessor* _singleton;
         Config _config;
-        struct {
-            std::mutex m;
-            std::condition_variable cv;
-            bool ready = false;
-            void reset() {
-                std::lock_guard lk(m);
-                ready = false;
-            }
-            bool wait_for(unsigned duration_ms) {
-                std::unique_lock lk(m);
-                bool ret = cv.wait_for(lk, std::chrono::milliseconds(duration_ms), [&]{ return ready; });
-                lk.unlock();
-                return ret;
-            }
-            void signal() {
-                std::lock_guard lk(m);
-                ready = true;
-                cv.notify_one();
-            }
-        } _connectionChangeSync; // Synchronize a thread that is waiting for a connection if that one that is notified about connection changes
+        // Serializes (re)connecting against Connect and Disconnect. Never taken from
+        // ConnectionChanged, which runs with the channel locked.
+        WPEFramework::Core::CriticalSection _adminLock;
+        WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> _reconnectJob;
+        WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> _resubscribeJob;
+        std::atomic<bool> _online; // a connection is wanted
+        std::atomic<bool> _reconnecting;
+        std::atomic<uint32_t> _reconnectDelay;
 
-        bool _connected = false;
+        std::atomic<bool> _connected;
+        WPEFramework::Core::Event _connectionChanged;
+        // Tells the transport in use from the ones it replaced, which are not listened to anymore
+        std::atomic<uint32_t> _generation;
+        std::atomic<uint32_t> _published; // the generation reachable by everyone, whose state changes are reported
+        std::atomic<uint32_t> _lost; // the generation that lost its link, until reported
+        std::atomic<Firebolt::Error> _lostError;
         Transport<WPEFramework::Core::JSON::IElement>::Listener _connectionChangeListener = nullptr;
     };
 }
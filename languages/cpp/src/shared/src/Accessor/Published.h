@@ -0,0 +1,130 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace FireboltSDK {
+
+    /* A shared_ptr that is read on every call and replaced once in a while, such as the
+       transport. std::atomic_load of a shared_ptr takes a lock out of a global pool for every
+       read; here a read only pins the current generation and copies the pointer out of it.
+       There are two generations: a replacement fills the one not in use, makes it current,
+       and then waits for the readers still in the previous one before letting go of what it
+       held. A reader that pinned a generation which is no longer current lets go and reads
+       again, so it never sees a generation being filled or emptied.
+       Replacements are serialized among themselves, reads never wait for them.
+    */
+    template <typename TYPE>
+    class Published {
+    private:
+        struct alignas(64) Generation {
+            Generation()
+                : pointer()
+                , readers(0)
+            {
+            }
+
+            std::shared_ptr<TYPE> pointer;
+            mutable std::atomic<uint32_t> readers;
+        };
+
+    public:
+        Published(const Published&) = delete;
+        Published& operator=(const Published&) = delete;
+
+        Published()
+            : _generations()
+            , _current(&_generations[0])
+            , _writeLock()
+        {
+        }
+        ~Published() = default;
+
+    public:
+        std::shared_ptr<TYPE> Load() const
+        {
+            std::shared_ptr<TYPE> result;
+            Read([&result](const std::shared_ptr<TYPE>& pointer) { result = pointer; });
+            return (result);
+        }
+
+        // Without taking a reference
+        bool IsSet() const
+        {
+            bool result = false;
+            Read([&result](const std::shared_ptr<TYPE>& pointer) { result = (pointer != nullptr); });
+            return (result);
+        }
+
+        void Store(std::shared_ptr<TYPE> pointer)
+        {
+            Exchange(std::move(pointer));
+        }
+
+        // Returns what was published before, released by the caller once it is done with it
+        std::shared_ptr<TYPE> Exchange(std::shared_ptr<TYPE> pointer)
+        {
+            std::lock_guard<std::mutex> guard(_writeLock);
+
+            Generation* previous = _current.load(std::memory_order_relaxed);
+            Generation* next = (previous == &_generations[0] ? &_generations[1] : &_generations[0]);
+
+            // Not current, so whoever still pins it is about to let go without reading it
+            Drain(*next);
+            next->pointer = std::move(pointer);
+            _current.store(next, std::memory_order_seq_cst);
+
+            Drain(*previous);
+            return (std::move(previous->pointer));
+        }
+
+    private:
+        template <typename ACTION>
+        void Read(ACTION&& action) const
+        {
+            bool done = false;
+            while (done == false) {
+                const Generation* generation = _current.load(std::memory_order_acquire);
+                // Sequentially consistent on purpose: the pin and Drain must observe each other
+                generation->readers.fetch_add(1, std::memory_order_seq_cst);
+                if (_current.load(std::memory_order_seq_cst) == generation) {
+                    action(generation->pointer);
+                    done = true;
+                }
+                generation->readers.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        static void Drain(const Generation& generation)
+        {
+            while (generation.readers.load(std::memory_order_seq_cst) != 0) {
+                std::this_thread::yield();
+            }
+        }
+
+    private:
+        Generation _generations[2];
+        std::atomic<Generation*> _current;
+        std::mutex _writeLock;
+    };
+}
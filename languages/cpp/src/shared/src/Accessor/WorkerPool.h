@@ -19,17 +19,102 @@
 #pragma once
 
 #include "Module.h"
+#include "Logger/Logger.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+
+#include <limits.h>
+#include <pthread.h>
 
 namespace FireboltSDK {
 
+    // Implemented by jobs that may ask to be dispatched ahead of everything else,
+    // e.g. responses a caller is blocked on, which must not queue behind app callbacks.
+    class IUrgent {
+    public:
+        virtual ~IUrgent() = default;
+        virtual bool IsUrgent() const = 0;
+    };
+
+    /* With maxThreads above threads, submitted jobs bypass the fixed Thunder pool and go
+       to an elastic one: an urgent and a normal lane served by at least threads and at
+       most maxThreads minions. A minion is added when the backlog exceeds the idle
+       minions and retires after idleTime without work. Scheduled jobs stay with the
+       Thunder pool.
+       Submit never blocks, it is called from the thread reading the socket too. A lane
+       holding queueSize jobs (0: no limit) takes more anyway; every job beyond it is
+       counted as an overflow. Once stopped, only minions can still submit, for the jobs
+       being drained; anything else is rejected, and counted.
+       Thread counts are clamped to MaxThreads, threads to at least one. When elastic, the
+       Thunder pool runs one thread, for the scheduled jobs.
+       Minions run on stackSize stacks (0: the system default). They are counted in under
+       the lock but created outside it, so a Submit that adds one does not hold up the others.
+    */
     class WorkerPoolImplementation : public WPEFramework::Core::WorkerPool {
+    public:
+        static constexpr uint32_t DefaultIdleTime = 5000;
+        static constexpr uint32_t MaxThreads = 255; // as many as the Thunder pool takes
+
+        struct Metrics {
+            uint32_t threads;
+            uint32_t busy;
+            uint32_t urgentDepth;
+            uint32_t normalDepth;
+            uint32_t maxDepth;
+            uint64_t overflows; // jobs queued beyond queueSize
+            uint64_t rejected; // jobs submitted after Stop
+            uint64_t dispatched;
+            uint64_t averageWait; // us, from submit to dispatch
+            uint64_t maxWait; // us
+        };
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Queued {
+            WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> job;
+            Clock::time_point submitted;
+        };
+        using Lane = std::deque<Queued>;
+
+        struct Running {
+            const WPEFramework::Core::IDispatch* job;
+            std::thread::id minion;
+        };
+
     public:
         WorkerPoolImplementation() = delete;
         WorkerPoolImplementation(const WorkerPoolImplementation&) = delete;
         WorkerPoolImplementation& operator=(const WorkerPoolImplementation&) = delete;
 
-        WorkerPoolImplementation(const uint8_t threads, const uint32_t stackSize, const uint32_t queueSize)
-            : WorkerPool(threads, stackSize, queueSize, &_dispatcher)
+        WorkerPoolImplementation(const uint32_t threads, const uint32_t stackSize, const uint32_t queueSize, const uint32_t maxThreads = 0, const uint32_t idleTime = DefaultIdleTime)
+            : WorkerPool(BaseThreads(threads, maxThreads), stackSize, queueSize, &_dispatcher)
+            , _minThreads(std::min(std::max(threads, 1u), MaxThreads))
+            , _maxThreads(std::min(maxThreads, MaxThreads))
+            , _idleTime(idleTime)
+            , _stackSize(stackSize)
+            , _queueSize(queueSize)
+            , _lock()
+            , _wakeup()
+            , _done()
+            , _urgent()
+            , _normal()
+            , _running()
+            , _active(false)
+            , _threads(0)
+            , _starting(0)
+            , _idle(0)
+            , _maxDepth(0)
+            , _overflows(0)
+            , _rejected(0)
+            , _dispatched(0)
+            , _totalWait(0)
+            , _maxWait(0)
         {
         }
 
@@ -42,12 +127,228 @@ namespace FireboltSDK {
     public:
         void Stop()
         {
+            if (IsElastic() == true) {
+                std::unique_lock<std::mutex> lock(_lock);
+                _active = false;
+                _wakeup.notify_all();
+                // Minions drain what is queued before they leave
+                _done.wait(lock, [this] { return (_threads == 0); });
+            }
             WPEFramework::Core::WorkerPool::Stop();
         }
 
         void Run()
         {
             WPEFramework::Core::WorkerPool::Run();
+            if (IsElastic() == true) {
+                uint32_t spawn = 0;
+                std::unique_lock<std::mutex> lock(_lock);
+                _active = true;
+                while ((_threads < _minThreads) && (Reserve() == true)) {
+                    ++spawn;
+                }
+                lock.unlock();
+
+                while (spawn-- != 0) {
+                    Spawn();
+                }
+            }
+        }
+
+        void Submit(const WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>& job) override
+        {
+            if (IsElastic() == false) {
+                WPEFramework::Core::WorkerPool::Submit(job);
+            } else {
+                const IUrgent* urgent = dynamic_cast<const IUrgent*>(job.operator->());
+                std::unique_lock<std::mutex> lock(_lock);
+                Lane& lane = (((urgent != nullptr) && (urgent->IsUrgent() == true)) ? _urgent : _normal);
+                // A minion stopping drains the lanes, what it submits meanwhile still runs
+                if ((_active == false) && ((_threads == 0) || (IsMinion() == false))) {
+                    ++_rejected;
+                    lock.unlock();
+                    FIREBOLT_LOG_ERROR(Logger::Category::OpenRPC, Logger::Module<WorkerPoolImplementation>(), "Job submitted after Stop, it will not run");
+                } else {
+                    if ((_queueSize != 0) && (lane.size() >= _queueSize)) {
+                        ++_overflows;
+                    }
+                    lane.push_back({ job, Clock::now() });
+
+                    const uint32_t depth = static_cast<uint32_t>(_urgent.size() + _normal.size());
+                    _maxDepth = std::max(_maxDepth, depth);
+                    // Minions still starting take a job as soon as they are up
+                    const bool spawn = ((depth > (_idle + _starting)) && (Reserve() == true));
+                    if (spawn == false) {
+                        _wakeup.notify_one();
+                    }
+                    lock.unlock();
+
+                    if (spawn == true) {
+                        Spawn();
+                    }
+                }
+            }
+        }
+
+        uint32_t Revoke(const WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>& job, const uint32_t waitTime = WPEFramework::Core::infinite) override
+        {
+            uint32_t result = WPEFramework::Core::WorkerPool::Revoke(job, waitTime);
+
+            if (IsElastic() == true) {
+                const WPEFramework::Core::IDispatch* target = job.operator->();
+                std::unique_lock<std::mutex> lock(_lock);
+                for (Lane* lane : { &_urgent, &_normal }) {
+                    for (Lane::iterator index = lane->begin(); index != lane->end(); ++index) {
+                        if (index->job.operator->() == target) {
+                            lane->erase(index);
+                            result = WPEFramework::Core::ERROR_NONE;
+                            break;
+                        }
+                    }
+                }
+                // Wait for it to finish if it is running, unless it is revoking itself
+                std::list<Running>::const_iterator running = Find(target);
+                if ((running != _running.end()) && (running->minion != std::this_thread::get_id())) {
+                    result = WPEFramework::Core::ERROR_NONE;
+                    auto finished = [this, target] { return (Find(target) == _running.end()); };
+                    if (waitTime == WPEFramework::Core::infinite) {
+                        _done.wait(lock, finished);
+                    } else if (_done.wait_for(lock, std::chrono::milliseconds(waitTime), finished) == false) {
+                        result = WPEFramework::Core::ERROR_TIMEDOUT;
+                    }
+                }
+            }
+
+            return (result);
+        }
+
+        Metrics GetMetrics() const
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            Metrics metrics;
+            metrics.threads = _threads;
+            metrics.busy = static_cast<uint32_t>(_running.size());
+            metrics.urgentDepth = static_cast<uint32_t>(_urgent.size());
+            metrics.normalDepth = static_cast<uint32_t>(_normal.size());
+            metrics.maxDepth = _maxDepth;
+            metrics.overflows = _overflows;
+            metrics.rejected = _rejected;
+            metrics.dispatched = _dispatched;
+            metrics.averageWait = (_dispatched != 0 ? (_totalWait / _dispatched) : 0);
+            metrics.maxWait = _maxWait;
+            return (metrics);
+        }
+
+    private:
+        // Elastic, the Thunder pool is left with the scheduled jobs only
+        static uint8_t BaseThreads(const uint32_t threads, const uint32_t maxThreads)
+        {
+            const uint32_t minimum = std::min(std::max(threads, 1u), MaxThreads);
+            return (static_cast<uint8_t>(std::min(maxThreads, MaxThreads) > minimum ? 1 : minimum));
+        }
+
+        inline bool IsElastic() const
+        {
+            return (_maxThreads > _minThreads);
+        }
+
+        // Called with _lock taken: counts in a minion, for Spawn() to start
+        bool Reserve()
+        {
+            const bool reserved = (_threads < _maxThreads);
+            if (reserved == true) {
+                ++_threads;
+                ++_starting;
+            }
+            return (reserved);
+        }
+
+        // Called without _lock: starts a reserved minion, or hands the reservation back
+        void Spawn()
+        {
+            pthread_attr_t attributes;
+            pthread_attr_init(&attributes);
+            pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+            if (_stackSize != 0) {
+                pthread_attr_setstacksize(&attributes, std::max(static_cast<size_t>(_stackSize), static_cast<size_t>(PTHREAD_STACK_MIN)));
+            }
+            pthread_t minion;
+            const bool spawned = (pthread_create(&minion, &attributes, &WorkerPoolImplementation::Start, this) == 0);
+            pthread_attr_destroy(&attributes);
+
+            if (spawned == false) {
+                std::unique_lock<std::mutex> lock(_lock);
+                --_threads;
+                --_starting;
+                // One already running has to take the job, Stop may be waiting for the count
+                _wakeup.notify_one();
+                _done.notify_all();
+            }
+        }
+        static void* Start(void* pool)
+        {
+            static_cast<WorkerPoolImplementation*>(pool)->Minion();
+            return (nullptr);
+        }
+
+        // Called with _lock taken
+        bool IsMinion() const
+        {
+            std::list<Running>::const_iterator index = _running.begin();
+            while ((index != _running.end()) && (index->minion != std::this_thread::get_id())) {
+                ++index;
+            }
+            return (index != _running.end());
+        }
+
+        std::list<Running>::const_iterator Find(const WPEFramework::Core::IDispatch* job) const
+        {
+            std::list<Running>::const_iterator index = _running.begin();
+            while ((index != _running.end()) && (index->job != job)) {
+                ++index;
+            }
+            return (index);
+        }
+
+        void Minion()
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            --_starting;
+
+            while (true) {
+                if ((_urgent.empty() == false) || (_normal.empty() == false)) {
+                    Lane& lane = (_urgent.empty() == false ? _urgent : _normal);
+                    Queued queued = std::move(lane.front());
+                    lane.pop_front();
+
+                    const uint64_t wait = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - queued.submitted).count();
+                    _totalWait += wait;
+                    _maxWait = std::max(_maxWait, wait);
+                    ++_dispatched;
+
+                    std::list<Running>::iterator running = _running.insert(_running.end(), { queued.job.operator->(), std::this_thread::get_id() });
+                    lock.unlock();
+
+                    queued.job->Dispatch();
+                    queued.job.Release();
+
+                    lock.lock();
+                    _running.erase(running);
+                    _done.notify_all();
+                } else if (_active == false) {
+                    break;
+                } else {
+                    ++_idle;
+                    const bool timedOut = (_wakeup.wait_for(lock, std::chrono::milliseconds(_idleTime)) == std::cv_status::timeout);
+                    --_idle;
+                    if ((timedOut == true) && (_urgent.empty() == true) && (_normal.empty() == true) && (_threads > _minThreads)) {
+                        break;
+                    }
+                }
+            }
+
+            --_threads;
+            _done.notify_all();
         }
 
     private:
@@ -67,6 +368,27 @@ namespace FireboltSDK {
         };
 
         Dispatcher _dispatcher;
+        const uint32_t _minThreads;
+        const uint32_t _maxThreads;
+        const uint32_t _idleTime;
+        const uint32_t _stackSize;
+        const uint32_t _queueSize;
+        mutable std::mutex _lock;
+        std::condition_variable _wakeup;
+        std::condition_variable _done;
+        Lane _urgent;
+        Lane _normal;
+        std::list<Running> _running;
+        bool _active;
+        uint32_t _threads;
+        uint32_t _starting; // reserved, not yet waiting for work
+        uint32_t _idle;
+        uint32_t _maxDepth;
+        uint64_t _overflows;
+        uint64_t _rejected;
+        uint64_t _dispatched;
+        uint64_t _totalWait;
+        uint64_t _maxWait;
     };
 
     class Worker : public WPEFramework::Core::IDispatch {
@@ -24,7 +24,7 @@ namespace FireboltSDK {
     Async::Async()
         : _methodMap()
         , _adminLock()
-        , _transport(nullptr)
+        , _transport()
     {
         ASSERT(_singleton == nullptr);
         _singleton = this;
@@ -33,7 +33,7 @@ namespace FireboltSDK {
     Async::~Async() /* override */
     {
         Clear();
-        _transport = nullptr;
+        _transport.Store(nullptr);
         _singleton = nullptr;
     }
 
@@ -53,9 +53,9 @@ namespace FireboltSDK {
         }
     }
 
-    void Async::Configure(Transport<WPEFramework::Core::JSON::IElement>* transport)
+    void Async::Configure(const std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>>& transport)
     {
-        _transport = transport;
+        _transport.Store(transport);
     }
 
     void Async::Clear()
@@ -64,10 +64,8 @@ namespace FireboltSDK {
         MethodMap::iterator index = _methodMap.begin();
         while (index != _methodMap.end()) {
             CallbackMap::iterator callbackIndex = index->second.begin();
+            // Outstanding requests went down with the transport, their completions find nothing here
             while (callbackIndex != index->second.end()) {
-                if (IsValidJob(callbackIndex->second)) {
-                    WPEFramework::Core::IWorkerPool::Instance().Revoke(callbackIndex->second.job);
-                }
                 callbackIndex = index->second.erase(callbackIndex);
             }
             index = _methodMap.erase(index);
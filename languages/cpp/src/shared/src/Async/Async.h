@@ -19,6 +19,9 @@
 #pragma once
 
 #include "Module.h"
+#include "Accessor/Published.h"
+
+#include <memory>
 
 namespace FireboltSDK {
 
@@ -30,46 +33,11 @@ namespace FireboltSDK {
         Async(const Async&) = delete;
         Async& operator= (const Async&) = delete;
 
-    public:
-        typedef std::function<Firebolt::Error(Async& parent, void*)> DispatchFunction;
-
-        class Job : public WPEFramework::Core::IDispatch {
-        protected:
-            Job(Async& parent, const string& method, const DispatchFunction lambda, void* usercb)
-                : _parent(parent)
-                , _method(method)
-                , _lambda(lambda)
-                , _usercb(usercb)
-            {
-            }
-
-       public:
-            Job() = delete;
-            Job(const Job&) = delete;
-            Job& operator=(const Job&) = delete;
-
-            ~Job() = default;
-
-        public:
-            static WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> Create(Async& parent, const string& method, const DispatchFunction lambda, void* usercb);
-
-            void Dispatch() override
-            {
-                _lambda(_parent, _usercb);
-            }
-
-        private:
-            Async& _parent;
-            string _method;
-            DispatchFunction _lambda;
-            void* _usercb;
-        };
-
    public:
         struct CallbackData {
-            const DispatchFunction lambda;
-            WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> job;
             uint32_t id;
+            // The one the call went out on, which a reconnect may have replaced since
+            std::weak_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport;
         };
 
         using CallbackMap = std::map<void*, CallbackData>;
@@ -82,38 +50,19 @@ namespace FireboltSDK {
     public:
         static Async& Instance();
         static void Dispose();
-        void Configure(Transport<WPEFramework::Core::JSON::IElement>* transport);
+        void Configure(const std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>>& transport);
 
     public:
         template <typename RESPONSE, typename PARAMETERS, typename CALLBACK>
         Firebolt::Error Invoke(const string& method, const PARAMETERS& parameters, const CALLBACK& callback, void* usercb, uint32_t waitTime = DefaultWaitTime)
         {
-            Firebolt::Error status = Firebolt::Error::None;
-            if (_transport != nullptr) {
-                Transport<WPEFramework::Core::JSON::IElement>* transport = _transport;
+            Firebolt::Error status = Firebolt::Error::General;
+            std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = _transport.Load();
+            if (transport != nullptr) {
                 std::function<void(void* usercb, void* response, Firebolt::Error status)> actualCallback = callback;
-                DispatchFunction lambda = [actualCallback, transport, method, parameters, waitTime](Async& parent, void* usercb) -> Firebolt::Error {
-                    RESPONSE response;
-                    uint32_t id = DefaultId;
-                    Firebolt::Error status = transport->InvokeAsync(method, parameters, id);
-                    if (status == Firebolt::Error::None && parent.IsActive(method, usercb) == true) {
-                        parent.UpdateEntry(method, usercb, id);
-                        status = transport->WaitForResponse(id, response, waitTime);
-                        if (status == Firebolt::Error::None && parent.IsActive(method, usercb) == true) {
-                            WPEFramework::Core::ProxyType<RESPONSE>* jsonResponse = new WPEFramework::Core::ProxyType<RESPONSE>();
-                            *jsonResponse = WPEFramework::Core::ProxyType<RESPONSE>::Create();
-                            (*jsonResponse)->FromString(response);
-                            actualCallback(usercb, jsonResponse, status);
-                            parent.RemoveEntry(method, usercb);
-                        }
-
-                    }
-                    return (status);
-                };
 
                 _adminLock.Lock();
-                WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> job = WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>(WPEFramework::Core::ProxyType<Async::Job>::Create(*this, method, lambda, usercb));
-                CallbackData callbackData = {lambda, job, DefaultId};
+                CallbackData callbackData = {DefaultId, transport};
                 MethodMap::iterator index = _methodMap.find(method);
                 if (index != _methodMap.end()) {
                     CallbackMap::iterator callbackIndex = index->second.find(usercb);
@@ -128,7 +77,23 @@ namespace FireboltSDK {
                 }
                 _adminLock.Unlock();
 
-                WPEFramework::Core::IWorkerPool::Instance().Submit(job);
+                // No thread waits for the response, the transport completes the call when it arrives
+                uint32_t id = DefaultId;
+                status = transport->InvokeAsync(method, parameters, [this, actualCallback, method, usercb](const Firebolt::Error result, const WPEFramework::Core::JSONRPC::Message& response) {
+                    if (Complete(method, usercb) == true) {
+                        WPEFramework::Core::ProxyType<RESPONSE> jsonResponse = WPEFramework::Core::ProxyType<RESPONSE>::Create();
+                        if (result == Firebolt::Error::None) {
+                            jsonResponse->FromString(ResultOf(response));
+                        }
+                        actualCallback(usercb, static_cast<void*>(&jsonResponse), result);
+                    }
+                }, waitTime, id);
+
+                if (status == Firebolt::Error::None) {
+                    UpdateEntry(method, usercb, id, transport);
+                } else {
+                    Complete(method, usercb);
+                }
             }
 
             return status;
@@ -140,7 +105,7 @@ namespace FireboltSDK {
             return (Firebolt::Error::None);
         }
 
-        void UpdateEntry(const string& method, void* usercb, uint32_t id)
+        void UpdateEntry(const string& method, void* usercb, uint32_t id, const std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>>& transport)
         {
             _adminLock.Lock();
             MethodMap::iterator index = _methodMap.find(method);
@@ -148,6 +113,7 @@ namespace FireboltSDK {
                 CallbackMap::iterator callbackIndex = index->second.find(usercb);
                 if (callbackIndex != index->second.end()) {
                     callbackIndex->second.id = id;
+                    callbackIndex->second.transport = transport;
                 }
             }
             _adminLock.Unlock();
@@ -155,14 +121,15 @@ namespace FireboltSDK {
 
         void RemoveEntry(const string& method, void* usercb)
         {
+            uint32_t id = DefaultId;
+            std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport;
             _adminLock.Lock();
             MethodMap::iterator index = _methodMap.find(method);
             if (index != _methodMap.end()) {
                 CallbackMap::iterator callbackIndex = index->second.find(usercb);
                 if (callbackIndex != index->second.end()) {
-                    if (IsValidJob(callbackIndex->second)) {
-                        WPEFramework::Core::IWorkerPool::Instance().Revoke(callbackIndex->second.job);
-                    }
+                    id = callbackIndex->second.id;
+                    transport = callbackIndex->second.transport.lock();
                     index->second.erase(callbackIndex);
                     if (index->second.size() == 0) {
                         _methodMap.erase(index);
@@ -170,6 +137,11 @@ namespace FireboltSDK {
                 }
             }
             _adminLock.Unlock();
+
+            // Its completion finds the entry gone and does not reach the callback anymore
+            if ((id != DefaultId) && (transport != nullptr)) {
+                transport->Abort(id);
+            }
         }
 
         bool IsActive(const string& method, void* usercb)
@@ -188,15 +160,32 @@ namespace FireboltSDK {
         }
 
     private:
-        void Clear();
-        inline bool IsValidJob(CallbackData& callbackData) {
-            return (callbackData.job.IsValid() && (callbackData.id == DefaultId));
+        // Takes the call out of the book keeping, false if it was aborted meanwhile
+        bool Complete(const string& method, void* usercb)
+        {
+            bool active = false;
+            _adminLock.Lock();
+            MethodMap::iterator index = _methodMap.find(method);
+            if (index != _methodMap.end()) {
+                CallbackMap::iterator callbackIndex = index->second.find(usercb);
+                if (callbackIndex != index->second.end()) {
+                    index->second.erase(callbackIndex);
+                    if (index->second.size() == 0) {
+                        _methodMap.erase(index);
+                    }
+                    active = true;
+                }
+            }
+            _adminLock.Unlock();
+            return active;
         }
 
+        void Clear();
+
     private:
         MethodMap _methodMap;
         WPEFramework::Core::CriticalSection _adminLock;
-        Transport<WPEFramework::Core::JSON::IElement>* _transport;
+        Published<Transport<WPEFramework::Core::JSON::IElement>> _transport;
 
         static Async* _singleton;
     };
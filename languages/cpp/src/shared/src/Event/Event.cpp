@@ -22,10 +22,8 @@
 namespace FireboltSDK {
     Event* Event::_singleton = nullptr;
     Event::Event()
-        : _internalEventMap()
-        , _externalEventMap()
-        , _adminLock()
-        , _transport(nullptr)
+        : _shards()
+        , _transport()
     {
         ASSERT(_singleton == nullptr);
         _singleton = this;
@@ -33,8 +31,10 @@ namespace FireboltSDK {
 
     Event::~Event() /* override */
     {
-        _transport->SetEventHandler(nullptr);
-        _transport = nullptr;
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = _transport.Exchange(nullptr);
+        if (transport != nullptr) {
+            transport->SetEventHandler(nullptr);
+        }
 
         _singleton = nullptr;
     }
@@ -55,24 +55,153 @@ namespace FireboltSDK {
         }
     }
 
-    void Event::Configure(Transport<WPEFramework::Core::JSON::IElement>* transport)
+    // nullptr lets go of the transport in use, until the next one is configured
+    void Event::Configure(const std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>>& transport)
     {
-        _transport = transport;
-        _transport->SetEventHandler(this);
+        if (transport != nullptr) {
+            transport->SetEventHandler(this);
+        }
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> previous = _transport.Exchange(transport);
+        if ((previous != nullptr) && (previous != transport)) {
+            Forget();
+        }
     }
 
-    Firebolt::Error Event::Unsubscribe(const string& eventName, void* usercb)
+    /* The listeners stay registered across a reconnect, the server's side of it is gone.
+       Every (event, parameters) pair gets a fresh acknowledgement, so listeners joining
+       meanwhile wait for the request Resubscribe() sends instead of relying on the old one.
+    */
+    void Event::Forget()
     {
-        Firebolt::Error status = Revoke(eventName, usercb);
+        for (Shard& shard : _shards) {
+            shard.adminLock.Lock();
+            for (std::pair<const string, Registration>& event : shard.events) {
+                for (std::pair<const string, Listening>& listening : event.second.listening) {
+                    if (listening.second.pending == nullptr) {
+                        listening.second.pending = std::make_shared<std::promise<Firebolt::Error>>();
+                        listening.second.acknowledged = listening.second.pending->get_future().share();
+                    }
+                }
+            }
+            shard.adminLock.Unlock();
+        }
+    }
 
-        if (status == Firebolt::Error::None) {
-            if (_transport != nullptr) {
+    void Event::Resubscribe()
+    {
+        struct Request {
+            string eventName;
+            string parameters;
+            string request;
+            std::shared_ptr<std::promise<Firebolt::Error>> acknowledgement;
+            uint32_t id;
+            Firebolt::Error status;
+        };
+        std::vector<Request> requests;
 
-                const string parameters("{\"listen\":false}");
-                status = _transport->Unsubscribe(eventName, parameters);
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = _transport.Load();
+        if ((transport != nullptr) && (transport->IsOpen() == true)) {
+            for (Shard& shard : _shards) {
+                shard.adminLock.Lock();
+                for (std::pair<const string, Registration>& event : shard.events) {
+                    for (std::pair<const string, Listening>& listening : event.second.listening) {
+                        if (listening.second.pending != nullptr) {
+                            requests.push_back({ event.first, listening.first, listening.second.request, std::move(listening.second.pending), 0, Firebolt::Error::General });
+                        }
+                    }
+                }
+                shard.adminLock.Unlock();
+            }
+
+            // All requests back to back, then the acknowledgements against one deadline, as in Attach
+            for (Request& request : requests) {
+                request.status = transport->SubscribeAsync(request.eventName, request.request, request.id);
+            }
+            const uint64_t deadline = transport->Deadline();
+            for (Request& request : requests) {
+                if (request.status == Firebolt::Error::None) {
+                    Response response;
+                    request.status = transport->WaitForSubscription(request.id, request.eventName, response, Transport<WPEFramework::Core::JSON::IElement>::Remaining(deadline));
+                }
+                if (request.status != Firebolt::Error::None) {
+                    FIREBOLT_LOG_ERROR(Logger::Category::OpenRPC, Logger::Module<Event>(), "Listening to %s again failed, error %d", request.eventName.c_str(), static_cast<int>(request.status));
+                }
+                request.acknowledgement->set_value(request.status);
+            }
+        }
+    }
+
+    Firebolt::Error Event::SubscribeMany(std::vector<Subscription>& subscriptions)
+    {
+        return (subscriptions.empty() == false ? Attach(subscriptions.data(), static_cast<uint32_t>(subscriptions.size())) : Firebolt::Error::None);
+    }
+
+    /* Registers all listeners and sends the requests of those that are the first for their
+       parameters, then collects the outcome of each against one deadline: either its own
+       acknowledgement, or the one it shares with an earlier listener.
+    */
+    Firebolt::Error Event::Attach(Subscription subscriptions[], const uint32_t count)
+    {
+        Firebolt::Error result = Firebolt::Error::None;
+        std::vector<Acknowledgement> acknowledgements(count);
+        std::vector<uint32_t> ids(count, 0);
+        // The requests must be waited for on the transport they went out on
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = _transport.Load();
+
+        for (uint32_t index = 0; index < count; ++index) {
+            Subscription& subscription = subscriptions[index];
+            Acknowledgement& acknowledgement = acknowledgements[index];
+            subscription.status = Firebolt::Error::General;
+            if (transport != nullptr) {
+                subscription.status = Assign(subscription, acknowledgement);
+                if ((subscription.status == Firebolt::Error::None) && (acknowledgement.request != nullptr)) {
+                    subscription.status = transport->SubscribeAsync(subscription.eventName, subscription.request, ids[index]);
+                    if (subscription.status != Firebolt::Error::None) {
+                        acknowledgement.request->set_value(subscription.status);
+                        Revoke(subscription.eventName, subscription.usercb);
+                    }
+                }
+            }
+        }
+
+        const uint64_t deadline = (transport != nullptr ? transport->Deadline() : 0);
+        for (uint32_t index = 0; index < count; ++index) {
+            Subscription& subscription = subscriptions[index];
+            Acknowledgement& acknowledgement = acknowledgements[index];
+            if (subscription.status == Firebolt::Error::None) {
+                const uint32_t remaining = Transport<WPEFramework::Core::JSON::IElement>::Remaining(deadline);
+                if (acknowledgement.request != nullptr) {
+                    Response response;
+                    subscription.status = transport->WaitForSubscription(ids[index], subscription.eventName, response, remaining);
+                    acknowledgement.request->set_value(subscription.status);
+                } else if (acknowledgement.result.wait_for(std::chrono::milliseconds(remaining)) == std::future_status::ready) {
+                    subscription.status = acknowledgement.result.get();
+                } else {
+                    subscription.status = Firebolt::Error::Timedout;
+                }
+                if (subscription.status != Firebolt::Error::None) {
+                    Revoke(subscription.eventName, subscription.usercb);
+                }
+            }
+            if ((subscription.status != Firebolt::Error::None) && (result == Firebolt::Error::None)) {
+                result = subscription.status;
+            }
+        }
+
+        return result;
+    }
+
+    Firebolt::Error Event::Unsubscribe(const string& eventName, void* usercb)
+    {
+        string unsubscribe;
+        string subscription;
+        Firebolt::Error status = Revoke(eventName, usercb, unsubscribe, subscription);
+
+        if ((status == Firebolt::Error::None) && (unsubscribe.empty() == false)) {
+            std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = _transport.Load();
+            if (transport != nullptr) {
+                status = transport->Unsubscribe(eventName, unsubscribe, subscription);
             }
-        } else {
-            status = Firebolt::Error::None;
         }
         return status;
     }
@@ -81,7 +210,7 @@ namespace FireboltSDK {
     {
         Firebolt::Error result = Firebolt::Error::General;
         Response response;
-        _transport->FromMessage((WPEFramework::Core::JSON::IElement*)&response, *jsonResponse);
+        response.FromString(ResultOf(*jsonResponse));
         if (response.Listening.IsSet() == true) {
             result = Firebolt::Error::None;
             enabled = response.Listening.Value();
@@ -90,108 +219,148 @@ namespace FireboltSDK {
     }
     
     
-    /* This function combines both internal and external event maps, and iterates over them to find the specified event.
-       If the event is found, it iterates over its associated callbacks, updating their states and executing them if applicable.
-       Callbacks in the REVOKED state are removed. 
+    /* Looks up the event in its shard and takes a reference to its callback lists, the
+       prioritized (internal) ones first. The callbacks then run without any lock held;
+       one revoked in the meantime is skipped through its active flag.
     */
     Firebolt::Error Event::Dispatch(const string& eventName, const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message>& jsonResponse) /* override */
     {
-        string response = jsonResponse->Result.Value();
-        std::vector<EventMap*> eventMaps = {&_internalEventMap, &_externalEventMap};
-
-        // Combine both _internalEventMap and _externalEventMap into a single loop
-        for (auto eventMap : eventMaps) {        
-            _adminLock.Lock();
-            EventMap::iterator eventIndex = eventMap->find(eventName);
-            if (eventIndex != eventMap->end()) {
-                CallbackMap& callbacks = eventIndex->second;
-                for (CallbackMap::iterator callbackIndex = callbacks.begin(); callbackIndex != callbacks.end();) {
-                    State state;
-                    if (callbackIndex->second.state != State::REVOKED) {
-                        callbackIndex->second.state = State::EXECUTING;
-                    }
-                    state = callbackIndex->second.state;
-                    _adminLock.Unlock();
-                    if (state == State::EXECUTING) {
-                        callbackIndex->second.lambda(callbackIndex->first, callbackIndex->second.userdata, response);
-                    }
-                    _adminLock.Lock();
-                    if (callbackIndex->second.state == State::REVOKED) {
-                        callbackIndex = callbacks.erase(callbackIndex);
-                        if (callbacks.empty()) {
-                            eventMap->erase(eventIndex); // Erase from the correct eventMap
-                            break; // No need to continue iterating if map is empty
-                        }
-                    } else {
-                        callbackIndex->second.state = State::IDLE;
-                        ++callbackIndex;
+        Payload payload(*jsonResponse);
+        Snapshot snapshots[2];
+
+        Shard& shard = ShardOf(eventName);
+        shard.adminLock.Lock();
+        EventMap::const_iterator eventIndex = shard.events.find(eventName);
+        if (eventIndex != shard.events.end()) {
+            snapshots[0] = eventIndex->second.internal;
+            snapshots[1] = eventIndex->second.external;
+        }
+        shard.adminLock.Unlock();
+
+        for (const Snapshot& callbacks : snapshots) {
+            if (callbacks != nullptr) {
+                for (const std::shared_ptr<Callback>& callback : *callbacks) {
+                    if (callback->active.load(std::memory_order_acquire) == true) {
+                        Tracer::Span span(Tracer::Phase::Callback, jsonResponse->Id.Value(), eventName);
+                        callback->lambda(callback->usercb, callback->userdata, payload);
                     }
                 }
             }
-            _adminLock.Unlock();
         }
         return Firebolt::Error::None;
     }
 
+    Firebolt::Error Event::Assign(const Subscription& subscription, Acknowledgement& acknowledgement)
+    {
+        Firebolt::Error status = Firebolt::Error::General;
+
+        Shard& shard = ShardOf(subscription.eventName);
+        shard.adminLock.Lock();
+        Registration& registration = shard.events[subscription.eventName];
+        Snapshot& callbacks = (subscription.prioritize ? registration.internal : registration.external);
+        if ((Find(registration.internal, subscription.usercb) == nullptr) && (Find(registration.external, subscription.usercb) == nullptr)) {
+            std::shared_ptr<CallbackList> updated = (callbacks != nullptr ? std::make_shared<CallbackList>(*callbacks) : std::make_shared<CallbackList>());
+            updated->push_back(std::make_shared<Callback>(subscription.usercb, subscription.dispatch, subscription.userdata, subscription.parameters));
+            callbacks = updated;
+
+            Listening& listening = registration.listening[subscription.parameters];
+            if (listening.count++ == 0) {
+                acknowledgement.request = std::make_shared<std::promise<Firebolt::Error>>();
+                listening.acknowledged = acknowledgement.request->get_future().share();
+                listening.request = subscription.request;
+            }
+            acknowledgement.result = listening.acknowledged;
+            status = Firebolt::Error::None;
+        }
+        shard.adminLock.Unlock();
+
+        return status;
+    }
+
+    /* static */ bool Event::Remove(Snapshot& callbacks, const void* usercb, bool& emptied)
+    {
+        bool removed = false;
+
+        if (callbacks != nullptr) {
+            std::shared_ptr<CallbackList> updated = std::make_shared<CallbackList>();
+            updated->reserve(callbacks->size());
+            for (const std::shared_ptr<Callback>& callback : *callbacks) {
+                if (callback->usercb == usercb) {
+                    callback->active.store(false, std::memory_order_release);
+                    removed = true;
+                } else {
+                    updated->push_back(callback);
+                }
+            }
+            if (removed == true) {
+                emptied = updated->empty();
+                callbacks = (emptied == true ? Snapshot() : Snapshot(updated));
+            }
+        }
+
+        return (removed);
+    }
 
     Firebolt::Error Event::Revoke(const string& eventName, void* usercb)
     {
-        Firebolt::Error status = Firebolt::Error::None;
-
-        // Combine both _internalEventMap and _externalEventMap into a single loop
-        std::vector<EventMap*> eventMaps = {&_internalEventMap, &_externalEventMap};
-
-        for (auto eventMap : eventMaps) { 
-            _adminLock.Lock(); // Lock inside the loop
-
-            // Find the eventIndex for eventName in the current eventMap
-            EventMap::iterator eventIndex = eventMap->find(eventName);
-            if (eventIndex != eventMap->end()) {
-                // Find the callbackIndex for usercb in the current CallbackMap
-                CallbackMap::iterator callbackIndex = eventIndex->second.find(usercb);
-                if (callbackIndex != eventIndex->second.end()) {
-                    // Check if callback is not executing, then erase it
-                    if (callbackIndex->second.state != State::EXECUTING) {
-                        eventIndex->second.erase(callbackIndex);
-                    } else {
-                        // Mark the callback as revoked
-                        callbackIndex->second.state = State::REVOKED;
-                    }
+        string unsubscribe;
+        string subscription;
+        return (Revoke(eventName, usercb, unsubscribe, subscription));
+    }
+
+    Firebolt::Error Event::Revoke(const string& eventName, void* usercb, string& unsubscribe, string& subscription)
+    {
+        Firebolt::Error status = Firebolt::Error::NotSubscribed;
 
-                    // Check if the CallbackMap is empty after potential erasure
-                    if (eventIndex->second.empty()) {
-                        eventMap->erase(eventIndex);
-                    } else {
-                        // Set status to General error if CallbackMap is not empty
-                        status = Firebolt::Error::General;
+        Shard& shard = ShardOf(eventName);
+        shard.adminLock.Lock();
+        EventMap::iterator eventIndex = shard.events.find(eventName);
+        if (eventIndex != shard.events.end()) {
+            Registration& registration = eventIndex->second;
+            for (Snapshot* callbacks : { &registration.internal, &registration.external }) {
+                const Callback* callback = Find(*callbacks, usercb);
+                if (callback != nullptr) {
+                    ListeningMap::iterator listening = registration.listening.find(callback->parameters);
+                    ASSERT(listening != registration.listening.end());
+                    if ((listening != registration.listening.end()) && (--(listening->second.count) == 0)) {
+                        // The last one with these parameters, the server can stop sending them
+                        JsonObject request;
+                        request.FromString(listening->first);
+                        WPEFramework::Core::JSON::Variant Listen = false;
+                        request.Set(_T("listen"), Listen);
+                        request.ToString(unsubscribe);
+                        subscription = listening->second.request;
+                        registration.listening.erase(listening);
                     }
+                    bool emptied = false;
+                    Remove(*callbacks, usercb, emptied);
+                    status = Firebolt::Error::None;
                 }
             }
-
-            _adminLock.Unlock(); // Unlock after processing each eventMap
+            if ((registration.internal == nullptr) && (registration.external == nullptr)) {
+                shard.events.erase(eventIndex);
+            }
         }
+        shard.adminLock.Unlock();
 
         return status;
     }
 
     void Event::Clear()
     {
-        // Clear both _internalEventMap and _externalEventMap
-        std::vector<EventMap*> eventMaps = {&_internalEventMap, &_externalEventMap};
-
-        for (auto eventMap : eventMaps) { 
-            _adminLock.Lock(); // Lock before clearing
-
-            EventMap::iterator eventIndex = eventMap->begin();
-            while (eventIndex != eventMap->end()) {
-                CallbackMap::iterator callbackIndex = eventIndex->second.begin();
-                while (callbackIndex != eventIndex->second.end()) {
-                    callbackIndex = eventIndex->second.erase(callbackIndex);
+        for (Shard& shard : _shards) {
+            shard.adminLock.Lock();
+            for (std::pair<const string, Registration>& event : shard.events) {
+                for (const Snapshot& callbacks : { event.second.internal, event.second.external }) {
+                    if (callbacks != nullptr) {
+                        for (const std::shared_ptr<Callback>& callback : *callbacks) {
+                            callback->active.store(false, std::memory_order_release);
+                        }
+                    }
                 }
-                eventIndex = eventMap->erase(eventIndex);
             }
-
-            _adminLock.Unlock(); // Unlock after clearing
+            shard.events.clear();
+            shard.adminLock.Unlock();
         }
     }
 
@@ -19,6 +19,15 @@
 #pragma once
 
 #include "Module.h"
+#include "Accessor/Published.h"
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace FireboltSDK {
 
@@ -26,21 +35,143 @@ namespace FireboltSDK {
 
     class Event : public IEventHandler {
     public:
-        typedef std::function<Firebolt::Error(void*, const void*, const string& parameters)> DispatchFunction;
-    private:
-        enum State : uint8_t {
-            IDLE,
-            EXECUTING,
-            REVOKED
+        // One notification as its listeners see it: the raw result, parsed at most once per
+        // result type and then shared by every listener asking for that type. Listeners
+        // must treat what they get as read only.
+        class Payload {
+        private:
+            // The listeners of an event nearly always share the one type of its result: the
+            // first few types are kept in place, only more than that go to the heap
+            static constexpr uint8_t InlineTypes = 4;
+            using Proxy = WPEFramework::Core::ProxyType<WPEFramework::Core::JSON::IElement>;
+            struct Parsed {
+                const void* type;
+                void (*destroy)(void* proxy);
+                typename std::aligned_storage<sizeof(Proxy), alignof(Proxy)>::type proxy;
+            };
+            using Overflow = std::vector<std::pair<const void*, std::shared_ptr<void>>>;
+
+        public:
+            Payload() = delete;
+            Payload(const Payload&) = delete;
+            Payload& operator=(const Payload&) = delete;
+
+            // Refers to the message, which outlives the dispatch, rather than copying its text
+            explicit Payload(const WPEFramework::Core::JSONRPC::Message& message)
+                : _message(message)
+                , _count(0)
+                , _overflow()
+            {
+            }
+            ~Payload()
+            {
+                for (uint8_t index = 0; index < _count; ++index) {
+                    _parsed[index].destroy(&_parsed[index].proxy);
+                }
+            }
+
+        public:
+            template <typename PARAMETERS>
+            const WPEFramework::Core::ProxyType<PARAMETERS>& Get()
+            {
+                using Typed = WPEFramework::Core::ProxyType<PARAMETERS>;
+                static_assert((sizeof(Typed) <= sizeof(Proxy)) && (alignof(Typed) <= alignof(Proxy)), "A ProxyType does not depend on what it points at");
+
+                // The pool is unique per type, so its address tells the types apart
+                const void* type = &Pool<PARAMETERS>();
+                for (uint8_t index = 0; index < _count; ++index) {
+                    if (_parsed[index].type == type) {
+                        return (*reinterpret_cast<const Typed*>(&_parsed[index].proxy));
+                    }
+                }
+                for (const Overflow::value_type& entry : _overflow) {
+                    if (entry.first == type) {
+                        return (*static_cast<const Typed*>(entry.second.get()));
+                    }
+                }
+
+                Typed* parsed = nullptr;
+                if (_count < InlineTypes) {
+                    Parsed& slot = _parsed[_count];
+                    parsed = new (&slot.proxy) Typed(Pool<PARAMETERS>().Element());
+                    slot.type = type;
+                    slot.destroy = [](void* proxy) { static_cast<Typed*>(proxy)->~Typed(); };
+                    ++_count;
+                } else {
+                    std::shared_ptr<Typed> kept = std::make_shared<Typed>(Pool<PARAMETERS>().Element());
+                    parsed = kept.get();
+                    _overflow.emplace_back(type, kept);
+                }
+                (*parsed)->Clear();
+                // Straight from ResultOf: a listener may make calls of its own on this thread,
+                // which reuse its buffer, so the text is not kept from one Get to the next
+                (*parsed)->FromString(ResultOf(_message));
+                return (*parsed);
+            }
+
+        private:
+            const WPEFramework::Core::JSONRPC::Message& _message;
+            Parsed _parsed[InlineTypes];
+            uint8_t _count;
+            Overflow _overflow;
         };
 
-        struct CallbackData {
+        typedef std::function<Firebolt::Error(void*, const void*, Payload& payload)> DispatchFunction;
+    private:
+        struct Callback {
+            Callback(void* usercb, const DispatchFunction& lambda, const void* userdata, const string& parameters)
+                : usercb(usercb)
+                , lambda(lambda)
+                , userdata(userdata)
+                , parameters(parameters)
+                , active(true)
+            {
+            }
+
+            void* const usercb;
             const DispatchFunction lambda;
             const void* userdata;
-            State state;
+            const string parameters;
+            std::atomic<bool> active;
+        };
+        // Callback lists are never modified in place: an update publishes a new copy, so
+        // Dispatch can walk the list it picked up without holding any lock.
+        using CallbackList = std::vector<std::shared_ptr<Callback>>;
+        using Snapshot = std::shared_ptr<const CallbackList>;
+
+        // The server is told once per distinct set of subscription parameters; the
+        // listeners that join later only wait for (or reuse) that acknowledgement.
+        // A new connection knows none of them: pending is then the acknowledgement
+        // Resubscribe() is to fulfil for it.
+        struct Listening {
+            uint32_t count;
+            std::shared_future<Firebolt::Error> acknowledged;
+            string request;
+            std::shared_ptr<std::promise<Firebolt::Error>> pending;
+        };
+        using ListeningMap = std::unordered_map<string, Listening>;
+
+        struct Registration {
+            Snapshot internal; // prioritized, dispatched first
+            Snapshot external;
+            ListeningMap listening; // by subscription parameters
+        };
+
+        // Handed out by Assign: the first listener of its parameters gets the request to
+        // fulfil, all of them get the result to wait for.
+        struct Acknowledgement {
+            std::shared_ptr<std::promise<Firebolt::Error>> request;
+            std::shared_future<Firebolt::Error> result;
+        };
+        using EventMap = std::unordered_map<string, Registration>;
+
+        // The registry is striped over a few independently locked shards, so subscribers
+        // and dispatchers of unrelated events do not contend.
+        static constexpr uint8_t Shards = 8;
+        struct Shard {
+            EventMap events;
+            WPEFramework::Core::CriticalSection adminLock;
         };
-        using CallbackMap = std::map<void*, CallbackData>;
-        using EventMap = std::map<string, CallbackMap>;
 
         class Response : public WPEFramework::Core::JSON::Container {
         public:
@@ -69,7 +200,10 @@ namespace FireboltSDK {
         ~Event() override;
         static Event& Instance();
         static void Dispose();
-        void Configure(Transport<WPEFramework::Core::JSON::IElement>* transport);
+        void Configure(const std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>>& transport);
+        // Starts listening again, on the current connection, for every event and set of
+        // parameters that still has listeners since the transport was replaced
+        void Resubscribe();
 
     public:
         template <typename RESULT, typename CALLBACK>
@@ -79,33 +213,23 @@ namespace FireboltSDK {
             return Subscribe<RESULT, CALLBACK>(eventName, jsonParameters, callback, usercb, userdata);
         }
 
+        // Only the first listener for an event and set of parameters goes to the server,
+        // the others are added locally.
         template <typename RESULT, typename CALLBACK>
         Firebolt::Error Subscribe(const string& eventName, JsonObject& jsonParameters, const CALLBACK& callback, void* usercb, const void* userdata, bool prioritize = false)
         {
             Firebolt::Error status = Firebolt::Error::General;
 
-            if (_transport != nullptr) {
-                EventMap& eventMap = prioritize ? _internalEventMap : _externalEventMap;
-                
-                status = Assign<RESULT, CALLBACK>(eventMap, eventName, callback, usercb, userdata);
-
-                if (status == Firebolt::Error::None) {
-                    Response response;
-                    WPEFramework::Core::JSON::Variant Listen = true;
-                    jsonParameters.Set(_T("listen"), Listen);
-                    string parameters;
-                    jsonParameters.ToString(parameters);
+            if (_transport.IsSet() == true) {
+                Subscription subscription = { eventName, string(), string(), Dispatcher<RESULT>(callback), usercb, userdata, prioritize, Firebolt::Error::General };
+                jsonParameters.ToString(subscription.parameters);
+                WPEFramework::Core::JSON::Variant Listen = true;
+                jsonParameters.Set(_T("listen"), Listen);
+                jsonParameters.ToString(subscription.request);
 
-                    status = _transport->Subscribe<Response>(eventName, parameters, response, prioritize);
-
-                    if (status != Firebolt::Error::None) {
-                        Revoke(eventName, usercb);
-                    } else if (response.Listening.IsSet() && response.Listening.Value()) {
-                        status = Firebolt::Error::None;
-                    }
-                }
+                status = Attach(&subscription, 1);
             }
-        return status;
+            return status;
         }
 
         // To prioritize internal and external events and its corresponding callbacks
@@ -119,57 +243,100 @@ namespace FireboltSDK {
         }
 
 
+        // One listener of a SubscribeMany
+        struct Subscription {
+            string eventName;
+            string parameters; // without "listen", tells subscriptions to the same event apart
+            string request; // the parameters as sent to start listening
+            DispatchFunction dispatch;
+            void* usercb;
+            const void* userdata;
+            bool prioritize;
+            Firebolt::Error status;
+        };
+
+        template <typename RESULT, typename CALLBACK>
+        static Subscription Listener(const string& eventName, const JsonObject& jsonParameters, const CALLBACK& callback, void* usercb, const void* userdata, bool prioritize = false)
+        {
+            Subscription subscription = { eventName, string(), string(), Dispatcher<RESULT>(callback), usercb, userdata, prioritize, Firebolt::Error::General };
+            jsonParameters.ToString(subscription.parameters);
+            // Copying a JsonObject drops the members that were Add()ed by reference, go through the text instead
+            JsonObject request;
+            request.FromString(subscription.parameters);
+            WPEFramework::Core::JSON::Variant Listen = true;
+            request.Set(_T("listen"), Listen);
+            request.ToString(subscription.request);
+            return subscription;
+        }
+
+        // Sends all subscriptions back to back and then collects the acknowledgements against
+        // one deadline. Returns the first failure, each subscription carries its own status.
+        Firebolt::Error SubscribeMany(std::vector<Subscription>& subscriptions);
+
+        // The server is only told once the last listener with the same parameters is gone.
+        // NotSubscribed if usercb does not listen to eventName.
         Firebolt::Error Unsubscribe(const string& eventName, void* usercb);
 
     private:
         template <typename PARAMETERS, typename CALLBACK>
-        Firebolt::Error Assign(EventMap& eventMap, const string& eventName, const CALLBACK& callback, void* usercb, const void* userdata)
+        static DispatchFunction Dispatcher(const CALLBACK& callback)
         {
-            
-            Firebolt::Error status = Firebolt::Error::General;
             std::function<void(void* usercb, const void* userdata, void* parameters)> actualCallback = callback;
-            DispatchFunction implementation = [actualCallback](void* usercb, const void* userdata, const string& parameters) -> Firebolt::Error {
-                WPEFramework::Core::ProxyType<PARAMETERS>* inbound = new WPEFramework::Core::ProxyType<PARAMETERS>();
-                *inbound = WPEFramework::Core::ProxyType<PARAMETERS>::Create();
-                (*inbound)->FromString(parameters);
-                actualCallback(usercb, userdata, static_cast<void*>(inbound));
+            return [actualCallback](void* usercb, const void* userdata, Payload& payload) -> Firebolt::Error {
+                // Each callback gets its own reference to the shared, pooled object, which
+                // goes back to the pool once all of them and the payload let go of it. Not the
+                // payload's own: the generated callbacks Release() the proxy they are handed,
+                // which would take it away from the listeners after them. The copy is a
+                // reference count, nothing is allocated for it.
+                WPEFramework::Core::ProxyType<PARAMETERS> inbound = payload.Get<PARAMETERS>();
+                actualCallback(usercb, userdata, static_cast<void*>(&inbound));
                 return (Firebolt::Error::None);
             };
-            CallbackData callbackData = {implementation, userdata, State::IDLE};
-            _adminLock.Lock();
-            EventMap::iterator eventIndex = eventMap.find(eventName);
-            if (eventIndex != eventMap.end()) {
-                CallbackMap::iterator callbackIndex = eventIndex->second.find(usercb);
-               
-                if (callbackIndex == eventIndex->second.end()) {
-                     std::cout << "Registering new callback for event: " << eventName << std::endl;
-                    eventIndex->second.emplace(std::piecewise_construct, std::forward_as_tuple(usercb), std::forward_as_tuple(callbackData));
-                    status = Firebolt::Error::None;
-                }
-            } else {
+        }
+        Firebolt::Error Attach(Subscription subscriptions[], const uint32_t count);
+        Firebolt::Error Assign(const Subscription& subscription, Acknowledgement& acknowledgement);
+        Firebolt::Error Revoke(const string& eventName, void* usercb);
+        // As above, and if it was the last listener with its parameters, sets unsubscribe to
+        // the request that stops them and subscription to the one that started them, by which
+        // the transport's registry knows it
+        Firebolt::Error Revoke(const string& eventName, void* usercb, string& unsubscribe, string& subscription);
 
-                CallbackMap callbackMap;
-                callbackMap.emplace(std::piecewise_construct, std::forward_as_tuple(usercb), std::forward_as_tuple(callbackData));
-                eventMap.emplace(std::piecewise_construct, std::forward_as_tuple(eventName), std::forward_as_tuple(callbackMap));
-                status = Firebolt::Error::None;
+    private:
+        // One pool of deserialized notifications per parameter type
+        template <typename PARAMETERS>
+        static WPEFramework::Core::ProxyPoolType<PARAMETERS>& Pool()
+        {
+            static WPEFramework::Core::ProxyPoolType<PARAMETERS> pool(2);
+            return (pool);
+        }
 
+        inline Shard& ShardOf(const string& eventName)
+        {
+            return (_shards[std::hash<string>()(eventName) % Shards]);
+        }
+        static Callback* Find(const Snapshot& callbacks, const void* usercb)
+        {
+            Callback* result = nullptr;
+            if (callbacks != nullptr) {
+                for (const std::shared_ptr<Callback>& callback : *callbacks) {
+                    if (callback->usercb == usercb) {
+                        result = callback.get();
+                        break;
+                    }
+                }
             }
-
-            _adminLock.Unlock();
-            return status;
+            return (result);
         }
-        Firebolt::Error Revoke(const string& eventName, void* usercb);
+        static bool Remove(Snapshot& callbacks, const void* usercb, bool& emptied);
 
-    private:
         void Clear();
+        void Forget();
         Firebolt::Error ValidateResponse(const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message>& jsonResponse, bool& enabled) override;
         Firebolt::Error Dispatch(const string& eventName, const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message>& jsonResponse) override;
  
     private: 
-        EventMap _internalEventMap;
-        EventMap _externalEventMap;
-        WPEFramework::Core::CriticalSection _adminLock;
-        Transport<WPEFramework::Core::JSON::IElement>* _transport;
+        Shard _shards[Shards];
+        Published<Transport<WPEFramework::Core::JSON::IElement>> _transport;
 
         static Event* _singleton;
     };
@@ -23,5 +23,6 @@
 #include "Accessor/Accessor.h"
 #include "Async/Async.h"
 #include "Logger/Logger.h"
+#include "Tracer/Tracer.h"
 #include "TypesPriv.h"
 #include "types.h"
@@ -20,6 +20,20 @@
 #include "error.h"
 #include "Logger.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Per logging thread, each message takes about 600 bytes
+#ifndef FIREBOLT_LOG_RING_SIZE
+#define FIREBOLT_LOG_RING_SIZE 16
+#endif
+
 namespace WPEFramework {
 
 ENUM_CONVERSION_BEGIN(FireboltSDK::Logger::LogLevel)
@@ -45,44 +59,310 @@ ENUM_CONVERSION_END(FireboltSDK::Logger::Category)
 }
 
 namespace FireboltSDK {
-    /* static */  Logger::LogLevel Logger::_logLevel = Logger::LogLevel::Error;
+
+    /* Every logging thread gets its own ring of records, written only by that thread and
+       read only by the writer thread, so logging takes no lock. A full ring drops the
+       message rather than making the caller wait; the writer reports how many went missing.
+       Once stopped, a thread that published a record too late for the last drain writes
+       out its own ring.
+    */
+    class Logger::Sink {
+    private:
+        static constexpr uint16_t RingSize = FIREBOLT_LOG_RING_SIZE;
+        static_assert((RingSize != 0) && ((RingSize & (RingSize - 1)) == 0), "FIREBOLT_LOG_RING_SIZE must be a power of two");
+        static constexpr uint16_t ModuleSize = 64;
+        static constexpr uint32_t IdleTime = 10; // ms
+
+    public:
+        struct Record {
+            uint64_t time;
+            long thread;
+            const char* file;
+            const char* function;
+            uint16_t line;
+            Category category;
+            char module[ModuleSize];
+            char message[Logger::MaxBufSize];
+        };
+
+        class Ring {
+        public:
+            Ring(const Ring&) = delete;
+            Ring& operator=(const Ring&) = delete;
+
+            Ring()
+                : _head(0)
+                , _tail(0)
+                , _drain()
+            {
+            }
+            ~Ring() = default;
+
+        public:
+            // Producer side, nullptr when full
+            Record* Claim()
+            {
+                const uint32_t head = _head.load(std::memory_order_relaxed);
+                return ((head - _tail.load(std::memory_order_acquire)) < RingSize ? &(_records[head % RingSize]) : nullptr);
+            }
+            void Publish()
+            {
+                _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            }
+
+            // Consumer side, the writer and, once stopped, the producer itself
+            void Drain()
+            {
+                std::lock_guard<std::mutex> lock(_drain);
+                uint32_t tail = _tail.load(std::memory_order_relaxed);
+                const uint32_t head = _head.load(std::memory_order_acquire);
+                while (tail != head) {
+                    Write(_records[tail % RingSize]);
+                    _tail.store(++tail, std::memory_order_release);
+                }
+            }
+
+        private:
+            Record _records[RingSize];
+            std::atomic<uint32_t> _head;
+            std::atomic<uint32_t> _tail;
+            std::mutex _drain;
+        };
+
+    private:
+        Sink()
+            : _lock()
+            , _wakeup()
+            , _rings()
+            , _writer()
+            , _running(false)
+            , _stopped(false)
+            , _dropped(0)
+            , _lost(0)
+        {
+        }
+
+    public:
+        Sink(const Sink&) = delete;
+        Sink& operator=(const Sink&) = delete;
+
+        ~Sink() = default;
+
+        static Sink& Instance()
+        {
+            static Sink *instance = new Sink();
+            ASSERT(instance != nullptr);
+            return *instance;
+        }
+
+    public:
+        // The ring of the calling thread, nullptr once stopped
+        Ring* Current()
+        {
+            static thread_local std::shared_ptr<Ring> ring;
+
+            Ring* result = nullptr;
+            if (_stopped.load(std::memory_order_acquire) == false) {
+                if (ring == nullptr) {
+                    ring = std::make_shared<Ring>();
+                    Register(ring);
+                }
+                result = ring.get();
+            }
+            return (result);
+        }
+        void Dropped()
+        {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            _lost.fetch_add(1, std::memory_order_relaxed);
+        }
+        uint32_t Lost() const
+        {
+            return (_lost.load(std::memory_order_relaxed));
+        }
+        // Publishing and stopping race: one of the two sees the other, see Stop()
+        void Published(Ring& ring)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (_stopped.load(std::memory_order_relaxed) == true) {
+                ring.Drain();
+            }
+        }
+        void Wakeup()
+        {
+            _wakeup.notify_one();
+        }
+        void Stop()
+        {
+            std::thread writer;
+
+            _lock.lock();
+            _stopped.store(true, std::memory_order_release);
+            _running = false;
+            writer = std::move(_writer);
+            _lock.unlock();
+
+            _wakeup.notify_one();
+            if (writer.joinable() == true) {
+                writer.join();
+            }
+            // Whoever published before this fence is drained here, whoever after sees
+            // _stopped and drains its ring itself
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            Drain();
+        }
+
+        static void Write(const Record& record)
+        {
+            char formattedMsg[Logger::MaxBufSize];
+            const string time = WPEFramework::Core::Time(record.time).ToTimeOnly(true);
+            const string categoryName =  WPEFramework::Core::EnumerateType<Logger::Category>(record.category).Data();
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-truncation"
+            if (categoryName.empty() != true) {
+                snprintf(formattedMsg, sizeof(formattedMsg), "--->\033[1;32m[%s]:[%s]:[%s][%s:%d](%s)<PID:%d><TID:%ld> : %s\033[0m\n", time.c_str(), categoryName.c_str(), record.module, WPEFramework::Core::File::FileName(record.file).c_str(), record.line, record.function, TRACE_PROCESS_ID, record.thread, record.message);
+            } else {
+                snprintf(formattedMsg, sizeof(formattedMsg), "--->\033[1;32m[%s]:[%s][%s:%d](%s)<PID:%d><TID:%ld> : %s\033[0m\n", time.c_str(), record.module, WPEFramework::Core::File::FileName(record.file).c_str(), record.line, record.function, TRACE_PROCESS_ID, record.thread, record.message);
+            }
+#pragma GCC diagnostic pop
+            LOG_MESSAGE(formattedMsg);
+        }
+
+    private:
+        static void Exit()
+        {
+            Logger::Flush();
+        }
+
+        void Register(const std::shared_ptr<Ring>& ring)
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _rings.push_back(ring);
+            if ((_running == false) && (_stopped.load(std::memory_order_relaxed) == false)) {
+                _running = true;
+                _writer = std::thread(&Sink::Run, this);
+                // Whatever is still in the rings at exit gets written out
+                std::atexit(Exit);
+            }
+        }
+
+        void Run()
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            while (_running == true) {
+                lock.unlock();
+                Drain();
+                lock.lock();
+                if (_running == true) {
+                    _wakeup.wait_for(lock, std::chrono::milliseconds(IdleTime));
+                }
+            }
+        }
+
+        void Drain()
+        {
+            _lock.lock();
+            std::vector<std::shared_ptr<Ring>> rings(_rings);
+            _lock.unlock();
+
+            for (const std::shared_ptr<Ring>& ring : rings) {
+                ring->Drain();
+            }
+            rings.clear();
+
+            const uint32_t dropped = _dropped.exchange(0, std::memory_order_relaxed);
+            if (dropped != 0) {
+                char message[Logger::MaxBufSize];
+                snprintf(message, sizeof(message), "--->[%s] : %u log messages dropped\n", WPEFramework::Core::Time::Now().ToTimeOnly(true).c_str(), dropped);
+                LOG_MESSAGE(message);
+            }
+
+            // Rings only we still hold belong to threads that are gone, and are empty by now
+            _lock.lock();
+            std::vector<std::shared_ptr<Ring>>::iterator index = _rings.begin();
+            while (index != _rings.end()) {
+                if (index->use_count() == 1) {
+                    index->get()->Drain();
+                    index = _rings.erase(index);
+                } else {
+                    ++index;
+                }
+            }
+            _lock.unlock();
+        }
+
+    private:
+        std::mutex _lock;
+        std::condition_variable _wakeup;
+        std::vector<std::shared_ptr<Ring>> _rings;
+        std::thread _writer;
+        bool _running;
+        std::atomic<bool> _stopped;
+        std::atomic<uint32_t> _dropped; // since last reported
+        std::atomic<uint32_t> _lost; // ever
+    };
+
+    /* static */  std::atomic<Logger::LogLevel> Logger::_logLevel(Logger::LogLevel::Error);
 
     Firebolt::Error Logger::SetLogLevel(Logger::LogLevel logLevel)
     {
         ASSERT(logLevel < Logger::LogLevel::MaxLevel);
         Firebolt::Error status = Firebolt::Error::General;
         if (logLevel < Logger::LogLevel::MaxLevel) {
-            _logLevel = logLevel;
+            _logLevel.store(logLevel, std::memory_order_relaxed);
             status = Firebolt::Error::None;
         }
         return status;
     }
 
-    void Logger::Log(LogLevel logLevel, Category category, const std::string& module, const std::string file, const std::string function, const uint16_t line, const std::string& format, ...)
+    void Logger::Log(LogLevel logLevel, Category category, const std::string& module, const char* file, const char* function, const uint16_t line, const char* format, ...)
     {
-        if (logLevel <= _logLevel) {
-            va_list arg;
-            char msg[Logger::MaxBufSize];
-            va_start(arg, format);
-            int length = vsnprintf(msg, Logger::MaxBufSize, format.c_str(), arg);
-            va_end(arg);
-
-            uint32_t position = (length >= Logger::MaxBufSize) ? (Logger::MaxBufSize - 1) : length;
-            msg[position] = '\0';
+        if (IsEnabled(logLevel) == true) {
+            Sink& sink = Sink::Instance();
+            Sink::Ring* ring = sink.Current();
+            Sink::Record local;
+            Sink::Record* record = (ring != nullptr ? ring->Claim() : &local);
 
-            char formattedMsg[Logger::MaxBufSize];
-            const string time = WPEFramework::Core::Time::Now().ToTimeOnly(true);
-            const string categoryName =  WPEFramework::Core::EnumerateType<Logger::Category>(category).Data();
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wformat-truncation"
-            if (categoryName.empty() != true) {
-                snprintf(formattedMsg, sizeof(formattedMsg), "--->\033[1;32m[%s]:[%s]:[%s][%s:%d](%s)<PID:%d><TID:%ld> : %s\033[0m\n", time.c_str(), categoryName.c_str(), module.c_str(), WPEFramework::Core::File::FileName(file).c_str(), line, function.c_str(), TRACE_PROCESS_ID, TRACE_THREAD_ID, msg);
+            if (record == nullptr) {
+                sink.Dropped();
             } else {
-                snprintf(formattedMsg, sizeof(formattedMsg), "--->\033[1;32m[%s]:[%s][%s:%d](%s)<PID:%d><TID:%ld> : %s\033[0m\n", time.c_str(), module.c_str(), WPEFramework::Core::File::FileName(file).c_str(), line, function.c_str(), TRACE_PROCESS_ID, TRACE_THREAD_ID, msg);
+                va_list arg;
+                va_start(arg, format);
+                int length = vsnprintf(record->message, Logger::MaxBufSize, format, arg);
+                va_end(arg);
+
+                uint32_t position = (length >= Logger::MaxBufSize) ? (Logger::MaxBufSize - 1) : length;
+                record->message[position] = '\0';
+
+                record->time = WPEFramework::Core::Time::Now().Ticks();
+                record->thread = static_cast<long>(TRACE_THREAD_ID);
+                record->file = file;
+                record->function = function;
+                record->line = line;
+                record->category = category;
+                strncpy(record->module, module.c_str(), sizeof(record->module) - 1);
+                record->module[sizeof(record->module) - 1] = '\0';
+
+                if (ring != nullptr) {
+                    ring->Publish();
+                    sink.Published(*ring);
+                    if (logLevel == LogLevel::Error) {
+                        sink.Wakeup();
+                    }
+                } else {
+                    Sink::Write(local);
+                }
             }
-#pragma GCC diagnostic pop
-            LOG_MESSAGE(formattedMsg);
         }
     }
-}
 
+    /* static */ void Logger::Flush()
+    {
+        Sink::Instance().Stop();
+    }
+
+    /* static */ uint32_t Logger::Dropped()
+    {
+        return (Sink::Instance().Lost());
+    }
+}
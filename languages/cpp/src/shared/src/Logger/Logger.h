@@ -20,6 +20,13 @@
 
 #include "types.h"
 
+#include <atomic>
+
+// Lowest level compiled in at all, logging below it costs nothing
+#ifndef FIREBOLT_LOG_FLOOR
+#define FIREBOLT_LOG_FLOOR Debug
+#endif
+
 namespace FireboltSDK {
 
     class Logger {
@@ -34,6 +41,7 @@ namespace FireboltSDK {
             Debug,
             MaxLevel
         };
+        static constexpr LogLevel Floor = LogLevel::FIREBOLT_LOG_FLOOR;
 
         enum class Category : uint8_t {
             OpenRPC,
@@ -52,22 +60,39 @@ namespace FireboltSDK {
 
     public:
         static Firebolt::Error SetLogLevel(LogLevel logLevel);
-        static void Log(LogLevel logLevel, Category category, const std::string& module, const std::string file, const std::string function, const uint16_t line, const std::string& format, ...);
+        static bool IsEnabled(const LogLevel logLevel)
+        {
+            return (logLevel <= _logLevel.load(std::memory_order_relaxed));
+        }
+        // Formats on the calling thread, but leaves the writing to a background thread
+        static void Log(LogLevel logLevel, Category category, const std::string& module, const char* file, const char* function, const uint16_t line, const char* format, ...);
+        // Writes out everything logged so far and from then on logs synchronously
+        static void Flush();
+        // Messages lost so far because the ring of their thread was full
+        static uint32_t Dropped();
 
     public:
         template<typename CLASS>
-        static const string Module()
+        static const string& Module()
         {
-            return WPEFramework::Core::ClassNameOnly(typeid(CLASS).name()).Text(); 
+            static const string name = WPEFramework::Core::ClassNameOnly(typeid(CLASS).name()).Text();
+            return name;
         }
 
     private:
-        static LogLevel _logLevel;
+        class Sink;
+
+        static std::atomic<LogLevel> _logLevel;
     };
 }
 
+// Nothing is evaluated, not even the module name, unless the level is enabled
 #define FIREBOLT_LOG(level, category, module, ...) \
-    FireboltSDK::Logger::Log(level, category, module, __FILE__, __func__, __LINE__, __VA_ARGS__)
+    do { \
+        if (((level) <= FireboltSDK::Logger::Floor) && (FireboltSDK::Logger::IsEnabled(level) == true)) { \
+            FireboltSDK::Logger::Log(level, category, module, __FILE__, __func__, __LINE__, __VA_ARGS__); \
+        } \
+    } while (false)
 
 #define FIREBOLT_LOG_ERROR(category, module, ...) \
     FIREBOLT_LOG(FireboltSDK::Logger::LogLevel::Error, category, module, __VA_ARGS__)
@@ -83,5 +108,5 @@ namespace FireboltSDK {
     syslog(sLOG_NOTIC, "%s", message);
 #else
 #define LOG_MESSAGE(message) \
-    fprintf(stderr, "%s", message); fflush(stdout);
+    fprintf(stderr, "%s", message); fflush(stderr);
 #endif
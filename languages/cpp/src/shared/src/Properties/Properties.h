@@ -20,6 +20,7 @@
 
 #include "Accessor/Accessor.h"
 #include "Event/Event.h"
+#include "PropertyCache.h"
 
 namespace FireboltSDK {
 
@@ -36,21 +37,29 @@ namespace FireboltSDK {
         static Firebolt::Error Get(const string& propertyName, WPEFramework::Core::ProxyType<RESPONSETYPE>& response)
         {
             Firebolt::Error status = Firebolt::Error::General;
-            Transport<WPEFramework::Core::JSON::IElement>* transport = Accessor::Instance().GetTransport();
-            if (transport != nullptr) {
-                JsonObject parameters;
-                RESPONSETYPE responseType;
-                status = transport->Invoke(propertyName, parameters, responseType);
-                if (status == Firebolt::Error::None) {
-                    ASSERT(response.IsValid() == false);
-                    if (response.IsValid() == true) {
-                        response.Release();
-                    }
-                    response = WPEFramework::Core::ProxyType<RESPONSETYPE>::Create();
-                    (*response) = responseType;
+            uint32_t version = PropertyCache::NoVersion;
+            WPEFramework::Core::ProxyType<RESPONSETYPE> cached;
+            if (PropertyCache::Instance().IsEnabled() == true) {
+                cached = WPEFramework::Core::ProxyType<RESPONSETYPE>::Create();
+                if (PropertyCache::Instance().Lookup(propertyName, *cached, version) == false) {
+                    cached.Release();
                 }
+            }
+            if (cached.IsValid() == true) {
+                ASSERT(response.IsValid() == false);
+                response = cached;
+                status = Firebolt::Error::None;
             } else {
-                FIREBOLT_LOG_ERROR(Logger::Category::OpenRPC, Logger::Module<Accessor>(), "Error in getting Transport err = %d", status);
+                std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = Accessor::Instance().GetTransport();
+                if (transport != nullptr) {
+                    JsonObject parameters;
+                    status = Invoke(transport, propertyName, parameters, response);
+                    if (status == Firebolt::Error::None) {
+                        Cache(propertyName, *response, version);
+                    }
+                } else {
+                    FIREBOLT_LOG_ERROR(Logger::Category::OpenRPC, Logger::Module<Accessor>(), "Error in getting Transport err = %d", status);
+                }
             }
 
             return status;
@@ -60,18 +69,9 @@ namespace FireboltSDK {
         static Firebolt::Error Get(const string& propertyName, const PARAMETERS& parameters, WPEFramework::Core::ProxyType<RESPONSETYPE>& response)
         {
             Firebolt::Error status = Firebolt::Error::General;
-            Transport<WPEFramework::Core::JSON::IElement>* transport = Accessor::Instance().GetTransport();
+            std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = Accessor::Instance().GetTransport();
             if (transport != nullptr) {
-                RESPONSETYPE responseType;
-                status = transport->Invoke(propertyName, parameters, responseType);
-                if (status == Firebolt::Error::None) {
-                    ASSERT(response.IsValid() == false);
-                    if (response.IsValid() == true) {
-                        response.Release();
-                    }
-                    response = WPEFramework::Core::ProxyType<RESPONSETYPE>::Create();
-                    (*response) = responseType;
-                }
+                status = Invoke(transport, propertyName, parameters, response);
             } else {
                 FIREBOLT_LOG_ERROR(Logger::Category::OpenRPC, Logger::Module<Accessor>(), "Error in getting Transport err = %d", status);
             }
@@ -83,25 +83,37 @@ namespace FireboltSDK {
         template <typename RESPONSETYPE>
         static Firebolt::Error Get(const string& propertyName, RESPONSETYPE& response)
         {
-            Firebolt::Error status = Firebolt::Error::General;
-            Transport<WPEFramework::Core::JSON::IElement>* transport = Accessor::Instance().GetTransport();
-            if (transport != nullptr) {
-                JsonObject parameters;
-                status = transport->Invoke(propertyName, parameters, response);
-            } else {
-                FIREBOLT_LOG_ERROR(Logger::Category::OpenRPC, Logger::Module<Accessor>(), "Error in getting Transport err = %d", status);
-            }
-
-            return status;
+            return Read(propertyName, response, false);
         }
 
         template <typename PARAMETERS, typename RESPONSETYPE>
         static Firebolt::Error Get(const string& propertyName, const PARAMETERS& parameters, RESPONSETYPE& response)
+        {
+            return Read(propertyName, parameters, response, false);
+        }
+
+        // As Get, but concurrent reads of the same property share one request, see Transport::InvokeCoalesced
+        template <typename RESPONSETYPE>
+        static Firebolt::Error GetCoalesced(const string& propertyName, RESPONSETYPE& response)
+        {
+            return Read(propertyName, response, true);
+        }
+
+        template <typename PARAMETERS, typename RESPONSETYPE>
+        static Firebolt::Error GetCoalesced(const string& propertyName, const PARAMETERS& parameters, RESPONSETYPE& response)
+        {
+            return Read(propertyName, parameters, response, true);
+        }
+
+        using Batch = std::vector<Transport<WPEFramework::Core::JSON::IElement>::BatchRequest>;
+
+        // Read several properties in one pipelined round trip, see Transport::InvokeBatch
+        static Firebolt::Error GetMany(Batch& properties)
         {
             Firebolt::Error status = Firebolt::Error::General;
-            Transport<WPEFramework::Core::JSON::IElement>* transport = Accessor::Instance().GetTransport();
+            std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = Accessor::Instance().GetTransport();
             if (transport != nullptr) {
-                status = transport->Invoke(propertyName, parameters, response);
+                status = transport->InvokeBatch(properties);
             } else {
                 FIREBOLT_LOG_ERROR(Logger::Category::OpenRPC, Logger::Module<Accessor>(), "Error in getting Transport err = %d", status);
             }
@@ -113,9 +125,12 @@ namespace FireboltSDK {
         static Firebolt::Error Set(const string& propertyName, const PARAMETERS& parameters)
         {
             Firebolt::Error status = Firebolt::Error::General;
-            Transport<WPEFramework::Core::JSON::IElement>* transport = Accessor::Instance().GetTransport();
+            std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = Accessor::Instance().GetTransport();
             if (transport != nullptr) {
                 JsonObject responseType;
+                if (PropertyCache::Instance().IsEnabled() == true) {
+                    PropertyCache::Instance().Invalidate(GetterName(propertyName));
+                }
                 status = transport->Invoke(propertyName, parameters, responseType);
             } else {
                 FIREBOLT_LOG_ERROR(Logger::Category::OpenRPC, Logger::Module<Accessor>(), "Error in getting Transport err = %d", status);
@@ -134,7 +149,98 @@ namespace FireboltSDK {
         {
             return Event::Instance().Unsubscribe(EventName(propertyName), usercb);
         }
+        // Serve repeated reads of this property from memory, kept up to date by its change event.
+        // Only reads without parameters are cached.
+        static void EnableCache(const string& propertyName)
+        {
+            PropertyCache::Instance().Enable(propertyName, EventName(propertyName));
+        }
+
+        static void DisableCache(const string& propertyName)
+        {
+            PropertyCache::Instance().Disable(propertyName);
+        }
+
+        static uint32_t CacheHits()
+        {
+            return PropertyCache::Instance().Hits();
+        }
+
+        static uint32_t CacheMisses()
+        {
+            return PropertyCache::Instance().Misses();
+        }
+
     private:
+        // Deserialize the result straight into the caller's proxy instead of copying it over from a temporary
+        template <typename PARAMETERS, typename RESPONSETYPE>
+        static Firebolt::Error Invoke(const std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>>& transport, const string& propertyName, const PARAMETERS& parameters, WPEFramework::Core::ProxyType<RESPONSETYPE>& response)
+        {
+            ASSERT(response.IsValid() == false);
+            if (response.IsValid() == true) {
+                response.Release();
+            }
+            response = WPEFramework::Core::ProxyType<RESPONSETYPE>::Create();
+            Firebolt::Error status = transport->Invoke(propertyName, parameters, *response);
+            if (status != Firebolt::Error::None) {
+                response.Release();
+            }
+            return status;
+        }
+
+        template <typename RESPONSETYPE>
+        static Firebolt::Error Read(const string& propertyName, RESPONSETYPE& response, const bool coalesce)
+        {
+            Firebolt::Error status = Firebolt::Error::General;
+            uint32_t version = PropertyCache::NoVersion;
+            if (PropertyCache::Instance().Lookup(propertyName, response, version) == true) {
+                status = Firebolt::Error::None;
+            } else {
+                std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = Accessor::Instance().GetTransport();
+                if (transport != nullptr) {
+                    JsonObject parameters;
+                    status = (coalesce == true ? transport->InvokeCoalesced(propertyName, parameters, response) : transport->Invoke(propertyName, parameters, response));
+                    if (status == Firebolt::Error::None) {
+                        Cache(propertyName, response, version);
+                    }
+                } else {
+                    FIREBOLT_LOG_ERROR(Logger::Category::OpenRPC, Logger::Module<Accessor>(), "Error in getting Transport err = %d", status);
+                }
+            }
+
+            return status;
+        }
+
+        template <typename PARAMETERS, typename RESPONSETYPE>
+        static Firebolt::Error Read(const string& propertyName, const PARAMETERS& parameters, RESPONSETYPE& response, const bool coalesce)
+        {
+            Firebolt::Error status = Firebolt::Error::General;
+            std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = Accessor::Instance().GetTransport();
+            if (transport != nullptr) {
+                status = (coalesce == true ? transport->InvokeCoalesced(propertyName, parameters, response) : transport->Invoke(propertyName, parameters, response));
+            } else {
+                FIREBOLT_LOG_ERROR(Logger::Category::OpenRPC, Logger::Module<Accessor>(), "Error in getting Transport err = %d", status);
+            }
+
+            return status;
+        }
+
+        template <typename RESPONSETYPE>
+        static void Cache(const string& propertyName, const RESPONSETYPE& response, const uint32_t version)
+        {
+            PropertyCache::Instance().Store(propertyName, response, version);
+        }
+
+        static inline string GetterName(const string& setterName) {
+            // module.setFoo -> module.foo
+            size_t pos = setterName.find_first_of('.');
+            string getterName = setterName;
+            if ((pos != std::string::npos) && (setterName.compare(pos + 1, 3, "set") == 0) && (setterName.length() > (pos + 4))) {
+                getterName = setterName.substr(0, pos + 1) + static_cast<char>(std::tolower(setterName[pos + 4])) + setterName.substr(pos + 5);
+            }
+            return getterName;
+        }
+
         static inline string EventName(const string& propertyName) {
             size_t pos = propertyName.find_first_of('.');
             string eventName = propertyName;
@@ -0,0 +1,281 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Transport/Transport.h"
+#include "Event/Event.h"
+#include "Logger/Logger.h"
+#include "PropertyCache.h"
+
+namespace FireboltSDK {
+
+    static inline void NextVersion(uint32_t& version)
+    {
+        if (++version == PropertyCache::NoVersion) {
+            ++version;
+        }
+    }
+
+    PropertyCache::PropertyCache()
+        : _entries()
+        , _adminLock()
+        , _filter()
+        , _enabled(0)
+        , _hits(0)
+        , _misses(0)
+    {
+        for (std::atomic<uint64_t>& bits : _filter) {
+            bits.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /* static */ PropertyCache& PropertyCache::Instance()
+    {
+        static PropertyCache *instance = new PropertyCache();
+        ASSERT(instance != nullptr);
+        return *instance;
+    }
+
+    void PropertyCache::Enable(const string& propertyName, const string& eventName)
+    {
+        bool enabled = true;
+
+        _adminLock.Lock();
+        EntryMap::iterator index = _entries.find(propertyName);
+        if (index == _entries.end()) {
+            Entry entry = { eventName, string(), 1, Watch::NONE, true, false, false, nullptr, nullptr };
+            _entries.emplace(propertyName, std::move(entry));
+        } else {
+            enabled = !index->second.enabled;
+            index->second.enabled = true;
+        }
+        if (enabled == true) {
+            // The name in the filter before the count lets readers see it
+            const size_t bit = (std::hash<string>()(propertyName) & (FilterBits - 1));
+            _filter[bit / 64].fetch_or(static_cast<uint64_t>(1) << (bit % 64), std::memory_order_release);
+            _enabled.fetch_add(1, std::memory_order_release);
+        }
+        _adminLock.Unlock();
+    }
+
+    void PropertyCache::Disable(const string& propertyName)
+    {
+        bool registered = false;
+        string eventName;
+
+        _adminLock.Lock();
+        EntryMap::iterator index = _entries.find(propertyName);
+        if (index != _entries.end()) {
+            Entry& entry = index->second;
+            registered = entry.registered;
+            eventName = entry.eventName;
+            if (entry.enabled == true) {
+                _enabled.fetch_sub(1, std::memory_order_release);
+            }
+            entry.enabled = false;
+            entry.valid = false;
+            entry.registered = false;
+            entry.watch = Watch::NONE;
+            entry.value.clear();
+            entry.kind = nullptr;
+            entry.parsed.reset();
+            NextVersion(entry.version);
+        }
+        _adminLock.Unlock();
+
+        if (registered == true) {
+            Event::Instance().Unsubscribe(eventName, static_cast<void*>(this));
+        }
+    }
+
+    bool PropertyCache::Lookup(const string& propertyName, const void* kind, string& value, std::shared_ptr<const void>& parsed, uint32_t& version)
+    {
+        bool hit = false;
+        bool subscribe = false;
+        bool registered = false;
+        const string* name = nullptr;
+        string eventName;
+
+        version = NoVersion;
+
+        if (MayBeEnabled(propertyName) == true) {
+            _adminLock.Lock();
+            EntryMap::iterator index = _entries.find(propertyName);
+            if ((index != _entries.end()) && (index->second.enabled == true)) {
+                Entry& entry = index->second;
+                if (entry.valid == true) {
+                    if ((kind != nullptr) && (entry.kind == kind)) {
+                        parsed = entry.parsed;
+                    } else {
+                        value = entry.value;
+                    }
+                    version = entry.version;
+                    hit = true;
+                    _hits.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    _misses.fetch_add(1, std::memory_order_relaxed);
+                    if (entry.watch == Watch::ACTIVE) {
+                        version = entry.version;
+                    } else if (entry.watch == Watch::NONE) {
+                        // This caller sets up the subscription, concurrent misses just go to the wire
+                        entry.watch = Watch::PENDING;
+                        subscribe = true;
+                        registered = entry.registered;
+                        name = &(index->first);
+                        eventName = entry.eventName;
+                    }
+                }
+            }
+            _adminLock.Unlock();
+
+            if (subscribe == true) {
+                version = Subscribe(*name, eventName, registered);
+            }
+        }
+
+        return (hit);
+    }
+
+    void PropertyCache::Store(const string& propertyName, const string& value, const void* kind, const std::shared_ptr<const void>& parsed, const uint32_t version)
+    {
+        // A version is only handed out for a cached property
+        if (version != NoVersion) {
+            _adminLock.Lock();
+            EntryMap::iterator index = _entries.find(propertyName);
+            if (index != _entries.end()) {
+                Entry& entry = index->second;
+                if ((entry.enabled == true) && (entry.watch == Watch::ACTIVE) && (entry.version == version) && (entry.valid == false)) {
+                    entry.value = value;
+                    entry.kind = kind;
+                    entry.parsed = parsed;
+                    entry.valid = true;
+                }
+            }
+            _adminLock.Unlock();
+        }
+    }
+
+    void PropertyCache::Keep(const string& propertyName, const void* kind, const std::shared_ptr<const void>& parsed, const uint32_t version)
+    {
+        _adminLock.Lock();
+        EntryMap::iterator index = _entries.find(propertyName);
+        if (index != _entries.end()) {
+            Entry& entry = index->second;
+            if ((entry.valid == true) && (entry.version == version)) {
+                entry.kind = kind;
+                entry.parsed = parsed;
+            }
+        }
+        _adminLock.Unlock();
+    }
+
+    void PropertyCache::Invalidate(const string& propertyName)
+    {
+        if (MayBeEnabled(propertyName) == true) {
+            _adminLock.Lock();
+            EntryMap::iterator index = _entries.find(propertyName);
+            if (index != _entries.end()) {
+                index->second.valid = false;
+                NextVersion(index->second.version);
+            }
+            _adminLock.Unlock();
+        }
+    }
+
+    void PropertyCache::InvalidateAll()
+    {
+        _adminLock.Lock();
+        for (std::pair<const string, Entry>& index : _entries) {
+            index.second.valid = false;
+            index.second.watch = Watch::NONE;
+            NextVersion(index.second.version);
+        }
+        _adminLock.Unlock();
+    }
+
+    void PropertyCache::Detach()
+    {
+        _adminLock.Lock();
+        for (std::pair<const string, Entry>& index : _entries) {
+            index.second.valid = false;
+            index.second.registered = false;
+            index.second.watch = Watch::NONE;
+            NextVersion(index.second.version);
+        }
+        _adminLock.Unlock();
+    }
+
+    uint32_t PropertyCache::Subscribe(const string& propertyName, const string& eventName, const bool registered)
+    {
+        uint32_t version = NoVersion;
+
+        if (registered == true) {
+            // Left over from before a reconnect, the server side of it is gone
+            Event::Instance().Unsubscribe(eventName, static_cast<void*>(this));
+        }
+
+        Firebolt::Error status = Event::Instance().Subscribe<JsonValue>(eventName, Changed, static_cast<void*>(this), static_cast<const void*>(&propertyName));
+
+        _adminLock.Lock();
+        EntryMap::iterator index = _entries.find(propertyName);
+        ASSERT(index != _entries.end());
+        Entry& entry = index->second;
+        entry.registered = (status == Firebolt::Error::None);
+        if ((entry.watch == Watch::PENDING) && (status == Firebolt::Error::None)) {
+            entry.watch = Watch::ACTIVE;
+            version = entry.version;
+        } else if (entry.watch == Watch::PENDING) {
+            entry.watch = Watch::NONE;
+        }
+        _adminLock.Unlock();
+
+        if (status != Firebolt::Error::None) {
+            FIREBOLT_LOG_WARNING(Logger::Category::OpenRPC, Logger::Module<PropertyCache>(), "Not caching %s, subscribing to %s failed: %d", propertyName.c_str(), eventName.c_str(), status);
+        }
+
+        return (version);
+    }
+
+    void PropertyCache::Update(const string& propertyName, const string& value)
+    {
+        _adminLock.Lock();
+        EntryMap::iterator index = _entries.find(propertyName);
+        if ((index != _entries.end()) && (index->second.enabled == true)) {
+            Entry& entry = index->second;
+            entry.value = value;
+            entry.kind = nullptr;
+            entry.parsed.reset();
+            entry.valid = (entry.watch == Watch::ACTIVE);
+            NextVersion(entry.version);
+        }
+        _adminLock.Unlock();
+    }
+
+    /* static */ void PropertyCache::Changed(void* usercb, const void* userdata, void* parameters)
+    {
+        WPEFramework::Core::ProxyType<JsonValue>& proxyResponse = *(reinterpret_cast<WPEFramework::Core::ProxyType<JsonValue>*>(parameters));
+        ASSERT(proxyResponse.IsValid() == true);
+
+        if (proxyResponse.IsValid() == true) {
+            string value;
+            proxyResponse->ToString(value);
+            proxyResponse.Release();
+
+            reinterpret_cast<PropertyCache*>(usercb)->Update(*(reinterpret_cast<const string*>(userdata)), value);
+        }
+    }
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "Module.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace FireboltSDK {
+
+    /* Opt-in cache of property values, kept as their raw JSON text and as the object the
+       text was last parsed into, so a hit of that type is a copy rather than a parse.
+       A property is filled on the first Get and, from then on, kept current by its
+       on<Name>Changed event; until that subscription is acknowledged nothing is cached.
+       A value fetched while the property changed underneath it is dropped, which is
+       what the version is for.
+       Reads of properties that are not cached do not take the lock: they are told apart
+       by a count of the enabled ones and a filter on the hashes of their names.
+    */
+    class PropertyCache {
+    public:
+        static constexpr uint32_t NoVersion = 0;
+
+    private:
+        static constexpr uint16_t FilterBits = 1024;
+
+        enum class Watch : uint8_t {
+            NONE,
+            PENDING,
+            ACTIVE
+        };
+
+        struct Entry {
+            string eventName;
+            string value;
+            uint32_t version;
+            Watch watch;
+            bool enabled;
+            bool valid;
+            bool registered;
+            const void* kind; // Kind<VALUE>() of parsed
+            std::shared_ptr<const void> parsed;
+        };
+        // Entries are never erased, so references to their names stay valid for the event callbacks
+        using EntryMap = std::unordered_map<string, Entry>;
+
+    private:
+        PropertyCache();
+
+    public:
+        PropertyCache(const PropertyCache&) = delete;
+        PropertyCache& operator=(const PropertyCache&) = delete;
+
+        ~PropertyCache() = default;
+        static PropertyCache& Instance();
+
+    public:
+        // Any property cached at all
+        bool IsEnabled() const
+        {
+            return (_enabled.load(std::memory_order_acquire) != 0);
+        }
+
+        void Enable(const string& propertyName, const string& eventName);
+        void Disable(const string& propertyName);
+
+        // Returns true on a hit. On a miss, version is set to what Store expects, or
+        // NoVersion if the fetched value may not be cached.
+        bool Lookup(const string& propertyName, string& value, uint32_t& version)
+        {
+            std::shared_ptr<const void> parsed;
+            return (Lookup(propertyName, nullptr, value, parsed, version));
+        }
+        void Store(const string& propertyName, const string& value, const uint32_t version)
+        {
+            Store(propertyName, value, nullptr, nullptr, version);
+        }
+
+        // The same for a value of type VALUE. The first hit of a type parses the text, the
+        // ones after it assign from that object.
+        template <typename VALUE>
+        bool Lookup(const string& propertyName, VALUE& value, uint32_t& version)
+        {
+            string text;
+            std::shared_ptr<const void> parsed;
+            const bool hit = Lookup(propertyName, Kind<VALUE>(), text, parsed, version);
+            if (hit == true) {
+                if (parsed != nullptr) {
+                    value = *static_cast<const VALUE*>(parsed.get());
+                } else {
+                    value.FromString(text);
+                    Keep(propertyName, Kind<VALUE>(), Copy(value), version);
+                }
+            }
+            return (hit);
+        }
+        template <typename VALUE>
+        void Store(const string& propertyName, const VALUE& value, const uint32_t version)
+        {
+            if (version != NoVersion) {
+                string text;
+                value.ToString(text);
+                Store(propertyName, text, Kind<VALUE>(), Copy(value), version);
+            }
+        }
+
+        void Invalidate(const string& propertyName);
+        // The connection changed: values and subscriptions can no longer be trusted
+        void InvalidateAll();
+        // The event handler is gone, and with it all our registrations
+        void Detach();
+
+        uint32_t Hits() const
+        {
+            return (_hits.load(std::memory_order_relaxed));
+        }
+        uint32_t Misses() const
+        {
+            return (_misses.load(std::memory_order_relaxed));
+        }
+
+    private:
+        // False only if propertyName is certainly not cached. Bits are never cleared, a
+        // disabled name just takes the slow path.
+        bool MayBeEnabled(const string& propertyName) const
+        {
+            bool result = false;
+            if (IsEnabled() == true) {
+                const size_t bit = (std::hash<string>()(propertyName) & (FilterBits - 1));
+                result = ((_filter[bit / 64].load(std::memory_order_acquire) & (static_cast<uint64_t>(1) << (bit % 64))) != 0);
+            }
+            return (result);
+        }
+
+        // A static per type, its address tells the types apart
+        template <typename VALUE>
+        static const void* Kind()
+        {
+            static const uint8_t kind = 0;
+            return (&kind);
+        }
+        // Assigned into a default constructed one, which has its members registered
+        template <typename VALUE>
+        static std::shared_ptr<const void> Copy(const VALUE& value)
+        {
+            std::shared_ptr<VALUE> result = std::make_shared<VALUE>();
+            *result = value;
+            return (result);
+        }
+
+        // A hit hands out the parsed object if it is of kind, the text otherwise, and the
+        // version of the value for Keep
+        bool Lookup(const string& propertyName, const void* kind, string& value, std::shared_ptr<const void>& parsed, uint32_t& version);
+        void Store(const string& propertyName, const string& value, const void* kind, const std::shared_ptr<const void>& parsed, const uint32_t version);
+        // Holds on to what the text of version was parsed into, unless the value changed since
+        void Keep(const string& propertyName, const void* kind, const std::shared_ptr<const void>& parsed, const uint32_t version);
+
+        uint32_t Subscribe(const string& propertyName, const string& eventName, const bool registered);
+        void Update(const string& propertyName, const string& value);
+
+        static void Changed(void* usercb, const void* userdata, void* parameters);
+
+    private:
+        EntryMap _entries;
+        WPEFramework::Core::CriticalSection _adminLock;
+        std::atomic<uint64_t> _filter[FilterBits / 64];
+        std::atomic<uint32_t> _enabled;
+        std::atomic<uint32_t> _hits;
+        std::atomic<uint32_t> _misses;
+    };
+}
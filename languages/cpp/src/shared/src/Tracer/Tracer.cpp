@@ -0,0 +1,204 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Module.h"
+#include "Tracer.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace FireboltSDK {
+
+    /* Spans of one thread. Only that thread writes, Dump reads whatever was published;
+       a span being overwritten while dumping may come out garbled, nothing worse.
+       Once its thread ends a buffer keeps its spans, until a new thread takes it over:
+       there are never more buffers than threads tracing at the same time.
+    */
+    class Tracer::Buffer {
+    private:
+        static constexpr uint16_t Capacity = 2048;
+        static constexpr uint8_t NameSize = 43;
+
+        // One cache line each
+        struct Span {
+            uint64_t begin;
+            uint64_t end;
+            uint32_t id;
+            Phase phase;
+            char name[NameSize];
+        };
+
+        using Buffers = std::vector<std::shared_ptr<Buffer>>;
+
+        // Hands the buffer of a thread back when that thread ends
+        class Owner {
+        public:
+            Owner(const Owner&) = delete;
+            Owner& operator=(const Owner&) = delete;
+
+            Owner()
+                : _buffer(nullptr)
+            {
+            }
+            ~Owner()
+            {
+                if (_buffer != nullptr) {
+                    Release(_buffer);
+                }
+            }
+
+        public:
+            Buffer& Get()
+            {
+                if (_buffer == nullptr) {
+                    _buffer = Acquire(static_cast<long>(TRACE_THREAD_ID));
+                }
+                return (*_buffer);
+            }
+
+        private:
+            Buffer* _buffer;
+        };
+
+    public:
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+
+        Buffer(const long thread)
+            : _thread(thread)
+            , _next(0)
+        {
+        }
+        ~Buffer() = default;
+
+    public:
+        static Buffer& Current()
+        {
+            static thread_local Owner owner;
+            return (owner.Get());
+        }
+        static Buffers All()
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            return (_buffers);
+        }
+
+        void Add(const Phase phase, const uint32_t id, const char* name, const uint64_t begin, const uint64_t end)
+        {
+            const uint32_t next = _next.load(std::memory_order_relaxed);
+            Span& span = _spans[next % Capacity];
+            span.begin = begin;
+            span.end = end;
+            span.id = id;
+            span.phase = phase;
+            const size_t length = (name != nullptr ? strnlen(name, NameSize - 1) : 0);
+            if (length != 0) {
+                memcpy(span.name, name, length);
+            }
+            span.name[length] = '\0';
+            _next.store(next + 1, std::memory_order_release);
+        }
+
+        // Returns the number of spans written
+        uint32_t Write(FILE* file, const uint32_t written) const
+        {
+            static const char* const PhaseNames[] = { "serialize", "send", "write", "wait", "queue", "deserialize", "callback" };
+
+            const uint32_t next = _next.load(std::memory_order_acquire);
+            const uint32_t first = (next > Capacity ? next - Capacity : 0);
+            for (uint32_t index = first; index < next; ++index) {
+                const Span& span = _spans[index % Capacity];
+                fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"firebolt\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%ld,\"args\":{\"id\":%u,\"method\":\"%s\"}}",
+                    ((written + (index - first)) == 0 ? "" : ","),
+                    PhaseNames[static_cast<uint8_t>(span.phase)], span.begin / 1000.0, (span.end - span.begin) / 1000.0,
+                    static_cast<int>(TRACE_PROCESS_ID), _thread.load(std::memory_order_relaxed), span.id, span.name);
+            }
+            return (next - first);
+        }
+
+    private:
+        // Owned by the list of all buffers, so its spans can still be dumped after its thread ended
+        static Buffer* Acquire(const long thread)
+        {
+            Buffer* buffer = nullptr;
+
+            std::lock_guard<std::mutex> lock(_lock);
+            if (_released.empty() == false) {
+                // The spans of the thread that had it make room for those of this one
+                buffer = _released.back();
+                _released.pop_back();
+                buffer->_thread.store(thread, std::memory_order_relaxed);
+                buffer->_next.store(0, std::memory_order_release);
+            } else {
+                std::shared_ptr<Buffer> created = std::make_shared<Buffer>(thread);
+                _buffers.push_back(created);
+                buffer = created.get();
+            }
+            return (buffer);
+        }
+        static void Release(Buffer* buffer)
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _released.push_back(buffer);
+        }
+
+    private:
+        std::atomic<long> _thread;
+        std::atomic<uint32_t> _next;
+        Span _spans[Capacity];
+
+        static std::mutex _lock;
+        static Buffers _buffers;
+        static std::vector<Buffer*> _released;
+    };
+
+    /* static */ std::mutex Tracer::Buffer::_lock;
+    /* static */ Tracer::Buffer::Buffers Tracer::Buffer::_buffers;
+    /* static */ std::vector<Tracer::Buffer*> Tracer::Buffer::_released;
+
+    /* static */ std::atomic<bool> Tracer::_enabled(false);
+    /* static */ std::atomic<uint64_t> Tracer::_submitted[Tracer::Stamps];
+
+    /* static */ void Tracer::Record(const Phase phase, const uint32_t id, const char* name, const uint64_t begin)
+    {
+        Buffer::Current().Add(phase, id, name, begin, Now());
+    }
+
+    /* static */ Firebolt::Error Tracer::Dump(const std::string& fileName)
+    {
+        Firebolt::Error status = Firebolt::Error::General;
+
+        FILE* file = fopen(fileName.c_str(), "w");
+        if (file != nullptr) {
+            uint32_t written = 0;
+            fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+            for (const std::shared_ptr<Buffer>& buffer : Buffer::All()) {
+                written += buffer->Write(file, written);
+            }
+            fprintf(file, "\n]}\n");
+            if (fclose(file) == 0) {
+                status = Firebolt::Error::None;
+            }
+        }
+
+        return (status);
+    }
+}
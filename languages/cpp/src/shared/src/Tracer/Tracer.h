@@ -0,0 +1,136 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "error.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace FireboltSDK {
+
+    /* Opt-in tracing of the phases a call goes through, tagged with its JSON-RPC id and
+       method. Each thread records into its own preallocated buffer, overwriting its oldest
+       spans once full; recording is a clock read and one store. Dump writes everything
+       recorded so far as a Chrome trace (chrome://tracing, ui.perfetto.dev).
+       While disabled, a span costs a single relaxed load.
+    */
+    class Tracer {
+    public:
+        enum class Phase : uint8_t {
+            Serialize,   // parameters to JSON, in the generated method
+            Send,        // building the request and handing it to the channel
+            Write,       // from the hand over until the request was written to the socket
+            Wait,        // a caller blocked on its response
+            Queue,       // a received message waiting for a worker thread
+            Deserialize, // response JSON into the result
+            Callback     // user code: event listeners and async completions
+        };
+
+        // Times a phase on the current thread, from construction until End() or destruction
+        class Span {
+        public:
+            Span(const Span&) = delete;
+            Span& operator=(const Span&) = delete;
+
+            Span(const Phase phase, const uint32_t id, const char* name)
+                : _begin(IsEnabled() == true ? Now() : 0)
+                , _id(id)
+                , _name(name)
+                , _phase(phase)
+            {
+            }
+            Span(const Phase phase, const uint32_t id, const std::string& name)
+                : Span(phase, id, name.c_str())
+            {
+            }
+            ~Span()
+            {
+                End();
+            }
+
+        public:
+            void End()
+            {
+                if (_begin != 0) {
+                    Record(_phase, _id, _name, _begin);
+                    _begin = 0;
+                }
+            }
+
+        private:
+            uint64_t _begin;
+            const uint32_t _id;
+            const char* _name;
+            const Phase _phase;
+        };
+
+    public:
+        Tracer() = delete;
+        Tracer(const Tracer&) = delete;
+        Tracer& operator=(const Tracer&) = delete;
+
+    public:
+        // Monotonic, in ns
+        static uint64_t Now()
+        {
+            return (static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()));
+        }
+        static bool IsEnabled()
+        {
+            return (_enabled.load(std::memory_order_relaxed));
+        }
+        static void Enable(const bool enabled)
+        {
+            _enabled.store(enabled, std::memory_order_relaxed);
+        }
+
+        // A span from begin until now, on the current thread
+        static void Record(const Phase phase, const uint32_t id, const char* name, const uint64_t begin);
+
+        // A request went to the channel, Written() closes its Write span from the thread that put it on the socket
+        static void Submitted(const uint32_t id)
+        {
+            if (IsEnabled() == true) {
+                _submitted[id % Stamps].store(Now(), std::memory_order_relaxed);
+            }
+        }
+        static void Written(const uint32_t id)
+        {
+            if (IsEnabled() == true) {
+                const uint64_t begin = _submitted[id % Stamps].exchange(0, std::memory_order_relaxed);
+                if (begin != 0) {
+                    Record(Phase::Write, id, nullptr, begin);
+                }
+            }
+        }
+
+        // Chrome trace event format, JSON
+        static Firebolt::Error Dump(const std::string& fileName);
+
+    private:
+        class Buffer;
+
+        static constexpr uint16_t Stamps = 1024;
+
+        static std::atomic<bool> _enabled;
+        static std::atomic<uint64_t> _submitted[Stamps];
+    };
+}
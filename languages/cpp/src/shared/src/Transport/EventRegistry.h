@@ -0,0 +1,94 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string>
+
+#include "PendingTable.h"
+
+namespace FireboltSDK {
+
+    /* The subscriptions running on one connection, by the id of the request that started them:
+       the only record of which notifications belong to which event. The transport looks up
+       every notification in it, the event handler refers to a subscription by its request when
+       it stops it. Both go through a PendingTable, so looking up a notification takes no lock;
+       only adding and removing a subscription writes to it.
+       Sized for a few dozen subscriptions at once, more than that spill over into its map.
+    */
+    template <uint16_t CAPACITY = 64>
+    class EventRegistry {
+    private:
+        struct Subscribed {
+            Subscribed(const std::string& eventName, const std::string& request)
+                : eventName(eventName)
+                , request(request)
+            {
+            }
+
+            const std::string eventName;
+            const std::string request; // with "listen":true, as sent
+        };
+
+    public:
+        EventRegistry(const EventRegistry&) = delete;
+        EventRegistry& operator=(const EventRegistry&) = delete;
+
+        EventRegistry() = default;
+        ~EventRegistry() = default;
+
+    public:
+        // Known before the request goes out, so a notification racing its acknowledgement is
+        // not lost
+        bool Add(const uint32_t id, const std::string& eventName, const std::string& request)
+        {
+            return (_subscriptions.Insert(id, eventName, request) != nullptr);
+        }
+
+        bool Remove(const uint32_t id)
+        {
+            return (_subscriptions.Remove(id));
+        }
+
+        // The subscription started by request, on this connection
+        void Remove(const std::string& eventName, const std::string& request)
+        {
+            _subscriptions.ForEach(
+                [&](const uint32_t, Subscribed& subscribed) { return ((subscribed.eventName == eventName) && (subscribed.request == request)); },
+                [](const uint32_t, Subscribed&) {});
+        }
+
+        // Every subscription to eventName
+        void Remove(const std::string& eventName)
+        {
+            _subscriptions.ForEach(
+                [&](const uint32_t, Subscribed& subscribed) { return (subscribed.eventName == eventName); },
+                [](const uint32_t, Subscribed&) {});
+        }
+
+        // The event the notification with this id belongs to. A copy: the entry is pinned while
+        // it is read, and a listener may well unsubscribe from within its callback.
+        bool Find(const uint32_t id, std::string& eventName)
+        {
+            return (_subscriptions.Visit(id, [&](const Subscribed& subscribed) { eventName = subscribed.eventName; }));
+        }
+
+    private:
+        PendingTable<Subscribed, CAPACITY, (CAPACITY < 16 ? CAPACITY : 16)> _subscriptions;
+    };
+}
@@ -0,0 +1,329 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace FireboltSDK {
+
+    /* Table of in-flight requests, indexed by the JSON-RPC sequence id.
+       A request lands in a slot picked by a multiplicative hash of its id; on a collision the
+       next MAXPROBE slots are tried. The ids in flight are mostly consecutive, and a caller
+       that is slow to collect its responses leaves a block of them behind. Placed by the id
+       itself, such a block would be a run of taken slots longer than MAXPROBE.
+       Insert, lookup and erase are lock-free: a slot is claimed with a CAS on its id and
+       readers pin it with a user count, so an entry is never destroyed while being signalled.
+       A request that finds no free slot spills over into a map behind a mutex, so the number
+       in flight is not limited by CAPACITY; the lock is only taken while anything spilled.
+       CAPACITY is twice the 256 requests the transport is sized for, which keeps the probes
+       short enough that nothing spills at that load.
+       Ids 0 (free) and ~0 (busy) are reserved and must not be handed out by the sequence.
+    */
+    template <typename ENTRY, uint16_t CAPACITY = 512, uint8_t MAXPROBE = 16>
+    class PendingTable {
+    private:
+        static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+        static_assert(MAXPROBE <= CAPACITY, "MAXPROBE can not exceed CAPACITY");
+
+        static constexpr uint32_t FreeId = 0;
+        static constexpr uint32_t BusyId = ~static_cast<uint32_t>(0);
+
+        struct alignas(64) Slot {
+            Slot()
+                : id(FreeId)
+                , users(0)
+            {
+            }
+
+            ENTRY& Entry()
+            {
+                return (*reinterpret_cast<ENTRY*>(&storage));
+            }
+
+            std::atomic<uint32_t> id;
+            std::atomic<uint32_t> users;
+            typename std::aligned_storage<sizeof(ENTRY), alignof(ENTRY)>::type storage;
+        };
+
+        // An entry that did not fit in the slots, pinned while the lock is held
+        struct Spill {
+            template <typename... Args>
+            Spill(Args&&... args)
+                : users(0)
+                , entry(std::forward<Args>(args)...)
+            {
+            }
+
+            std::atomic<uint32_t> users;
+            ENTRY entry;
+        };
+        using SpillMap = std::unordered_map<uint32_t, std::unique_ptr<Spill>>;
+
+    public:
+        PendingTable(const PendingTable&) = delete;
+        PendingTable& operator=(const PendingTable&) = delete;
+
+        PendingTable()
+            : _spillLock()
+            , _spilled()
+            , _spills(0)
+        {
+        }
+        ~PendingTable()
+        {
+            for (Slot& slot : _slots) {
+                uint32_t id = slot.id.load(std::memory_order_acquire);
+                if ((id != FreeId) && (id != BusyId)) {
+                    Remove(id);
+                }
+            }
+        }
+
+    public:
+        static bool IsValid(const uint32_t id)
+        {
+            return ((id != FreeId) && (id != BusyId));
+        }
+
+        // Construct an entry for the given id. Returns nullptr if the id is invalid or
+        // already present. Each id is inserted by one thread only, as the sequence hands it
+        // out once: concurrent Inserts of the same id are not told apart.
+        template <typename... Args>
+        ENTRY* Insert(const uint32_t id, Args&&... args)
+        {
+            ENTRY* result = nullptr;
+
+            if (IsValid(id) == true) {
+                // The whole window and the spill first: a slot freed in front of the id, or
+                // after it spilled, must not take the same id a second time
+                bool present = false;
+                for (uint8_t probe = 0; (probe < MAXPROBE) && (present == false); ++probe) {
+                    present = (_slots[(Home(id) + probe) & (CAPACITY - 1)].id.load(std::memory_order_acquire) == id);
+                }
+                if ((present == false) && (_spills.load(std::memory_order_seq_cst) != 0)) {
+                    std::lock_guard<std::mutex> guard(_spillLock);
+                    present = (_spilled.find(id) != _spilled.end());
+                }
+
+                for (uint8_t probe = 0; (probe < MAXPROBE) && (result == nullptr) && (present == false); ++probe) {
+                    Slot& slot = _slots[(Home(id) + probe) & (CAPACITY - 1)];
+                    uint32_t expected = slot.id.load(std::memory_order_relaxed);
+                    if ((expected == FreeId) && (slot.id.compare_exchange_strong(expected, BusyId, std::memory_order_acquire, std::memory_order_relaxed) == true)) {
+                        new (&slot.storage) ENTRY(std::forward<Args>(args)...);
+                        slot.id.store(id, std::memory_order_release);
+                        result = &slot.Entry();
+                    }
+                }
+
+                if ((result == nullptr) && (present == false)) {
+                    std::lock_guard<std::mutex> guard(_spillLock);
+                    std::pair<typename SpillMap::iterator, bool> added = _spilled.emplace(id, nullptr);
+                    if (added.second == true) {
+                        added.first->second.reset(new Spill(std::forward<Args>(args)...));
+                        _spills.fetch_add(1, std::memory_order_seq_cst);
+                        result = &(added.first->second->entry);
+                    }
+                }
+            }
+
+            return (result);
+        }
+
+        // Number of entries that did not fit in the slots
+        uint32_t Spilled() const
+        {
+            return (_spills.load(std::memory_order_relaxed));
+        }
+
+        // Run the action on the entry while it is pinned, so a concurrent Remove can not
+        // destroy it underneath us.
+        template <typename ACTION>
+        bool Visit(const uint32_t id, ACTION&& action)
+        {
+            bool found = false;
+
+            if (IsValid(id) == true) {
+                for (uint8_t probe = 0; (probe < MAXPROBE) && (found == false); ++probe) {
+                    Slot& slot = _slots[(Home(id) + probe) & (CAPACITY - 1)];
+                    // A plain read first, pinning is a write to a shared cache line
+                    if ((slot.id.load(std::memory_order_relaxed) == id) && (Pin(slot, id) == true)) {
+                        action(slot.Entry());
+                        Unpin(slot);
+                        found = true;
+                    }
+                }
+
+                if ((found == false) && (_spills.load(std::memory_order_seq_cst) != 0)) {
+                    Spill* spill = Pin(id);
+                    if (spill != nullptr) {
+                        action(spill->entry);
+                        spill->users.fetch_sub(1, std::memory_order_release);
+                        found = true;
+                    }
+                }
+            }
+
+            return (found);
+        }
+
+        // Take the entry out of the table. Only one of several concurrent removers of the
+        // same id wins; the winner runs the action before the entry is destroyed.
+        template <typename ACTION>
+        bool Remove(const uint32_t id, ACTION&& action)
+        {
+            bool removed = false;
+
+            if (IsValid(id) == true) {
+                for (uint8_t probe = 0; (probe < MAXPROBE) && (removed == false); ++probe) {
+                    Slot& slot = _slots[(Home(id) + probe) & (CAPACITY - 1)];
+                    uint32_t expected = id;
+                    if (slot.id.compare_exchange_strong(expected, BusyId, std::memory_order_seq_cst, std::memory_order_relaxed) == true) {
+                        while (slot.users.load(std::memory_order_seq_cst) != 0) {
+                            std::this_thread::yield();
+                        }
+                        action(slot.Entry());
+                        slot.Entry().~ENTRY();
+                        slot.id.store(FreeId, std::memory_order_release);
+                        removed = true;
+                    }
+                }
+
+                if ((removed == false) && (_spills.load(std::memory_order_seq_cst) != 0)) {
+                    std::unique_ptr<Spill> spill;
+                    _spillLock.lock();
+                    typename SpillMap::iterator index = _spilled.find(id);
+                    if (index != _spilled.end()) {
+                        spill = std::move(index->second);
+                        _spilled.erase(index);
+                        _spills.fetch_sub(1, std::memory_order_seq_cst);
+                    }
+                    _spillLock.unlock();
+
+                    if (spill != nullptr) {
+                        // Out of the map, so no new visitors: wait for the ones still in there
+                        while (spill->users.load(std::memory_order_acquire) != 0) {
+                            std::this_thread::yield();
+                        }
+                        action(spill->entry);
+                        removed = true;
+                    }
+                }
+            }
+
+            return (removed);
+        }
+
+        bool Remove(const uint32_t id)
+        {
+            return (Remove(id, [](ENTRY&) {}));
+        }
+
+        // Walk all entries. The action gets (id, entry) while the entry is pinned
+        // and returns true if the entry should be removed afterwards; in that case the
+        // remover is passed the entry again, unless someone else removed it first.
+        template <typename ACTION, typename REMOVER>
+        void ForEach(ACTION&& action, REMOVER&& remover)
+        {
+            for (Slot& slot : _slots) {
+                uint32_t id = slot.id.load(std::memory_order_acquire);
+                if ((IsValid(id) == true) && (Pin(slot, id) == true)) {
+                    bool remove = action(id, slot.Entry());
+                    Unpin(slot);
+                    if (remove == true) {
+                        Remove(id, [&](ENTRY& entry) { remover(id, entry); });
+                    }
+                }
+            }
+
+            if (_spills.load(std::memory_order_seq_cst) != 0) {
+                std::vector<uint32_t> spilled;
+                _spillLock.lock();
+                for (const typename SpillMap::value_type& spill : _spilled) {
+                    spilled.push_back(spill.first);
+                }
+                _spillLock.unlock();
+
+                for (const uint32_t id : spilled) {
+                    Spill* spill = Pin(id);
+                    if (spill != nullptr) {
+                        bool remove = action(id, spill->entry);
+                        spill->users.fetch_sub(1, std::memory_order_release);
+                        if (remove == true) {
+                            Remove(id, [&](ENTRY& entry) { remover(id, entry); });
+                        }
+                    }
+                }
+            }
+        }
+
+    private:
+        // Fibonacci hashing, the high half of the product spreads consecutive ids over the slots
+        static uint32_t Home(const uint32_t id)
+        {
+            return ((id * 0x9E3779B1u) >> 16);
+        }
+
+        Spill* Pin(const uint32_t id)
+        {
+            Spill* result = nullptr;
+
+            std::lock_guard<std::mutex> guard(_spillLock);
+            typename SpillMap::iterator index = _spilled.find(id);
+            if (index != _spilled.end()) {
+                result = index->second.get();
+                result->users.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            return (result);
+        }
+
+        bool Pin(Slot& slot, const uint32_t id)
+        {
+            bool pinned = false;
+
+            // Sequentially consistent on purpose: the pin and Remove's claim must observe each other.
+            slot.users.fetch_add(1, std::memory_order_seq_cst);
+            if (slot.id.load(std::memory_order_seq_cst) == id) {
+                pinned = true;
+            } else {
+                Unpin(slot);
+            }
+
+            return (pinned);
+        }
+
+        void Unpin(Slot& slot)
+        {
+            slot.users.fetch_sub(1, std::memory_order_release);
+        }
+
+    private:
+        Slot _slots[CAPACITY];
+        std::mutex _spillLock;
+        SpillMap _spilled;
+        std::atomic<uint32_t> _spills;
+    };
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+
+#include "Statistics.h"
+
+namespace FireboltSDK {
+
+    // Method names come from the application, as a JSON string they may need escaping
+    static void Quote(const string& value, string& text)
+    {
+        text += '"';
+        for (const char character : value) {
+            if ((character == '"') || (character == '\\')) {
+                text += '\\';
+                text += character;
+            } else if (static_cast<unsigned char>(character) < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(character));
+                text += escaped;
+            } else {
+                text += character;
+            }
+        }
+        text += '"';
+    }
+
+    uint32_t Histogram::Percentile(const double percentile) const
+    {
+        uint32_t result = 0;
+        uint64_t total = 0;
+        for (const std::atomic<uint32_t>& bucket : _buckets) {
+            total += bucket.load(std::memory_order_relaxed);
+        }
+
+        if (total != 0) {
+            const uint64_t target = std::max(static_cast<uint64_t>(1), static_cast<uint64_t>((total * percentile) / 100.0 + 0.5));
+            uint64_t seen = 0;
+            uint16_t index = 0;
+            while ((index < Buckets) && (seen < target)) {
+                seen += _buckets[index++].load(std::memory_order_relaxed);
+            }
+            result = std::min(Highest(index - 1), Max());
+        }
+
+        return (result);
+    }
+
+    void Histogram::ToString(string& text) const
+    {
+        text += _T("{\"count\":") + std::to_string(Count());
+        text += _T(",\"mean\":") + std::to_string(Mean());
+        text += _T(",\"p50\":") + std::to_string(Percentile(50.0));
+        text += _T(",\"p90\":") + std::to_string(Percentile(90.0));
+        text += _T(",\"p99\":") + std::to_string(Percentile(99.0));
+        text += _T(",\"p999\":") + std::to_string(Percentile(99.9));
+        text += _T(",\"max\":") + std::to_string(Max()) + _T("}");
+    }
+
+    void Statistics::Method::ToString(string& text) const
+    {
+        Quote(_name, text);
+        text += _T(":{\"calls\":") + std::to_string(_calls.load(std::memory_order_relaxed));
+        text += _T(",\"errors\":") + std::to_string(_errors.load(std::memory_order_relaxed));
+        text += _T(",\"timeouts\":") + std::to_string(_timeouts.load(std::memory_order_relaxed));
+        text += _T(",\"bytesOut\":") + std::to_string(_bytesOut.load(std::memory_order_relaxed));
+        text += _T(",\"bytesIn\":") + std::to_string(_bytesIn.load(std::memory_order_relaxed));
+        text += _T(",\"latency\":");
+        _latency.ToString(text);
+        text += _T("}");
+    }
+
+    Statistics::Statistics()
+        : _methods()
+        , _overflow(_T("*"))
+        , _queueWait()
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+        for (std::atomic<Method*>& method : _methods) {
+            method.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    Statistics::~Statistics()
+    {
+        for (std::atomic<Method*>& method : _methods) {
+            delete method.load(std::memory_order_relaxed);
+        }
+    }
+
+    /* static */ Statistics& Statistics::Instance()
+    {
+        static Statistics *instance = new Statistics();
+        ASSERT(instance != nullptr);
+        return *instance;
+    }
+
+    Statistics::Method& Statistics::Find(const string& method)
+    {
+        const size_t hash = std::hash<string>()(method);
+
+        for (uint16_t probe = 0; probe < Capacity; ++probe) {
+            std::atomic<Method*>& slot = _methods[(hash + probe) & (Capacity - 1)];
+            Method* entry = slot.load(std::memory_order_acquire);
+            if (entry == nullptr) {
+                Method* created = new Method(method);
+                if (slot.compare_exchange_strong(entry, created, std::memory_order_acq_rel) == true) {
+                    return (*created);
+                }
+                // Someone else claimed the slot first, entry is now theirs
+                delete created;
+            }
+            if (entry->Name() == method) {
+                return (*entry);
+            }
+        }
+
+        return (_overflow);
+    }
+
+    void Statistics::ToString(string& text) const
+    {
+        bool first = true;
+        text += _T("{\"methods\":{");
+        for (const std::atomic<Method*>& slot : _methods) {
+            const Method* method = slot.load(std::memory_order_acquire);
+            if (method != nullptr) {
+                if (first == false) {
+                    text += _T(",");
+                }
+                method->ToString(text);
+                first = false;
+            }
+        }
+        text += (first == false ? _T(",") : _T(""));
+        _overflow.ToString(text);
+        text += _T("},\"queueWait\":");
+        _queueWait.ToString(text);
+        text += _T("}");
+    }
+}
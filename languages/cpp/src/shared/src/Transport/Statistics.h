@@ -0,0 +1,214 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "Module.h"
+
+#include <atomic>
+
+namespace FireboltSDK {
+
+    /* Latency distribution in the spirit of HDR histograms: buckets are log-linear, 8 per
+       power of two, so any value is reported within 12.5% over a range of 1us to 71 minutes.
+       Recording is a handful of relaxed atomic increments, reading takes a (loose) snapshot.
+       All values are in microseconds.
+    */
+    class Histogram {
+    private:
+        static constexpr uint8_t SubBits = 3;
+        static constexpr uint8_t SubBuckets = (1 << SubBits);
+        // 32 bit values: the exponents 0..SubBits share the first SubBuckets buckets
+        static constexpr uint16_t Buckets = ((32 - SubBits + 1) * SubBuckets);
+
+    public:
+        Histogram(const Histogram&) = delete;
+        Histogram& operator=(const Histogram&) = delete;
+
+        Histogram()
+            : _buckets()
+            , _count(0)
+            , _sum(0)
+            , _max(0)
+        {
+            for (std::atomic<uint32_t>& bucket : _buckets) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+        ~Histogram() = default;
+
+    public:
+        void Record(const uint64_t value)
+        {
+            const uint32_t clamped = (value > 0xFFFFFFFF ? 0xFFFFFFFF : static_cast<uint32_t>(value));
+
+            _buckets[Index(clamped)].fetch_add(1, std::memory_order_relaxed);
+            _count.fetch_add(1, std::memory_order_relaxed);
+            _sum.fetch_add(clamped, std::memory_order_relaxed);
+
+            uint32_t max = _max.load(std::memory_order_relaxed);
+            while ((clamped > max) && (_max.compare_exchange_weak(max, clamped, std::memory_order_relaxed) == false)) {
+            }
+        }
+
+        uint64_t Count() const
+        {
+            return (_count.load(std::memory_order_relaxed));
+        }
+        uint64_t Mean() const
+        {
+            const uint64_t count = Count();
+            return (count != 0 ? _sum.load(std::memory_order_relaxed) / count : 0);
+        }
+        uint32_t Max() const
+        {
+            return (_max.load(std::memory_order_relaxed));
+        }
+        // The highest value that falls in the same bucket as the given percentile
+        uint32_t Percentile(const double percentile) const;
+
+        void ToString(string& text) const;
+
+    private:
+        static uint16_t Index(const uint32_t value)
+        {
+            uint16_t index = value;
+            if (value >= SubBuckets) {
+                const uint8_t exponent = (31 - __builtin_clz(value));
+                index = ((exponent - SubBits + 1) * SubBuckets) + ((value >> (exponent - SubBits)) & (SubBuckets - 1));
+            }
+            return (index);
+        }
+        static uint32_t Highest(const uint16_t index)
+        {
+            uint32_t highest = index;
+            if (index >= SubBuckets) {
+                const uint8_t shift = ((index / SubBuckets) - 1);
+                const uint64_t lowest = static_cast<uint64_t>(SubBuckets + (index % SubBuckets)) << shift;
+                highest = static_cast<uint32_t>(lowest + (static_cast<uint64_t>(1) << shift) - 1);
+            }
+            return (highest);
+        }
+
+    private:
+        std::atomic<uint32_t> _buckets[Buckets];
+        std::atomic<uint64_t> _count;
+        std::atomic<uint64_t> _sum;
+        std::atomic<uint32_t> _max;
+    };
+
+    /* Per method counters and latencies of everything that goes over the Transport.
+       Methods are looked up in a fixed size, open addressed table that is only ever added to,
+       so recording never takes a lock; once the table is full, the remaining methods are
+       accounted for under "*".
+    */
+    class Statistics {
+    public:
+        class Method {
+        public:
+            Method(const Method&) = delete;
+            Method& operator=(const Method&) = delete;
+
+            Method(const string& name)
+                : _name(name)
+                , _calls(0)
+                , _errors(0)
+                , _timeouts(0)
+                , _bytesOut(0)
+                , _bytesIn(0)
+                , _latency()
+            {
+            }
+            ~Method() = default;
+
+        public:
+            const string& Name() const
+            {
+                return (_name);
+            }
+            void Sent(const uint32_t bytes)
+            {
+                _calls.fetch_add(1, std::memory_order_relaxed);
+                _bytesOut.fetch_add(bytes, std::memory_order_relaxed);
+            }
+            // A response came in, elapsed is the time since it was sent
+            void Received(const uint32_t error, const uint64_t elapsed)
+            {
+                if (error != WPEFramework::Core::ERROR_NONE) {
+                    _errors.fetch_add(1, std::memory_order_relaxed);
+                }
+                _latency.Record(elapsed);
+            }
+            // The result of a response was taken as text, for the calls the Transport waits for.
+            // Asynchronous callers get the message itself and are not accounted for here.
+            void Loaded(const uint32_t bytes)
+            {
+                _bytesIn.fetch_add(bytes, std::memory_order_relaxed);
+            }
+            // Gone without a response
+            void Failed(const uint32_t error)
+            {
+                if (error == WPEFramework::Core::ERROR_TIMEDOUT) {
+                    _timeouts.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    _errors.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            void ToString(string& text) const;
+
+        private:
+            const string _name;
+            std::atomic<uint64_t> _calls;
+            std::atomic<uint64_t> _errors;
+            std::atomic<uint64_t> _timeouts;
+            std::atomic<uint64_t> _bytesOut;
+            std::atomic<uint64_t> _bytesIn;
+            Histogram _latency;
+        };
+
+    private:
+        static constexpr uint16_t Capacity = 512;
+
+        Statistics();
+
+    public:
+        Statistics(const Statistics&) = delete;
+        Statistics& operator=(const Statistics&) = delete;
+
+        ~Statistics();
+        static Statistics& Instance();
+
+    public:
+        Method& Find(const string& method);
+
+        // Time a received message waited for a worker thread
+        void Queued(const uint64_t elapsed)
+        {
+            _queueWait.Record(elapsed);
+        }
+
+        // JSON document with all methods seen so far
+        void ToString(string& text) const;
+
+    private:
+        std::atomic<Method*> _methods[Capacity];
+        Method _overflow;
+        Histogram _queueWait;
+    };
+}
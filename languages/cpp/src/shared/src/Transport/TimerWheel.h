@@ -0,0 +1,194 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+namespace FireboltSDK {
+
+    /* Hashed timer wheel for the expiry of in-flight requests, keyed by request id.
+       Time is cut in ticks of RESOLUTION us; a timer goes in slot (tick % SLOTS), timers
+       further out than one turn share the slot and simply wait for their turn.
+       Timers live in a pool and are chained per slot, so arming and cancelling are O(1)
+       and the pool never grows beyond the most timers armed at once.
+       Timers never fire early, and at most one tick late.
+    */
+    template <uint16_t SLOTS = 256, uint32_t RESOLUTION = 10000>
+    class TimerWheel {
+    public:
+        // Names an armed timer for Cancel(). Reused once the timer fired or was cancelled.
+        using Handle = uint32_t;
+        static constexpr Handle NoTimer = ~static_cast<Handle>(0);
+
+    private:
+        static_assert((SLOTS & (SLOTS - 1)) == 0, "SLOTS must be a power of two");
+
+        struct Timer {
+            uint32_t id;
+            uint64_t tick; // 0 while in the free list
+            Handle previous;
+            Handle next;
+        };
+
+    public:
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+        TimerWheel()
+            : _lock()
+            , _timers()
+            , _free(NoTimer)
+            , _processed(0)
+            , _count(0)
+        {
+            std::fill(std::begin(_slots), std::end(_slots), NoTimer);
+        }
+        ~TimerWheel() = default;
+
+    public:
+        // expiry in Core::Time ticks (us)
+        Handle Arm(const uint32_t id, const uint64_t expiry)
+        {
+            // Rounded up, so it is only due once its expiry has really passed
+            uint64_t tick = (expiry + RESOLUTION - 1) / RESOLUTION;
+
+            std::lock_guard<std::mutex> lock(_lock);
+            if (tick <= _processed) {
+                tick = _processed + 1;
+            }
+
+            Handle handle = _free;
+            if (handle != NoTimer) {
+                _free = _timers[handle].next;
+            } else {
+                handle = static_cast<Handle>(_timers.size());
+                _timers.push_back({});
+            }
+
+            Handle& head = _slots[tick & (SLOTS - 1)];
+            Timer& timer = _timers[handle];
+            timer.id = id;
+            timer.tick = tick;
+            timer.previous = NoTimer;
+            timer.next = head;
+            if (head != NoTimer) {
+                _timers[head].previous = handle;
+            }
+            head = handle;
+            ++_count;
+
+            return (handle);
+        }
+
+        // Returns false if the timer already fired or was cancelled. The id guards against
+        // a handle that was handed out again in the mean time.
+        bool Cancel(const Handle handle, const uint32_t id)
+        {
+            bool cancelled = false;
+
+            std::lock_guard<std::mutex> lock(_lock);
+            if ((handle < _timers.size()) && (_timers[handle].tick != 0) && (_timers[handle].id == id)) {
+                Release(handle);
+                cancelled = true;
+            }
+
+            return (cancelled);
+        }
+
+        // Moves the ids of all timers due at now to due, and returns when the next one
+        // might be, or 0 if no timers are left.
+        uint64_t Advance(const uint64_t now, std::vector<uint32_t>& due)
+        {
+            uint64_t next = 0;
+            const uint64_t current = now / RESOLUTION;
+
+            std::lock_guard<std::mutex> lock(_lock);
+
+            if (_processed == 0) {
+                // First turn, nothing can be due before the first timer was armed
+                _processed = (current > SLOTS ? current - SLOTS : 0);
+            }
+
+            // After a full turn every slot has been looked at
+            const uint64_t last = std::min(current, _processed + SLOTS);
+            for (uint64_t tick = _processed + 1; tick <= last; ++tick) {
+                Handle index = _slots[tick & (SLOTS - 1)];
+                while (index != NoTimer) {
+                    const Handle following = _timers[index].next;
+                    if (_timers[index].tick <= current) {
+                        due.push_back(_timers[index].id);
+                        Release(index);
+                    }
+                    index = following;
+                }
+            }
+            if (current > _processed) {
+                _processed = current;
+            }
+
+            if (_count != 0) {
+                // The first slot in use is the earliest tick something can come due
+                uint64_t tick = _processed + 1;
+                while (_slots[tick & (SLOTS - 1)] == NoTimer) {
+                    ++tick;
+                }
+                next = tick * RESOLUTION;
+            }
+
+            return (next);
+        }
+
+        // Timers armed and neither fired nor cancelled
+        uint32_t Count() const
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            return (_count);
+        }
+
+    private:
+        // Unchains the timer from its slot and hands it back to the pool
+        void Release(const Handle handle)
+        {
+            Timer& timer = _timers[handle];
+            if (timer.previous != NoTimer) {
+                _timers[timer.previous].next = timer.next;
+            } else {
+                _slots[timer.tick & (SLOTS - 1)] = timer.next;
+            }
+            if (timer.next != NoTimer) {
+                _timers[timer.next].previous = timer.previous;
+            }
+            timer.tick = 0;
+            timer.next = _free;
+            _free = handle;
+            --_count;
+        }
+
+    private:
+        mutable std::mutex _lock;
+        std::vector<Timer> _timers;
+        Handle _slots[SLOTS];
+        Handle _free;
+        uint64_t _processed;
+        uint32_t _count;
+    };
+}
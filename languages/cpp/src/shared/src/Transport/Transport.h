@@ -18,16 +18,49 @@
 
 #pragma once
 
+#include <limits>
 #include <memory>
+#include <type_traits>
+#include <unordered_map>
 #include "Module.h"
 #include "error.h"
-#include "json_engine.h"
+#include "PendingTable.h"
+#include "EventRegistry.h"
+#include "TimerWheel.h"
+#include "Statistics.h"
+#include "Accessor/WorkerPool.h"
+#include "Tracer/Tracer.h"
 
 namespace FireboltSDK
 {
 
     using namespace WPEFramework::Core::TypeTraits;
 
+    /* The result of a JSON-RPC message as text, for parsing it into a response. Result.Value()
+       hands out a new string every time; this serializes the result instead into a buffer of the
+       calling thread, which keeps its capacity from one response to the next. The text stays
+       valid until the same thread asks for the next result, so it is parsed straight away.
+    */
+    inline const string &ResultOf(const WPEFramework::Core::JSONRPC::Message &message)
+    {
+        static thread_local string text;
+        text.clear();
+        if (message.Result.IsSet() == true)
+        {
+            // Through IElement: the JSON types keep their Serialize private
+            const WPEFramework::Core::JSON::IElement &result = message.Result;
+            char chunk[512];
+            uint32_t offset = 0;
+            uint16_t loaded = 0;
+            do
+            {
+                loaded = result.Serialize(chunk, sizeof(chunk), offset);
+                text.append(chunk, loaded);
+            } while ((offset != 0) && (loaded == sizeof(chunk)));
+        }
+        return (text);
+    }
+
     template <typename SOCKETTYPE, typename INTERFACE, typename CLIENT, typename MESSAGETYPE>
     class CommunicationChannel
     {
@@ -50,20 +83,21 @@ namespace FireboltSDK
             struct ASynchronous
             {
                 ASynchronous(const uint32_t waitTime, const Callback &completed)
-                    : _waitTime(WPEFramework::Core::Time::Now().Add(waitTime).Ticks()), _completed(completed)
+                    : _waitTime(WPEFramework::Core::Time::Now().Add(waitTime).Ticks()), _completed(completed), _timer(TimerWheel<>::NoTimer)
                 {
                 }
                 uint64_t _waitTime;
                 Callback _completed;
+                TimerWheel<>::Handle _timer;
             };
 
         public:
             Entry()
-                : _synchronous(true), _info()
+                : _synchronous(true), _info(), _method(nullptr), _sent(0), _recorded(false)
             {
             }
             Entry(const uint32_t waitTime, const Callback &completed)
-                : _synchronous(false), _info(waitTime, completed)
+                : _synchronous(false), _info(waitTime, completed), _method(nullptr), _sent(0), _recorded(false)
             {
             }
             ~Entry()
@@ -79,12 +113,48 @@ namespace FireboltSDK
             }
 
         public:
-            const WPEFramework::Core::ProxyType<MESSAGETYPE> &Response() const
+            WPEFramework::Core::ProxyType<MESSAGETYPE> Response() const
+            {
+                // An aborted entry is signalled without a response
+                return (_info.sync._response.empty() == false ? *(_info.sync._response.begin()) : WPEFramework::Core::ProxyType<MESSAGETYPE>());
+            }
+            bool IsSynchronous() const
             {
-                return (*(_info.sync._response.begin()));
+                return (_synchronous);
+            }
+            // Starts the clock for the statistics of method
+            void Sent(Statistics::Method &method, const uint32_t bytes)
+            {
+                _method = &method;
+                _sent = WPEFramework::Core::Time::Now().Ticks();
+                method.Sent(bytes);
+            }
+            const char *Method() const
+            {
+                return (_method != nullptr ? _method->Name().c_str() : nullptr);
+            }
+            // The result text of the response was taken, bytes long
+            void Loaded(const uint32_t bytes)
+            {
+                if (_method != nullptr)
+                {
+                    _method->Loaded(bytes);
+                }
             }
+            // A synchronous caller gave up waiting
+            void TimedOut()
+            {
+                Failed(WPEFramework::Core::ERROR_TIMEDOUT);
+            }
+            // The size of the result is only known once someone takes its text, see Loaded()
             bool Signal(const WPEFramework::Core::ProxyType<MESSAGETYPE> &response)
             {
+                if ((_method != nullptr) && (_recorded.exchange(true) == false))
+                {
+                    _method->Received((response->Error.IsSet() == true ? response->Error.Code.Value() : WPEFramework::Core::ERROR_NONE),
+                        WPEFramework::Core::Time::Now().Ticks() - _sent);
+                }
+
                 if (_synchronous == true)
                 {
                     _info.sync._response.push_back(response);
@@ -92,6 +162,7 @@ namespace FireboltSDK
                 }
                 else
                 {
+                    Tracer::Span callback(Tracer::Phase::Callback, response->Id.Value(), Method());
                     _info.async._completed(*response);
                 }
 
@@ -101,8 +172,20 @@ namespace FireboltSDK
             {
                 return (_info.async._waitTime);
             }
+            // The timer that expires an a-synchronous entry, to cancel once it completes otherwise
+            void Armed(const TimerWheel<>::Handle timer)
+            {
+                ASSERT(_synchronous == false);
+                _info.async._timer = timer;
+            }
+            TimerWheel<>::Handle Timer() const
+            {
+                return (_synchronous == false ? _info.async._timer : TimerWheel<>::NoTimer);
+            }
             void Abort(const uint32_t id)
             {
+                Failed(WPEFramework::Core::ERROR_ASYNC_ABORTED);
+
                 if (_synchronous == true)
                 {
                     _info.sync._signal.SetEvent();
@@ -114,7 +197,7 @@ namespace FireboltSDK
                     _info.async._completed(message);
                 }
             }
-            bool Expired(const uint32_t id, const uint64_t &currentTime, uint64_t &nextTime)
+            bool Expired(const uint64_t &currentTime, uint64_t &nextTime) const
             {
                 bool expired = false;
 
@@ -129,20 +212,35 @@ namespace FireboltSDK
                     }
                     else
                     {
-                        MESSAGETYPE message;
-                        ToMessage(id, message, WPEFramework::Core::ERROR_TIMEDOUT);
-                        _info.async._completed(message);
                         expired = true;
                     }
                 }
                 return (expired);
             }
+            void Expire(const uint32_t id)
+            {
+                ASSERT(_synchronous == false);
+
+                Failed(WPEFramework::Core::ERROR_TIMEDOUT);
+
+                MESSAGETYPE message;
+                ToMessage(id, message, WPEFramework::Core::ERROR_TIMEDOUT);
+                _info.async._completed(message);
+            }
             bool WaitForResponse(const uint32_t waitTime)
             {
                 return (_info.sync._signal.Lock(waitTime) == WPEFramework::Core::ERROR_NONE);
             }
 
         private:
+            // Whoever completes the entry first accounts for it
+            void Failed(const uint32_t error)
+            {
+                if ((_method != nullptr) && (_recorded.exchange(true) == false))
+                {
+                    _method->Failed(error);
+                }
+            }
             void ToMessage(const uint32_t id, WPEFramework::Core::JSONRPC::Message &message, uint32_t error)
             {
                 message.Id = id;
@@ -180,6 +278,9 @@ namespace FireboltSDK
                 Synchronous sync;
                 ASynchronous async;
             } _info;
+            Statistics::Method *_method;
+            uint64_t _sent;
+            std::atomic<bool> _recorded;
         };
 
     private:
@@ -263,34 +364,75 @@ namespace FireboltSDK
             WPEFramework::Core::TimerType<WatchDog> _watchDog;
         };
 
-        class ChannelImpl : public WPEFramework::Core::StreamJSONType<WPEFramework::Web::WebSocketClientType<SOCKETTYPE>, FactoryImpl &, INTERFACE>
+    public:
+        // The websocket subprotocols, telling the server how the frames are encoded
+        static constexpr const TCHAR *JSONProtocol = _T("JSON");
+        static constexpr const TCHAR *MessagePackProtocol = _T("MessagePack");
+
+        static const TCHAR *Protocol(const WPEFramework::Core::JSON::IElement *)
+        {
+            return (JSONProtocol);
+        }
+        static const TCHAR *Protocol(const WPEFramework::Core::JSON::IMessagePack *)
+        {
+            return (MessagePackProtocol);
+        }
+
+    private:
+        // Frames its messages as FRAME, announcing the matching subprotocol
+        template <typename FRAME>
+        class ChannelImpl : public WPEFramework::Core::StreamJSONType<WPEFramework::Web::WebSocketClientType<SOCKETTYPE>, FactoryImpl &, FRAME>
         {
         private:
             ChannelImpl(const ChannelImpl &) = delete;
             ChannelImpl &operator=(const ChannelImpl &) = delete;
 
-            typedef WPEFramework::Core::StreamJSONType<WPEFramework::Web::WebSocketClientType<SOCKETTYPE>, FactoryImpl &, INTERFACE> BaseClass;
+            typedef WPEFramework::Core::StreamJSONType<WPEFramework::Web::WebSocketClientType<SOCKETTYPE>, FactoryImpl &, FRAME> BaseClass;
 
         public:
             ChannelImpl(CommunicationChannel *parent, const WPEFramework::Core::NodeId &remoteNode, const string &path, const string &query, const bool mask)
-                : BaseClass(5, FactoryImpl::Instance(), path, _T("JSON"), query, "", false, mask, false, remoteNode.AnyInterface(), remoteNode, 512, 512), _parent(*parent)
+                : BaseClass(5, FactoryImpl::Instance(), path, CommunicationChannel::Protocol(static_cast<const FRAME *>(nullptr)), query, "", false, mask, false, remoteNode.AnyInterface(), remoteNode, 512, 512), _parent(*parent), _opened(false), _received(false)
             {
             }
             ~ChannelImpl() override = default;
 
         public:
-            void Received(WPEFramework::Core::ProxyType<INTERFACE> &response) override
+            // Since the last Reset(): was the socket ever open, did anything come in over it
+            bool WasOpened() const
+            {
+                return (_opened.load(std::memory_order_acquire));
+            }
+            bool HasReceived() const
+            {
+                return (_received.load(std::memory_order_acquire));
+            }
+            void Reset()
+            {
+                _opened.store(false, std::memory_order_release);
+                _received.store(false, std::memory_order_release);
+            }
+
+            void Received(WPEFramework::Core::ProxyType<FRAME> &response) override
             {
                 WPEFramework::Core::ProxyType<MESSAGETYPE> inbound(response);
 
                 ASSERT(inbound.IsValid() == true);
                 if (inbound.IsValid() == true)
                 {
+                    _received.store(true, std::memory_order_release);
                     _parent.Inbound(inbound);
                 }
             }
-            void Send(WPEFramework::Core::ProxyType<INTERFACE> &msg) override
+            void Send(WPEFramework::Core::ProxyType<FRAME> &msg) override
             {
+                if (Tracer::IsEnabled() == true)
+                {
+                    WPEFramework::Core::ProxyType<MESSAGETYPE> outbound(msg);
+                    if (outbound.IsValid() == true)
+                    {
+                        Tracer::Written(outbound->Id.Value());
+                    }
+                }
 #ifdef __DEBUG__
                 string message;
                 ToMessage(msg, message);
@@ -299,6 +441,10 @@ namespace FireboltSDK
             }
             void StateChange() override
             {
+                if (BaseClass::IsOpen() == true)
+                {
+                    _opened.store(true, std::memory_order_release);
+                }
                 _parent.StateChange();
             }
             bool IsIdle() const override
@@ -335,11 +481,246 @@ namespace FireboltSDK
 
         private:
             CommunicationChannel &_parent;
+            std::atomic<bool> _opened;
+            std::atomic<bool> _received;
+        };
+
+    public:
+        // Whatever carries the messages to the other side and back
+        struct ILink
+        {
+            virtual ~ILink() = default;
+
+            virtual void Submit(const WPEFramework::Core::ProxyType<INTERFACE> &message) = 0;
+            virtual bool IsSuspended() const = 0;
+            virtual bool IsOpen() const = 0;
+            virtual bool Open(const uint32_t waitTime) = 0;
+            virtual void Close() = 0;
+            // The subprotocol the messages are encoded in, as settled with the other side
+            virtual const TCHAR *Protocol() const = 0;
+            // The socket underneath changed state. Returns whether the observers are to hear of it.
+            virtual bool Changed()
+            {
+                return (true);
+            }
+        };
+
+        // Answers a request in place of a server: fills in the response, or returns false to leave it unanswered
+        typedef std::function<bool(const MESSAGETYPE &request, MESSAGETYPE &response)> Responder;
+
+    private:
+        template <typename FRAME>
+        class SocketLink : public ILink
+        {
+        public:
+            SocketLink(const SocketLink &) = delete;
+            SocketLink &operator=(const SocketLink &) = delete;
+
+            SocketLink(CommunicationChannel *parent, const WPEFramework::Core::NodeId &remoteNode, const string &path, const string &query, const bool mask)
+                : _channel(parent, remoteNode, path, query, mask)
+            {
+            }
+            ~SocketLink() override = default;
+
+        public:
+            void Submit(const WPEFramework::Core::ProxyType<INTERFACE> &message) override
+            {
+                // Any message is both, framed as this link speaks
+                WPEFramework::Core::ProxyType<MESSAGETYPE> outbound(message);
+                _channel.Submit(WPEFramework::Core::ProxyType<FRAME>(outbound));
+            }
+            bool IsSuspended() const override
+            {
+                return (_channel.IsSuspended());
+            }
+            bool IsOpen() const override
+            {
+                return (_channel.IsOpen() == true);
+            }
+            bool Open(const uint32_t waitTime) override
+            {
+                bool result = true;
+                if (_channel.IsClosed() == true)
+                {
+                    _channel.Reset();
+                    result = (_channel.Open(waitTime) == WPEFramework::Core::ERROR_NONE);
+                }
+                return (result);
+            }
+            void Close() override
+            {
+                _channel.Close(WPEFramework::Core::infinite);
+            }
+            const TCHAR *Protocol() const override
+            {
+                return (CommunicationChannel::Protocol(static_cast<const FRAME *>(nullptr)));
+            }
+
+        public:
+            // Closed again without a word from the other side: it did not take to the subprotocol
+            bool IsRefused() const
+            {
+                return ((_channel.IsOpen() == false) && (_channel.HasReceived() == false));
+            }
+            bool WasOpened() const
+            {
+                return (_channel.WasOpened());
+            }
+
+        private:
+            ChannelImpl<FRAME> _channel;
+        };
+
+        /* Offers MessagePack first. A server that does not speak it refuses the upgrade, or
+           drops the connection before it answered anything: then the same endpoint is opened
+           again, speaking JSON. Only a connection that was reported open is reported closed
+           on the way. Every new connection starts out with MessagePack again.
+        */
+        class NegotiatedLink : public ILink
+        {
+        public:
+            NegotiatedLink(const NegotiatedLink &) = delete;
+            NegotiatedLink &operator=(const NegotiatedLink &) = delete;
+
+            NegotiatedLink(CommunicationChannel *parent, const WPEFramework::Core::NodeId &remoteNode, const string &path, const string &query, const bool mask)
+                : _preferred(parent, remoteNode, path, query, mask), _fallback(parent, remoteNode, path, query, mask), _current(&_preferred), _closing(false)
+            {
+            }
+            ~NegotiatedLink() override = default;
+
+        public:
+            void Submit(const WPEFramework::Core::ProxyType<INTERFACE> &message) override
+            {
+                _current.load(std::memory_order_acquire)->Submit(message);
+            }
+            bool IsSuspended() const override
+            {
+                return (_current.load(std::memory_order_acquire)->IsSuspended());
+            }
+            bool IsOpen() const override
+            {
+                return (_current.load(std::memory_order_acquire)->IsOpen());
+            }
+            bool Open(const uint32_t waitTime) override
+            {
+                _closing = false;
+                if ((_preferred.IsOpen() == false) && (_fallback.IsOpen() == false))
+                {
+                    _current.store(&_preferred, std::memory_order_release);
+                }
+                bool result = _current.load(std::memory_order_acquire)->Open(waitTime);
+                if ((result == false) && (waitTime != 0) && (_preferred.IsRefused() == true))
+                {
+                    _current.store(&_fallback, std::memory_order_release);
+                    result = _fallback.Open(waitTime);
+                }
+                return (result);
+            }
+            void Close() override
+            {
+                _closing = true;
+                _preferred.Close();
+                _fallback.Close();
+            }
+            const TCHAR *Protocol() const override
+            {
+                return (_current.load(std::memory_order_acquire)->Protocol());
+            }
+            bool Changed() override
+            {
+                bool report = true;
+                if ((_closing == false) && (_current.load(std::memory_order_acquire) == &_preferred) && (_preferred.IsRefused() == true))
+                {
+                    report = _preferred.WasOpened();
+                    _current.store(&_fallback, std::memory_order_release);
+                    _fallback.Open(0);
+                }
+                return (report);
+            }
+
+        private:
+            SocketLink<WPEFramework::Core::JSON::IMessagePack> _preferred;
+            SocketLink<WPEFramework::Core::JSON::IElement> _fallback;
+            std::atomic<ILink *> _current;
+            std::atomic<bool> _closing;
+        };
+
+        /* Hands every request to a responder in the same process and delivers its answer
+           right away, on the calling thread, through the same path a response from the
+           socket takes. Everything above the socket runs for real, without a server.
+        */
+        class LoopbackLink : public ILink
+        {
+        public:
+            LoopbackLink(const LoopbackLink &) = delete;
+            LoopbackLink &operator=(const LoopbackLink &) = delete;
+
+            LoopbackLink(CommunicationChannel *parent, const Responder &responder)
+                : _parent(*parent), _responder(responder), _open(false)
+            {
+            }
+            ~LoopbackLink() override = default;
+
+        public:
+            void Submit(const WPEFramework::Core::ProxyType<INTERFACE> &message) override
+            {
+                WPEFramework::Core::ProxyType<MESSAGETYPE> request(message);
+
+                ASSERT(request.IsValid() == true);
+                if ((request.IsValid() == true) && (_responder != nullptr))
+                {
+                    Tracer::Written(request->Id.Value());
+
+                    WPEFramework::Core::ProxyType<MESSAGETYPE> response(CommunicationChannel::Message());
+                    response->Id = request->Id.Value();
+                    if (_responder(*request, *response) == true)
+                    {
+                        _parent.Inbound(response);
+                    }
+                }
+            }
+            bool IsSuspended() const override
+            {
+                return (false);
+            }
+            bool IsOpen() const override
+            {
+                return (_open.load(std::memory_order_acquire));
+            }
+            bool Open(const uint32_t) override
+            {
+                if (_open.exchange(true) == false)
+                {
+                    _parent.StateChange();
+                }
+                return (true);
+            }
+            void Close() override
+            {
+                if (_open.exchange(false) == true)
+                {
+                    _parent.StateChange();
+                }
+            }
+            // Nothing is framed, the results and parameters are still in the encoding of INTERFACE
+            const TCHAR *Protocol() const override
+            {
+                return (CommunicationChannel::Protocol(static_cast<const INTERFACE *>(nullptr)));
+            }
+
+        private:
+            CommunicationChannel &_parent;
+            const Responder _responder;
+            std::atomic<bool> _open;
         };
 
     protected:
         CommunicationChannel(const WPEFramework::Core::NodeId &remoteNode, const string &path, const string &query, const bool mask)
-            : _channel(this, remoteNode, path, query, mask), _sequence(0)
+            : _adminLock(), _link(Link(static_cast<const INTERFACE *>(nullptr), this, remoteNode, path, query, mask)), _sequence(0), _observers()
+        {
+        }
+        CommunicationChannel(const Responder &responder)
+            : _adminLock(), _link(new LoopbackLink(this, responder)), _sequence(0), _observers()
         {
         }
 
@@ -353,6 +734,11 @@ namespace FireboltSDK
 
             return (channelMap.template Instance<CommunicationChannel>(searchLine, remoteNode, path, query, mask));
         }
+        // A channel of its own, answered by responder instead of a server
+        static WPEFramework::Core::ProxyType<CommunicationChannel> Loopback(const Responder &responder)
+        {
+            return (WPEFramework::Core::ProxyType<CommunicationChannel>::Create(responder));
+        }
 
     public:
         static void Trigger(const uint64_t &time, CLIENT *client)
@@ -365,14 +751,20 @@ namespace FireboltSDK
         }
         uint32_t Sequence() const
         {
-            return (++_sequence);
+            uint32_t id;
+            do
+            {
+                id = ++_sequence;
+            } while ((id == 0) || (id == static_cast<uint32_t>(~0))); // Reserved by the PendingTable
+            return (id);
         }
         void Register(CLIENT &client)
         {
             _adminLock.Lock();
             ASSERT(std::find(_observers.begin(), _observers.end(), &client) == _observers.end());
             _observers.push_back(&client);
-            if (true)
+            // A newcomer to a link that is already up will not see it change state
+            if (IsOpen() == true)
             {
                 client.Opened();
             }
@@ -390,56 +782,47 @@ namespace FireboltSDK
             _adminLock.Unlock();
         }
 
-// Send requests to JSON engine's mockRequest method for unit testing instead of channel's submit method
-#ifdef UNIT_TEST
-        void Submit(const WPEFramework::Core::ProxyType<INTERFACE> &message)
-        {
-            const WPEFramework::Core::JSONRPC::Message *jsonRpcMessage = dynamic_cast<const WPEFramework::Core::JSONRPC::Message *>(message.operator->());
-            std::unique_ptr<JsonEngine> jsonEngine = std::make_unique<JsonEngine>();
-            jsonEngine->MockRequest(jsonRpcMessage);
-        }
-#else
-
         void Submit(const WPEFramework::Core::ProxyType<INTERFACE> &message)
         {
-            _channel.Submit(message);
+            _link->Submit(message);
         }
-#endif
         bool IsSuspended() const
         {
-            return (_channel.IsSuspended());
+            return (_link->IsSuspended());
         }
         uint32_t Initialize()
         {
             return (Open(0));
         }
+        // Instance() only opens a channel it creates. One that closed while a transport it is
+        // replaced by still held on to it, has to be opened again by the new one.
+        void Reopen()
+        {
+            Open(0);
+        }
         void Deinitialize()
         {
             Close();
         }
 
-// Always return true for unit testing
-#ifdef UNIT_TEST
         bool IsOpen()
         {
-            return true;
+            return (_link->IsOpen());
         }
-        
-#else
-        bool IsOpen()
+        // JSONProtocol or MessagePackProtocol
+        const TCHAR *Protocol() const
         {
-            return (_channel.IsOpen() == true);
+            return (_link->Protocol());
         }
-#endif
-        
+
     protected:
         void StateChange()
         {
             _adminLock.Lock();
-            typename std::list<CLIENT *>::iterator index(_observers.begin());
+            typename std::list<CLIENT *>::iterator index(_link->Changed() == true ? _observers.begin() : _observers.end());
             while (index != _observers.end())
             {
-                if (_channel.IsOpen() == true)
+                if (_link->IsOpen() == true)
                 {
                     (*index)->Opened();
                 }
@@ -452,29 +835,26 @@ namespace FireboltSDK
             _adminLock.Unlock();
         }
 
-// Always return true for unit testing       
-#ifdef UNIT_TEST
         bool Open(const uint32_t waitTime)
         {
-            return true;
+            return (_link->Open(waitTime));
         }
-#else
-        bool Open(const uint32_t waitTime)
-        {
-            bool result = true;
-            if (_channel.IsClosed() == true) {
-                result = (_channel.Open(waitTime) == WPEFramework::Core::ERROR_NONE);
-            }
-            return (result);
-        }
-        
-#endif
         void Close()
         {
-            _channel.Close(WPEFramework::Core::infinite);
+            _link->Close();
         }
 
     private:
+        // JSON channels speak JSON, MessagePack ones negotiate
+        static ILink *Link(const WPEFramework::Core::JSON::IElement *, CommunicationChannel *parent, const WPEFramework::Core::NodeId &remoteNode, const string &path, const string &query, const bool mask)
+        {
+            return (new SocketLink<WPEFramework::Core::JSON::IElement>(parent, remoteNode, path, query, mask));
+        }
+        static ILink *Link(const WPEFramework::Core::JSON::IMessagePack *, CommunicationChannel *parent, const WPEFramework::Core::NodeId &remoteNode, const string &path, const string &query, const bool mask)
+        {
+            return (new NegotiatedLink(parent, remoteNode, path, query, mask));
+        }
+
         int32_t Inbound(const WPEFramework::Core::ProxyType<MESSAGETYPE> &inbound)
         {
             int32_t result = WPEFramework::Core::ERROR_UNAVAILABLE;
@@ -492,7 +872,7 @@ namespace FireboltSDK
 
     private:
         WPEFramework::Core::CriticalSection _adminLock;
-        ChannelImpl _channel;
+        std::unique_ptr<ILink> _link;
         mutable std::atomic<uint32_t> _sequence;
         std::list<CLIENT *> _observers;
     };
@@ -511,15 +891,32 @@ namespace FireboltSDK
     private:
         using Channel = CommunicationChannel<WPEFramework::Core::SocketStream, INTERFACE, Transport, WPEFramework::Core::JSONRPC::Message>;
         using Entry = typename CommunicationChannel<WPEFramework::Core::SocketStream, INTERFACE, Transport, WPEFramework::Core::JSONRPC::Message>::Entry;
-        using PendingMap = std::unordered_map<uint32_t, Entry>;
-        using EventMap = std::map<string, uint32_t>;
+        using PendingMap = PendingTable<Entry>;
+        // Event notifications carry the id of the request that subscribed to them
+
+        // A call in progress that identical calls can wait for, see InvokeCoalesced
+        struct Flight {
+            Flight(const uint64_t deadline)
+                : done(false, false) // manual reset, every waiter wakes up
+                , deadline(deadline)
+                , status(Firebolt::Error::General)
+                , result()
+            {
+            }
+
+            WPEFramework::Core::Event done;
+            const uint64_t deadline; // the leader gives up on its response by then
+            Firebolt::Error status;
+            string result;
+        };
+        using FlightMap = std::unordered_map<string, std::shared_ptr<Flight>>;
         typedef std::function<uint32_t(const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &jsonResponse, bool &enabled)> EventResponseValidatioionFunction;
 
-        class CommunicationJob : public WPEFramework::Core::IDispatch
+        class CommunicationJob : public WPEFramework::Core::IDispatch, public IUrgent
         {
         protected:
-            CommunicationJob(const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &inbound, class Transport *parent)
-                : _inbound(inbound), _parent(parent)
+            CommunicationJob(const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &inbound, class Transport *parent, const bool urgent = false)
+                : _inbound(inbound), _parent(parent), _urgent(urgent), _queued(Tracer::Now())
             {
             }
 
@@ -535,12 +932,25 @@ namespace FireboltSDK
 
             void Dispatch() override
             {
+                const uint64_t now = Tracer::Now();
+                Statistics::Instance().Queued((now - _queued) / 1000);
+                if (Tracer::IsEnabled() == true)
+                {
+                    Tracer::Record(Tracer::Phase::Queue, _inbound->Id.Value(), nullptr, _queued);
+                }
                 _parent->Inbound(_inbound);
             }
 
+            bool IsUrgent() const override
+            {
+                return _urgent;
+            }
+
         private:
             const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> _inbound;
             class Transport *_parent;
+            const bool _urgent;
+            const uint64_t _queued;
         };
 
         class ConnectionJob : public WPEFramework::Core::IDispatch
@@ -586,54 +996,85 @@ namespace FireboltSDK
         static constexpr const TCHAR *PathPrefix = _T("/");
 
     public:
+        // The url schemes besides ws://, for a unix socket and for the in-process responder
+        static constexpr const TCHAR *UnixScheme = _T("unix://");
+        static constexpr const TCHAR *LoopbackScheme = _T("loopback://");
+
+        using Responder = typename Channel::Responder;
         typedef std::function<void(const bool connected, const Firebolt::Error error)> Listener;
+        typedef std::function<void(const Firebolt::Error status, const WPEFramework::Core::JSONRPC::Message &response)> AsyncCallback;
+
+        // One call of an InvokeBatch; response must stay valid until the batch returns
+        struct BatchRequest {
+            string method;
+            string parameters;
+            INTERFACE* response;
+            Firebolt::Error status;
+        };
 
     public:
         Transport() = delete;
         Transport(const Transport &) = delete;
         Transport &operator=(Transport &) = delete;
         Transport(const WPEFramework::Core::URL &url, const uint32_t waitTime, const Listener listener)
-            : _adminLock(), _connectId(WPEFramework::Core::NodeId(url.Host().Value().c_str(), url.Port().Value())), _channel(Channel::Instance(_connectId, ((url.Path().Value().rfind(PathPrefix, 0) == 0) ? url.Path().Value() : string(PathPrefix + url.Path().Value())), url.Query().Value(), true)), _eventHandler(nullptr), _pendingQueue(), _scheduledTime(0), _waitTime(waitTime), _listener(listener), _connected(false), _status(Firebolt::Error::NotConnected)
+            : Transport(WPEFramework::Core::NodeId(url.Host().Value().c_str(), url.Port().Value()), ((url.Path().Value().rfind(PathPrefix, 0) == 0) ? url.Path().Value() : string(PathPrefix + url.Path().Value())), url.Query().Value(), waitTime, listener)
+        {
+        }
+        // Also takes unix://<socket path>[?query], for an endpoint on the same host. It speaks
+        // the same websocket protocol, only without the TCP/IP stack underneath.
+        // And loopback://, to have requests answered in process by the responder set with Loopback().
+        Transport(const string &url, const uint32_t waitTime, const Listener listener)
+            : Transport((IsLoopback(url) == true ? Channel::Loopback(LoopbackResponder()) : Channel::Instance(Endpoint(url), Resource(url), Query(url), true)), Endpoint(url), waitTime, listener)
+        {
+        }
+        Transport(const WPEFramework::Core::NodeId &endpoint, const string &path, const string &query, const uint32_t waitTime, const Listener listener)
+            : Transport(Channel::Instance(endpoint, path, query, true), endpoint, waitTime, listener)
+        {
+        }
+        // No server at all: every request is answered by responder, on the thread that sends it
+        Transport(const Responder &responder, const uint32_t waitTime, const Listener listener)
+            : Transport(Channel::Loopback(responder), WPEFramework::Core::NodeId(), waitTime, listener)
+        {
+        }
+
+    private:
+        Transport(const WPEFramework::Core::ProxyType<Channel> &channel, const WPEFramework::Core::NodeId &endpoint, const uint32_t waitTime, const Listener listener)
+            : _adminLock(), _connectId(endpoint), _channel(channel), _eventHandler(nullptr), _pendingQueue(), _timers(), _events(), _flightLock(), _flights(), _scheduledTime(0), _waitTime(waitTime), _listener(listener), _connected(false), _status(Firebolt::Error::NotConnected), _linkReady(false, true), _connectionJob()
         {
             _channel->Register(*this);
-            WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> job = WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>(WPEFramework::Core::ProxyType<Transport::ConnectionJob>::Create(this));
-            WPEFramework::Core::IWorkerPool::Instance().Submit(job);
+            _channel->Reopen();
+            _connectionJob = WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>(WPEFramework::Core::ProxyType<Transport::ConnectionJob>::Create(this));
+            WPEFramework::Core::IWorkerPool::Instance().Submit(_connectionJob);
         }
 
+    public:
         virtual ~Transport()
         {
+            // It refers to us, do not let it outlive us
+            WPEFramework::Core::IWorkerPool::Instance().Revoke(_connectionJob);
+            _connectionJob.Release();
+
             _channel->Unregister(*this);
 
-            for (auto &element : _pendingQueue)
-            {
-                element.second.Abort(element.first);
-            }
+            AbortAll();
         }
 
     public:
 
-// Always return true for unit testing
-#ifdef UNIT_TEST
-        inline bool IsOpen()
-        {
-            return true;
-        }
-#else
         inline bool IsOpen()
         {
             return _channel->IsOpen();
         } 
-#endif
 
-        void Revoke(const string &eventName)
+        // The encoding settled on with the other side, MessagePack transports may fall back to JSON
+        inline const TCHAR *Protocol() const
         {
-            _adminLock.Lock();
-            // Remove from internal event map
-            _internalEventMap.erase(eventName);
+            return _channel->Protocol();
+        }
 
-            // Remove from external event map
-            _externalEventMap.erase(eventName);
-            _adminLock.Unlock();
+        void Revoke(const string &eventName)
+        {
+            _events.Remove(eventName);
         }
 
         void SetEventHandler(IEventHandler *eventHandler)
@@ -641,28 +1082,29 @@ namespace FireboltSDK
             _eventHandler = eventHandler;
         }
 
-// Invoke method is overriden for unit testing to call MockResponse method from JSON engine
-#ifdef UNIT_TEST
-        template <typename PARAMETERS, typename RESPONSE>
-        Firebolt::Error Invoke(const string &method, const PARAMETERS &parameters, RESPONSE &response)
+        // Takes message in as if the other side had sent it, e.g. an event notification
+        // a loopback responder makes up
+        void Deliver(const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &message)
         {
-            Entry slot;
-            uint32_t id = _channel->Sequence();
-            Firebolt::Error result = Send(method, parameters, id);
+            Submit(message);
+        }
 
-            WPEFramework::Core::JSONRPC::Message message;
-            message.Designator = method;
-            std::unique_ptr<JsonEngine> jsonEngine = std::make_unique<JsonEngine>();
-            result = jsonEngine->MockResponse(message, response);
-            FromMessage((INTERFACE *)&response, message);
-            return (result);
+        // The id the next request will go out with. Taken up front by callers that trace
+        // work for a request before it is sent, they pass it on to Invoke.
+        uint32_t Sequence()
+        {
+            return _channel->Sequence();
         }
-#else
+
         template <typename PARAMETERS, typename RESPONSE>
         Firebolt::Error Invoke(const string& method, const PARAMETERS& parameters, RESPONSE& response)
         {
-            Entry slot;
-            uint32_t id = _channel->Sequence();
+            return (Invoke(method, parameters, response, _channel->Sequence()));
+        }
+
+        template <typename PARAMETERS, typename RESPONSE>
+        Firebolt::Error Invoke(const string& method, const PARAMETERS& parameters, RESPONSE& response, const uint32_t id)
+        {
             Firebolt::Error result = Send(method, parameters, id);
             if (result == Firebolt::Error::None) {
                 result = WaitForResponse<RESPONSE>(id, response, _waitTime);
@@ -670,82 +1112,232 @@ namespace FireboltSDK
 
             return (result);
         }
-#endif
+
+        // Single flight: while a call is on the wire, identical calls (same method, same
+        // parameters) wait for its outcome instead of sending their own request.
+        // Only meant for reads without side effects.
+        template <typename PARAMETERS, typename RESPONSE>
+        Firebolt::Error InvokeCoalesced(const string& method, const PARAMETERS& parameters, RESPONSE& response)
+        {
+            return (InvokeCoalesced(method, parameters, response, _channel->Sequence()));
+        }
+
+        // id is only used when this call is the one that goes out
+        template <typename PARAMETERS, typename RESPONSE>
+        Firebolt::Error InvokeCoalesced(const string& method, const PARAMETERS& parameters, RESPONSE& response, const uint32_t id)
+        {
+            static_assert(std::is_base_of<INTERFACE, RESPONSE>::value, "The response is shared as the text of an INTERFACE");
+
+            string key;
+            ToParameters(parameters, key);
+            key.insert(0, method + '\n');
+
+            std::shared_ptr<Flight> flight;
+            bool leader = false;
+
+            _flightLock.Lock();
+            typename FlightMap::iterator index = _flights.find(key);
+            if (index == _flights.end()) {
+                flight = std::make_shared<Flight>(Deadline());
+                _flights.emplace(key, flight);
+                leader = true;
+            } else {
+                flight = index->second;
+            }
+            _flightLock.Unlock();
+
+            Firebolt::Error result = Firebolt::Error::Timedout;
+            if (leader == true) {
+                // The followers wait for the same deadline
+                const uint32_t waitTime = Remaining(flight->deadline);
+                result = Send(method, parameters, id);
+                if (result == Firebolt::Error::None) {
+                    result = WaitForResponse<RESPONSE>(id, response, waitTime);
+                }
+                if (result == Firebolt::Error::None) {
+                    ToResult(static_cast<const INTERFACE*>(&response), flight->result);
+                }
+                flight->status = result;
+
+                // Calls from here on are a new flight, they may see a newer value
+                _flightLock.Lock();
+                _flights.erase(key);
+                _flightLock.Unlock();
+
+                flight->done.SetEvent();
+            } else if (flight->done.Lock(Remaining(flight->deadline)) == WPEFramework::Core::ERROR_NONE) { // no longer than the leader waits
+                result = flight->status;
+                if (result == Firebolt::Error::None) {
+                    FromResult(static_cast<INTERFACE*>(&response), flight->result);
+                }
+            }
+
+            return (result);
+        }
 
         template <typename PARAMETERS>
         Firebolt::Error InvokeAsync(const string &method, const PARAMETERS &parameters, uint32_t &id)
         {
-            Entry slot;
             id = _channel->Sequence();
             return Send(method, parameters, id);
         }
 
-        template <typename RESPONSE>
-        Firebolt::Error WaitForResponse(const uint32_t& id, RESPONSE& response, const uint32_t waitTime)
+        // Completely non-blocking: completed is called from the thread that receives the
+        // response, or from the watchdog once waitTime passed without one.
+        template <typename PARAMETERS>
+        Firebolt::Error InvokeAsync(const string &method, const PARAMETERS &parameters, const AsyncCallback &completed, const uint32_t waitTime, uint32_t &id)
         {
-            int32_t result = WPEFramework::Core::ERROR_TIMEDOUT;
-            _adminLock.Lock();
-            typename PendingMap::iterator index = _pendingQueue.find(id);
-            Entry& slot(index->second);
-            _adminLock.Unlock();
+            id = _channel->Sequence();
+            return (Call(method, parameters, completed, waitTime, id));
+        }
 
-            if (slot.WaitForResponse(waitTime) == true) {
-                WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> jsonResponse = slot.Response();
+        template <typename PARAMETERS>
+        Firebolt::Error InvokeAsync(const string &method, const PARAMETERS &parameters, const AsyncCallback &completed)
+        {
+            return (Call(method, parameters, completed, _waitTime, _channel->Sequence()));
+        }
 
-                // See if we have a jsonResponse, maybe it was just the connection
-                // that closed?
-                if (jsonResponse.IsValid() == true) {
-                    if (jsonResponse->Error.IsSet() == true) {
-                        result = jsonResponse->Error.Code.Value();
-                    }
-                    else {
-                        result = WPEFramework::Core::ERROR_NONE;
-                        if ((jsonResponse->Result.IsSet() == true)
-                            && (jsonResponse->Result.Value().empty() == false)) {
-                            FromMessage((INTERFACE*)&response, *jsonResponse);
-                        }
-                    }
+        // With an id taken from Sequence()
+        template <typename PARAMETERS>
+        Firebolt::Error InvokeAsync(const string &method, const PARAMETERS &parameters, const AsyncCallback &completed, const uint32_t id)
+        {
+            return (Call(method, parameters, completed, _waitTime, id));
+        }
+
+    private:
+        template <typename PARAMETERS>
+        Firebolt::Error Call(const string &method, const PARAMETERS &parameters, const AsyncCallback &completed, const uint32_t waitTime, const uint32_t id)
+        {
+            typename Channel::Callback callback = [this, completed](const INTERFACE &response) {
+                const WPEFramework::Core::JSONRPC::Message &message = static_cast<const WPEFramework::Core::JSONRPC::Message &>(response);
+                completed((message.Error.IsSet() == true ? FireboltErrorValue(message.Error.Code.Value()) : Firebolt::Error::None), message);
+            };
+
+            Firebolt::Error result = Send(method, parameters, id, waitTime, callback);
+            if (result == Firebolt::Error::None) {
+                const uint64_t expiry = WPEFramework::Core::Time::Now().Add(waitTime).Ticks();
+                const TimerWheel<>::Handle timer = _timers.Arm(id, expiry);
+                // If the response beat us to it, nobody else is left to cancel the timer
+                if (_pendingQueue.Visit(id, [timer](Entry& slot) { slot.Armed(timer); }) == false) {
+                    _timers.Cancel(timer, id);
+                }
+                Schedule(expiry);
+            }
+            return (result);
+        }
+
+    public:
+        // Send all requests back to back, then collect the responses against one shared
+        // deadline, so a batch costs a single round trip instead of one per request.
+        // Returns the first failure, each request carries its own status.
+        Firebolt::Error InvokeBatch(std::vector<BatchRequest>& batch)
+        {
+            Firebolt::Error result = Firebolt::Error::None;
+            std::vector<uint32_t> ids(batch.size(), 0);
+
+            for (uint32_t index = 0; index < batch.size(); ++index) {
+                ids[index] = _channel->Sequence();
+                batch[index].status = Send(batch[index].method, batch[index].parameters, ids[index]);
+            }
+
+            const uint64_t deadline = Deadline();
+            for (uint32_t index = 0; index < batch.size(); ++index) {
+                BatchRequest& request = batch[index];
+                ASSERT(request.response != nullptr);
+                if (request.status == Firebolt::Error::None) {
+                    request.status = WaitForResponse(ids[index], *request.response, Remaining(deadline));
+                } else {
+                    _pendingQueue.Remove(ids[index]);
+                }
+                if ((request.status != Firebolt::Error::None) && (result == Firebolt::Error::None)) {
+                    result = request.status;
+                }
+            }
+
+            return (result);
+        }
+
+        template <typename RESPONSE>
+        Firebolt::Error WaitForResponse(const uint32_t& id, RESPONSE& response, const uint32_t waitTime)
+        {
+            WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> jsonResponse;
+            const string *text = nullptr;
+            const char *method = nullptr;
+            int32_t result = Collect(id, waitTime, jsonResponse, text, method);
+
+            // See if we have a jsonResponse, maybe it was just the connection
+            // that closed?
+            if (result == WPEFramework::Core::ERROR_NONE) {
+                if (jsonResponse.IsValid() == false) {
+                    result = WPEFramework::Core::ERROR_TIMEDOUT;
+                }
+                else if (jsonResponse->Error.IsSet() == true) {
+                    result = jsonResponse->Error.Code.Value();
+                }
+                else if ((text != nullptr) && (text->empty() == false)) {
+                    Tracer::Span deserialize(Tracer::Phase::Deserialize, id, method);
+                    FromResult((INTERFACE*)&response, *text);
                 }
-            } else {
-                result = WPEFramework::Core::ERROR_TIMEDOUT;
             }
-            _adminLock.Lock();
-            _pendingQueue.erase(id);
-            _adminLock.Unlock();
             return FireboltErrorValue(result);
         }
 
         void Abort(uint32_t id)
         {
-            _adminLock.Lock();
-            typename PendingMap::iterator index = _pendingQueue.find(id);
-            Entry &slot(index->second);
-            _adminLock.Unlock();
-            slot.Abort(id);
+            // A synchronous entry is owned by its waiter, which removes it once woken up
+            bool synchronous = true;
+            _pendingQueue.Visit(id, [&](Entry& slot) {
+                synchronous = slot.IsSynchronous();
+                if (synchronous == true) {
+                    slot.Abort(id);
+                }
+            });
+            if (synchronous == false) {
+                _pendingQueue.Remove(id, [this, id](Entry& slot) {
+                    _timers.Cancel(slot.Timer(), id);
+                    slot.Abort(id);
+                });
+            }
         }
 
         template <typename RESPONSE>
         Firebolt::Error Subscribe(const string& eventName, const string& parameters, RESPONSE& response, bool updateInternal = false)
         {
-            Entry slot;
-            uint32_t id = _channel->Sequence();
-            Firebolt::Error result = Send(eventName, parameters, id);
+            uint32_t id;
+            Firebolt::Error result = SubscribeAsync(eventName, parameters, id);
 
             if (result == Firebolt::Error::None) {
-                _adminLock.Lock();
-                
-                // Choose the map based on updateInternal flag
-                EventMap& eventMap = updateInternal ? _internalEventMap : _externalEventMap;
+                result = WaitForSubscription(id, eventName, response, _waitTime);
+            }
+
+            return result;
+        }
 
-                // Add to the selected event map
-                eventMap.emplace(std::piecewise_construct,
-                                std::forward_as_tuple(eventName),
-                                std::forward_as_tuple(id));
+        // First half of a subscription, so several can be sent before waiting for any of them
+        Firebolt::Error SubscribeAsync(const string& eventName, const string& parameters, uint32_t& id)
+        {
+            // Prioritizing internal subscribers is up to the event handler, here every
+            // subscription just maps its id to the event name.
+            id = _channel->Sequence();
 
-                _adminLock.Unlock();
+            _events.Add(id, eventName, parameters);
 
-                result = WaitForEventResponse(id, eventName, response, _waitTime, eventMap);
-              
+            Firebolt::Error result = Send(eventName, parameters, id);
+            if (result != Firebolt::Error::None) {
+                _pendingQueue.Remove(id);
+                _events.Remove(id);
+            }
+
+            return result;
+        }
+
+        template <typename RESPONSE>
+        Firebolt::Error WaitForSubscription(const uint32_t id, const string& eventName, RESPONSE& response, const uint32_t waitTime)
+        {
+            Firebolt::Error result = WaitForEventResponse(id, eventName, response, waitTime);
+
+            if (result != Firebolt::Error::None) {
+                _events.Remove(id);
             }
 
             return result;
@@ -754,10 +1346,39 @@ namespace FireboltSDK
         Firebolt::Error Unsubscribe(const string &eventName, const string &parameters)
         {
             Revoke(eventName);
-            Entry slot;
+            return (Stop(eventName, parameters));
+        }
+
+        // Only stops the one subscription, the one started by request, others to the same
+        // event go on
+        Firebolt::Error Unsubscribe(const string &eventName, const string &parameters, const string &request)
+        {
+            _events.Remove(eventName, request);
+            return (Stop(eventName, parameters));
+        }
+
+    private:
+        Firebolt::Error Stop(const string &eventName, const string &parameters)
+        {
             uint32_t id = _channel->Sequence();
 
-            return Send(eventName, parameters, id);
+            Firebolt::Error result = Send(eventName, parameters, id);
+            // Nobody waits for the acknowledgement, do not let the entry occupy a slot
+            _pendingQueue.Remove(id);
+            return result;
+        }
+
+    public:
+        // Several waits sharing one wait time: take the deadline once, then wait for what remains of it
+        uint64_t Deadline() const
+        {
+            return (WPEFramework::Core::Time::Now().Add(_waitTime).Ticks());
+        }
+
+        static uint32_t Remaining(const uint64_t deadline)
+        {
+            const uint64_t now = WPEFramework::Core::Time::Now().Ticks();
+            return (now < deadline ? static_cast<uint32_t>((deadline - now) / WPEFramework::Core::Time::TicksPerMillisecond) : 0);
         }
 
         void NotifyStatus(Firebolt::Error status)
@@ -767,83 +1388,146 @@ namespace FireboltSDK
 
         Firebolt::Error WaitForLinkReady()
         {
-            uint32_t waiting = _waitTime;
-            static constexpr uint32_t SLEEPSLOT_TIME = 100;
-
-            // Right, a wait till connection is closed is requested..
-            while ((waiting > 0) && (IsOpen() == false) && (_status == Firebolt::Error::NotConnected))
-            {
-
-                uint32_t sleepSlot = (waiting > SLEEPSLOT_TIME ? SLEEPSLOT_TIME : waiting);
+            // Opened() and Closed() both wake us up, only an open link counts as ready
+            if (IsOpen() == false) {
+                _linkReady.Lock(_waitTime);
+            }
+            return ((IsOpen() == true) ? Firebolt::Error::None : Firebolt::Error::Timedout);
+        }
 
-                // Right, lets sleep in slices of 100 ms
-                SleepMs(sleepSlot);
+    public:
+        // The responder for transports created with a loopback:// url; set it before creating them
+        static void Loopback(const Responder &responder)
+        {
+            LoopbackResponder() = responder;
+        }
 
-                waiting -= (waiting == WPEFramework::Core::infinite ? 0 : sleepSlot);
+    private:
+        static Responder &LoopbackResponder()
+        {
+            static Responder responder;
+            return (responder);
+        }
+        static bool IsUnixDomain(const string &url)
+        {
+            return (url.compare(0, ::strlen(UnixScheme), UnixScheme) == 0);
+        }
+        static bool IsLoopback(const string &url)
+        {
+            return (url.compare(0, ::strlen(LoopbackScheme), LoopbackScheme) == 0);
+        }
+        static WPEFramework::Core::NodeId Endpoint(const string &url)
+        {
+            WPEFramework::Core::NodeId result;
+            if (IsLoopback(url) == true) {
+                // Nothing to connect to
+            } else if (IsUnixDomain(url) == true) {
+                // A NodeId starting with a '/' is a unix domain socket
+                const string path = url.substr(::strlen(UnixScheme));
+                result = WPEFramework::Core::NodeId(path.substr(0, path.find('?')).c_str());
+            } else {
+                WPEFramework::Core::URL parsed(url);
+                result = WPEFramework::Core::NodeId(parsed.Host().Value().c_str(), parsed.Port().Value());
+            }
+            return (result);
+        }
+        static string Resource(const string &url)
+        {
+            string result = PathPrefix;
+            if (IsUnixDomain(url) == false) {
+                WPEFramework::Core::URL parsed(url);
+                result = ((parsed.Path().Value().rfind(PathPrefix, 0) == 0) ? parsed.Path().Value() : string(PathPrefix + parsed.Path().Value()));
+            }
+            return (result);
+        }
+        static string Query(const string &url)
+        {
+            string result;
+            if (IsUnixDomain(url) == true) {
+                const size_t index = url.find('?');
+                if (index != string::npos) {
+                    result = url.substr(index + 1);
+                }
+            } else {
+                result = WPEFramework::Core::URL(url).Query().Value();
             }
-            return (((waiting == 0) || (IsOpen() == true)) ? Firebolt::Error::None : Firebolt::Error::Timedout);
+            return (result);
         }
 
     private:
         friend Channel;
+        // Once per notification, without a lock
         inline bool IsEvent(const uint32_t id, string& eventName)
         {
-            _adminLock.Lock();
-            
-            bool eventExist = false;
-
-            // List of maps to search
-            std::vector<EventMap*> maps = {&_internalEventMap, &_externalEventMap};
-
-            // Loop through each map
-            for (const auto* map : maps) {
-                for (const auto& event : *map) {
-                    if (event.second == id) {
-                        eventName = event.first;
-                        eventExist = true;
-                        break; // Break the inner loop
-                    }
-                }
-                if (eventExist) {
-                    break; // Break the outer loop
-                }
-            }
-
-            _adminLock.Unlock();
-            return eventExist;
+            return (_events.Find(id, eventName));
         }
         uint64_t Timed()
         {
-            uint64_t result = ~0;
+            std::vector<uint32_t> due;
             uint64_t currentTime = WPEFramework::Core::Time::Now().Ticks();
 
-            // Lets see if some callback are expire. If so trigger and remove...
+            // Requests sent while we are collecting arm a timer of their own
             _adminLock.Lock();
+            _scheduledTime = 0;
+            _adminLock.Unlock();
 
-            typename PendingMap::iterator index = _pendingQueue.begin();
-
-            while (index != _pendingQueue.end())
-            {
+            uint64_t result = _timers.Advance(currentTime, due);
 
-                if (index->second.Expired(index->first, currentTime, result) == true)
-                {
-                    index = _pendingQueue.erase(index);
-                }
-                else
-                {
-                    index++;
+            // Completed requests cancel their timer, but one may just be completing now
+            for (const uint32_t id : due) {
+                bool expired = false;
+                _pendingQueue.Visit(id, [&](Entry& slot) {
+                    uint64_t nextTime = ~0;
+                    expired = slot.Expired(currentTime, nextTime);
+                });
+                if (expired == true) {
+                    // Competes with Inbound(), whoever removes the entry completes it
+                    _pendingQueue.Remove(id, [id](Entry& slot) { slot.Expire(id); });
                 }
             }
-            _scheduledTime = (result != static_cast<uint64_t>(~0) ? result : 0);
 
+            _adminLock.Lock();
+            if ((result != 0) && ((_scheduledTime == 0) || (result < _scheduledTime))) {
+                _scheduledTime = result;
+            } else {
+                result = 0;
+            }
             _adminLock.Unlock();
 
-            return (_scheduledTime);
+            return (result);
+        }
+
+        void Schedule(const uint64_t expiry)
+        {
+            _adminLock.Lock();
+            if ((_scheduledTime == 0) || (expiry < _scheduledTime)) {
+                _scheduledTime = expiry;
+                Channel::Trigger(expiry, this);
+            }
+            _adminLock.Unlock();
+        }
+
+        void AbortAll()
+        {
+            // Wake up the synchronous waiters, they clean up their own entry. The a-synchronous
+            // ones are completed here and removed.
+            _pendingQueue.ForEach(
+                [](const uint32_t id, Entry& slot) {
+                    if (slot.IsSynchronous() == true) {
+                        slot.Abort(id);
+                    }
+                    return (slot.IsSynchronous() == false);
+                },
+                [this](const uint32_t id, Entry& slot) {
+                    _timers.Cancel(slot.Timer(), id);
+                    slot.Abort(id);
+                });
         }
 
         virtual void Opened()
         {
             _status = Firebolt::Error::None;
+            _linkReady.SetEvent();
             if (_connected != true)
             {
                 _connected = true;
@@ -854,17 +1538,9 @@ namespace FireboltSDK
         void Closed()
         {
             // Abort any in progress RPC command:
-            _adminLock.Lock();
-
-            // See if we issued anything, if so abort it..
-            while (_pendingQueue.size() != 0)
-            {
+            AbortAll();
+            _linkReady.SetEvent();
 
-                _pendingQueue.begin()->second.Abort(_pendingQueue.begin()->first);
-                _pendingQueue.erase(_pendingQueue.begin());
-            }
-
-            _adminLock.Unlock();
             if (_connected != false)
             {
                 _connected = false;
@@ -875,8 +1551,25 @@ namespace FireboltSDK
         int32_t Submit(const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &inbound)
         {
             int32_t result = WPEFramework::Core::ERROR_UNAVAILABLE;
-            WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> job = WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>(WPEFramework::Core::ProxyType<Transport::CommunicationJob>::Create(inbound, this));
-            WPEFramework::Core::IWorkerPool::Instance().Submit(job);
+            bool handled = false;
+            bool urgent = false;
+
+            if ((inbound->Id.IsSet() == true) && (inbound->Result.IsSet() || inbound->Error.IsSet())) {
+                // A caller blocked on this response only needs a signal, give it right here on the
+                // receive thread. Completing an a-synchronous call runs app code, that still goes
+                // to the worker pool, but ahead of queued notifications.
+                urgent = _pendingQueue.Visit(inbound->Id.Value(), [&](Entry& slot) {
+                    if (slot.IsSynchronous() == true) {
+                        slot.Signal(inbound);
+                        handled = true;
+                    }
+                });
+            }
+
+            if (handled == false) {
+                WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> job = WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>(WPEFramework::Core::ProxyType<Transport::CommunicationJob>::Create(inbound, this, urgent));
+                WPEFramework::Core::IWorkerPool::Instance().Submit(job);
+            }
             return 0;
         }
 
@@ -892,25 +1585,31 @@ namespace FireboltSDK
                 ASSERT(inbound->Parameters.IsSet() == false);
                 ASSERT(inbound->Designator.IsSet() == false);
 
-                _adminLock.Lock();
+                const uint32_t id = inbound->Id.Value();
 
                 // See if we issued this..
-                typename PendingMap::iterator index = _pendingQueue.find(inbound->Id.Value());
+                bool synchronous = true;
+                bool pending = _pendingQueue.Visit(id, [&](Entry& slot) {
+                    synchronous = slot.IsSynchronous();
+                    if (synchronous == true) {
+                        slot.Signal(inbound);
+                    }
+                });
 
-                if (index != _pendingQueue.end())
+                if (pending == true)
                 {
-
-                    if (index->second.Signal(inbound) == true)
+                    if (synchronous == false)
                     {
-                        _pendingQueue.erase(index);
+                        // Competes with Timed(), whoever removes the entry completes it
+                        _pendingQueue.Remove(id, [&](Entry& slot) {
+                            _timers.Cancel(slot.Timer(), id);
+                            slot.Signal(inbound);
+                        });
                     }
-
                     result = WPEFramework::Core::ERROR_NONE;
-                    _adminLock.Unlock();
                 }
                 else
                 {
-                    _adminLock.Unlock();
                     string eventName;
                     if (IsEvent(inbound->Id.Value(), eventName))
                     {
@@ -922,8 +1621,8 @@ namespace FireboltSDK
             return (result);
         }
 
-        template <typename PARAMETERS>
-        Firebolt::Error Send(const string &method, const PARAMETERS &parameters, const uint32_t &id)
+        template <typename PARAMETERS, typename... ENTRYARGS>
+        Firebolt::Error Send(const string &method, const PARAMETERS &parameters, const uint32_t &id, ENTRYARGS&&... entryArgs)
         {
             int32_t result = WPEFramework::Core::ERROR_UNAVAILABLE;
 
@@ -936,24 +1635,25 @@ namespace FireboltSDK
 
                 result = WPEFramework::Core::ERROR_ASYNC_FAILED;
 
+                Tracer::Span send(Tracer::Phase::Send, id, method);
+
                 WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> message(Channel::Message());
                 message->Id = id;
                 message->Designator = method;
-                ToMessage(parameters, message);
+                const uint32_t length = ToMessage(parameters, message);
 
-                _adminLock.Lock();
-
-                typename std::pair<typename PendingMap::iterator, bool> newElement =
-                    _pendingQueue.emplace(std::piecewise_construct,
-                                          std::forward_as_tuple(id),
-                                          std::forward_as_tuple());
-                ASSERT(newElement.second == true);
-
-                if (newElement.second == true)
+                // Only fails for an id that is reserved or still in flight
+                if (_pendingQueue.Insert(id, std::forward<ENTRYARGS>(entryArgs)...) == nullptr)
                 {
-
-                    _adminLock.Unlock();
-
+                    result = WPEFramework::Core::ERROR_GENERAL;
+                }
+                else
+                {
+                    // Pinned, as a connection closing right now may already abort it
+                    _pendingQueue.Visit(id, [&](Entry& entry) {
+                        entry.Sent(Statistics::Instance().Find(method), static_cast<uint32_t>(method.size()) + length);
+                    });
+                    Tracer::Submitted(id);
                     _channel->Submit(WPEFramework::Core::ProxyType<INTERFACE>(message));
 
                     message.Release();
@@ -962,126 +1662,201 @@ namespace FireboltSDK
             }
             return FireboltErrorValue(result);
         }
-#ifdef UNIT_TEST
-template <typename RESPONSE>
-        Firebolt::Error WaitForEventResponse(const uint32_t &id, const string &eventName, RESPONSE &response, const uint32_t waitTime, EventMap& _eventMap)
-        {
-            std::cout << "Inside Mock Transport WaitForEventResponse function" << std::endl;
-            std::cout << "Mock Transport WaitForEventResponse eventName: " << eventName << std::endl;
-            /*  Since there is no return value for event subscription, error would be the only validation for now.
-                Returning a mock event response from open rpc would mean that the logic in WaitForEventResponse to check a queue is not used.
-                At which point, the function would no longer be validating the SDK functionality.
-                If the queue find functionality is to be tested, the _pendingQueue could be mocked in upcoming iterations.
-            */
-            return Firebolt::Error::None;
-        }
-#else
-        static constexpr uint32_t WAITSLOT_TIME = 100;
         template <typename RESPONSE>
-        Firebolt::Error WaitForEventResponse(const uint32_t &id, const string &eventName, RESPONSE &response, const uint32_t waitTime, EventMap& _eventMap)
+        Firebolt::Error WaitForEventResponse(const uint32_t &id, const string &eventName, RESPONSE &response, const uint32_t waitTime)
         {
-            std::cout << "Inside Transport WaitForEventResponse function" << std::endl;
-            Firebolt::Error result = Firebolt::Error::Timedout;
-            _adminLock.Lock();
-            typename PendingMap::iterator index = _pendingQueue.find(id);
-            Entry &slot(index->second);
-            _adminLock.Unlock();
+            Firebolt::Error result = Firebolt::Error::General;
 
-            uint8_t waiting = waitTime;
-            do
+            WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> jsonResponse;
+            const string *text = nullptr;
+            const char *method = nullptr;
+            const uint32_t collected = Collect(id, waitTime, jsonResponse, text, method);
+            if (collected != WPEFramework::Core::ERROR_GENERAL)
             {
-                uint32_t waitSlot = (waiting > WAITSLOT_TIME ? WAITSLOT_TIME : waiting);
-                if (slot.WaitForResponse(waitSlot) == true)
-                {
-                    WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> jsonResponse = slot.Response();
+                result = Firebolt::Error::Timedout;
 
-                    // See if we have a jsonResponse, maybe it was just the connection
-                    // that closed?
-                    if (jsonResponse.IsValid() == true)
+                // See if we have a jsonResponse, maybe it was just the connection
+                // that closed?
+                if ((collected == WPEFramework::Core::ERROR_NONE) && (jsonResponse.IsValid() == true))
+                {
+                    if (jsonResponse->Error.IsSet() == true)
                     {
-                        if (jsonResponse->Error.IsSet() == true)
-                        {
-                            result = FireboltErrorValue(jsonResponse->Error.Code.Value());
-                        }
-                        else
+                        result = FireboltErrorValue(jsonResponse->Error.Code.Value());
+                    }
+                    else if ((text != nullptr) && (text->empty() == false))
+                    {
+                        bool enabled;
+                        result = _eventHandler->ValidateResponse(jsonResponse, enabled);
+                        if (result == Firebolt::Error::None)
                         {
-                            if ((jsonResponse->Result.IsSet() == true) && (jsonResponse->Result.Value().empty() == false))
-                            {
-                                bool enabled;
-                                result = _eventHandler->ValidateResponse(jsonResponse, enabled);
-                                if (result == Firebolt::Error::None)
-                                {
-                                    FromMessage((INTERFACE *)&response, *jsonResponse);
-                                    if (enabled)
-                                    {
-                                        _adminLock.Lock();
-                                        typename EventMap::iterator index = _eventMap.find(eventName);
-                                        if (index != _eventMap.end())
-                                        {
-                                            index->second = id;
-                                        }
-                                        _adminLock.Unlock();
-                                    }
-                                }
-                            }
+                            // The handler read the result through ResultOf as well, on this
+                            // thread: take it again rather than trust what is in the buffer
+                            FromResult((INTERFACE *)&response, ResultOf(*jsonResponse));
                         }
                     }
                 }
-                else
-                {
-                    result = Firebolt::Error::Timedout;
-                }
-                waiting -= (waiting == WPEFramework::Core::infinite ? 0 : waitSlot);
-            } while ((result != Firebolt::Error::None) && (waiting > 0));
-            _adminLock.Lock();
-            _pendingQueue.erase(id);
-            _adminLock.Unlock();
+            }
 
             return result;
         }
-#endif
+
+        /* Blocks until the synchronous entry of id is signalled, then takes it out of the table.
+           Such an entry is only ever removed by its waiter, so it can not go away while we block
+           on it, and it is not pinned for the wait: that would keep anyone visiting or removing
+           the id spinning until we woke up. It is pinned only to look it up, and removed, which
+           keeps late responses out, to read the response and its result text.
+           Returns ERROR_GENERAL if id is not pending, ERROR_TIMEDOUT, or ERROR_NONE with the
+           response, which is invalid if the call was aborted. text then points at the result,
+           see ResultOf() for how long it stays valid.
+        */
+        uint32_t Collect(const uint32_t id, const uint32_t waitTime, WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &response, const string *&text, const char *&method)
+        {
+            Entry *entry = nullptr;
+            _pendingQueue.Visit(id, [&](Entry& slot) {
+                ASSERT(slot.IsSynchronous() == true);
+                entry = &slot;
+                method = slot.Method();
+            });
+
+            uint32_t result = WPEFramework::Core::ERROR_GENERAL;
+            if (entry != nullptr) {
+                Tracer::Span wait(Tracer::Phase::Wait, id, method);
+                result = (entry->WaitForResponse(waitTime) == true ? WPEFramework::Core::ERROR_NONE : WPEFramework::Core::ERROR_TIMEDOUT);
+            }
+
+            _pendingQueue.Remove(id, [&](Entry& slot) {
+                if (result == WPEFramework::Core::ERROR_NONE) {
+                    response = slot.Response();
+                    if ((response.IsValid() == true) && (response->Error.IsSet() == false) && (response->Result.IsSet() == true)) {
+                        text = &ResultOf(*response);
+                        slot.Loaded(static_cast<uint32_t>(text->size()));
+                    }
+                } else {
+                    slot.TimedOut();
+                }
+            });
+
+            return (result);
+        }
+
     public:
+        // Parses the result of message into response, without a string of its own per call
         void FromMessage(WPEFramework::Core::JSON::IElement *response, const WPEFramework::Core::JSONRPC::Message &message) const
         {
-            response->FromString(message.Result.Value());
+            FromResult(response, ResultOf(message));
         }
 
         void FromMessage(WPEFramework::Core::JSON::IMessagePack *response, const WPEFramework::Core::JSONRPC::Message &message) const
         {
-            string value = message.Result.Value();
-            std::vector<uint8_t> result(value.begin(), value.end());
-            response->FromBuffer(result);
+            FromResult(response, ResultOf(message));
         }
 
     private:
-        void ToMessage(const string &parameters, WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &message) const
+        // A MessagePack transport talking to a JSON only server carries JSON text
+        bool IsJSON() const
+        {
+            return (strcmp(_channel->Protocol(), Channel::JSONProtocol) == 0);
+        }
+        static WPEFramework::Core::JSON::IElement *AsElement(WPEFramework::Core::JSON::IMessagePack *element)
+        {
+            WPEFramework::Core::JSON::IElement *result = dynamic_cast<WPEFramework::Core::JSON::IElement *>(element);
+            ASSERT(result != nullptr);
+            return (result);
+        }
+        static const WPEFramework::Core::JSON::IElement *AsElement(const WPEFramework::Core::JSON::IMessagePack *element)
+        {
+            const WPEFramework::Core::JSON::IElement *result = dynamic_cast<const WPEFramework::Core::JSON::IElement *>(element);
+            ASSERT(result != nullptr);
+            return (result);
+        }
+
+        void ToResult(const WPEFramework::Core::JSON::IElement *element, string &result) const
+        {
+            element->ToString(result);
+        }
+
+        void ToResult(const WPEFramework::Core::JSON::IMessagePack *element, string &result) const
+        {
+            if (IsJSON() == true)
+            {
+                AsElement(element)->ToString(result);
+            }
+            else
+            {
+                std::vector<uint8_t> values;
+                element->ToBuffer(values);
+                result.assign(values.begin(), values.end());
+            }
+        }
+
+        void FromResult(WPEFramework::Core::JSON::IElement *element, const string &result) const
+        {
+            element->FromString(result);
+        }
+
+        // Deserialize takes at most 64 KiB at a time, larger results go in chunks
+        void FromResult(WPEFramework::Core::JSON::IMessagePack *element, const string &result) const
+        {
+            if (IsJSON() == true)
+            {
+                AsElement(element)->FromString(result);
+            }
+            else
+            {
+                const uint8_t *data = reinterpret_cast<const uint8_t *>(result.data());
+                size_t loaded = 0;
+                uint32_t offset = 0;
+                uint16_t handled = 1;
+                while ((loaded < result.size()) && (handled != 0))
+                {
+                    const uint16_t chunk = static_cast<uint16_t>(std::min(result.size() - loaded, static_cast<size_t>(std::numeric_limits<uint16_t>::max())));
+                    handled = element->Deserialize(&data[loaded], chunk, offset);
+                    loaded += handled;
+                }
+            }
+        }
+
+        // The parameters as they go out, the same two kinds ToMessage takes
+        void ToParameters(const string &parameters, string &text) const
+        {
+            text = parameters;
+        }
+
+        template <typename PARAMETERS>
+        void ToParameters(const PARAMETERS &parameters, string &text) const
+        {
+            static_assert(std::is_base_of<INTERFACE, PARAMETERS>::value, "Parameters are either text or an INTERFACE");
+            ToResult(static_cast<const INTERFACE*>(&parameters), text);
+        }
+
+        // These return the length of the parameters, for the statistics
+        uint32_t ToMessage(const string &parameters, WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &message) const
         {
             if (parameters.empty() != true)
             {
                 message->Parameters = parameters;
             }
+            return (static_cast<uint32_t>(parameters.size()));
         }
 
         template <typename PARAMETERS>
-        void ToMessage(PARAMETERS &parameters, WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &message) const
+        uint32_t ToMessage(PARAMETERS &parameters, WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &message) const
         {
-            ToMessage((INTERFACE *)(&parameters), message);
-            return;
+            return (ToMessage((INTERFACE *)(&parameters), message));
         }
 
-        void ToMessage(WPEFramework::Core::JSON::IMessagePack *parameters, WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &message) const
+        uint32_t ToMessage(WPEFramework::Core::JSON::IMessagePack *parameters, WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &message) const
         {
-            std::vector<uint8_t> values;
-            parameters->ToBuffer(values);
+            string values;
+            ToResult(parameters, values);
             if (values.empty() != true)
             {
-                string strValues(values.begin(), values.end());
-                message->Parameters = strValues;
+                message->Parameters = values;
             }
-            return;
+            return (static_cast<uint32_t>(values.size()));
         }
 
-        void ToMessage(WPEFramework::Core::JSON::IElement *parameters, WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &message) const
+        uint32_t ToMessage(WPEFramework::Core::JSON::IElement *parameters, WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> &message) const
         {
             string values;
             parameters->ToString(values);
@@ -1089,7 +1864,7 @@ template <typename RESPONSE>
             {
                 message->Parameters = values;
             }
-            return;
+            return (static_cast<uint32_t>(values.size()));
         }
 
         Firebolt::Error FireboltErrorValue(const uint32_t error)
@@ -1120,13 +1895,16 @@ template <typename RESPONSE>
         WPEFramework::Core::ProxyType<Channel> _channel;
         IEventHandler *_eventHandler;
         PendingMap _pendingQueue;
-        EventMap _internalEventMap;
-        EventMap _externalEventMap;
-        EventMap _eventMap;
+        TimerWheel<> _timers;
+        EventRegistry<> _events;
+        WPEFramework::Core::CriticalSection _flightLock;
+        FlightMap _flights;
         uint64_t _scheduledTime;
         uint32_t _waitTime;
         Listener _listener;
         bool _connected;
         Firebolt::Error _status;
+        WPEFramework::Core::Event _linkReady;
+        WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch> _connectionJob;
     };
 }
\ No newline at end of file
@@ -0,0 +1,279 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+#include "json_engine.h"
+
+#include <limits>
+
+namespace FireboltSDK {
+
+    Server::Server()
+        : _adminLock()
+        , _override()
+        , _engine()
+        , _requests()
+        , _listening()
+    {
+        try {
+            _engine.reset(new JsonEngine());
+        } catch (const std::exception& e) {
+            // Still good for the tests that answer for themselves
+            FIREBOLT_LOG_WARNING(Logger::Category::OpenRPC, Logger::Module<Server>(), "No openrpc document: %s", e.what());
+        }
+    }
+
+    Server::~Server() = default;
+
+    /* static */ Server& Server::Instance()
+    {
+        static Server server;
+        return server;
+    }
+
+    bool Server::Respond(const Message& request, Message& response)
+    {
+        _adminLock.Lock();
+        _requests[request.Designator.Value()]++;
+        if (request.Parameters.Value().find(_T("\"listen\":true")) != string::npos) {
+            _listening[request.Designator.Value()] = request.Id.Value();
+        }
+        Responder responder = _override;
+        _adminLock.Unlock();
+
+        bool result = true;
+        if (responder != nullptr) {
+            result = responder(request, response);
+        } else if (_engine != nullptr) {
+            MockRequest(*_engine, request);
+            result = MockResponse(*_engine, request, response);
+        } else {
+            response.Error.Code = static_cast<int32_t>(Firebolt::Error::MethodNotFound);
+            response.Error.Text = _T("Method not found");
+        }
+        return result;
+    }
+
+    void MockRequest(const JsonEngine& engine, const Server::Message& request)
+    {
+        const std::string methodName = capitalizeFirstChar(request.Designator.Value());
+
+        if (engine.get_value(methodName).empty() == false) {
+            EXPECT_GE(request.Id.Value(), 1u);
+            EXPECT_LE(request.Id.Value(), static_cast<uint32_t>(std::numeric_limits<int>::max()));
+        }
+        for (const std::string& problem : engine.validate_params(methodName, request.Parameters.Value())) {
+            ADD_FAILURE() << problem;
+        }
+    }
+
+    bool MockResponse(const JsonEngine& engine, const Server::Message& request, Server::Message& response)
+    {
+        const std::string methodName = capitalizeFirstChar(request.Designator.Value());
+
+        if (engine.is_event(methodName) == true) {
+            JsonObject parameters;
+            parameters.FromString(request.Parameters.Value());
+            const bool listen = ((parameters.HasLabel(_T("listen")) == false) || (parameters.Get(_T("listen")).Boolean() == true));
+            response.Result = string(_T("{\"listening\":")) + (listen == true ? _T("true") : _T("false")) + _T(",\"event\":\"") + request.Designator.Value() + _T("\"}");
+        } else {
+            const string result = engine.get_value(methodName);
+            if (result.empty() == false) {
+                response.Result = result;
+            } else {
+                response.Error.Code = static_cast<int32_t>(Firebolt::Error::MethodNotFound);
+                response.Error.Text = _T("Method not found");
+            }
+        }
+        return true;
+    }
+
+    void Server::Override(const Responder& responder)
+    {
+        _adminLock.Lock();
+        _override = responder;
+        _adminLock.Unlock();
+    }
+
+    uint32_t Server::Requests(const string& method) const
+    {
+        _adminLock.Lock();
+        std::unordered_map<string, uint32_t>::const_iterator index = _requests.find(method);
+        const uint32_t result = (index != _requests.end() ? index->second : 0);
+        _adminLock.Unlock();
+        return result;
+    }
+
+    void Server::Reset()
+    {
+        _adminLock.Lock();
+        _requests.clear();
+        _adminLock.Unlock();
+    }
+
+    bool Server::Notify(const string& eventName, const string& result)
+    {
+        _adminLock.Lock();
+        std::unordered_map<string, uint32_t>::const_iterator index = _listening.find(eventName);
+        const uint32_t id = (index != _listening.end() ? index->second : 0);
+        _adminLock.Unlock();
+
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = Accessor::Instance().GetTransport();
+        const bool sent = ((id != 0) && (transport != nullptr));
+        if (sent == true) {
+            WPEFramework::Core::ProxyType<Message> notification = WPEFramework::Core::ProxyType<Message>::Create();
+            notification->Id = id;
+            notification->Result = result;
+            transport->Deliver(notification);
+        }
+        return sent;
+    }
+
+    SocketServer* SocketServer::_singleton = nullptr;
+
+    SocketServer::Connection::Connection(const SOCKET& socket, const WPEFramework::Core::NodeId& remoteNode, WPEFramework::Core::SocketServerType<Connection>*)
+        : BaseClass(5, _singleton->_factory, false, false, false, socket, remoteNode, 1024, 1024)
+    {
+        _singleton->Opened(*this);
+    }
+
+    SocketServer::Connection::~Connection()
+    {
+        _singleton->Closed(*this);
+    }
+
+    void SocketServer::Connection::Received(WPEFramework::Core::ProxyType<WPEFramework::Core::JSON::IElement>& element)
+    {
+        WPEFramework::Core::ProxyType<Server::Message> request(element);
+
+        ASSERT(request.IsValid() == true);
+        if (request.IsValid() == true) {
+            WPEFramework::Core::ProxyType<Server::Message> response(_singleton->_factory.Element(string()));
+            response->Clear();
+            response->Id = request->Id.Value();
+            if (Server::Instance().Respond(*request, *response) == true) {
+                Submit(WPEFramework::Core::ProxyType<WPEFramework::Core::JSON::IElement>(response));
+            }
+        }
+    }
+
+    void SocketServer::Connection::StateChange()
+    {
+        if (IsOpen() == false) {
+            _singleton->Closed(*this);
+        } else if (SpeaksJSON() == false) {
+            // Like the Thunder server: a client offering anything but JSON is turned away
+            Close(0);
+        }
+    }
+
+    bool SocketServer::Connection::SpeaksJSON() const
+    {
+        WPEFramework::Web::ProtocolsArray protocols(Protocols());
+        bool result = (protocols.Count() == 0);
+        protocols.Reset();
+        while ((result == false) && (protocols.Next() == true)) {
+            result = (protocols.Current() == _T("JSON"));
+        }
+        return (result);
+    }
+
+    SocketServer::SocketServer(const WPEFramework::Core::NodeId& node)
+        : _factory()
+        , _server(node)
+        , _lock()
+        , _connections()
+    {
+        ASSERT(_singleton == nullptr);
+        _singleton = this;
+    }
+
+    SocketServer::~SocketServer()
+    {
+        Close();
+
+        ASSERT(_singleton != nullptr);
+        _singleton = nullptr;
+    }
+
+    uint32_t SocketServer::Open()
+    {
+        return (_server.Open(WPEFramework::Core::infinite));
+    }
+
+    void SocketServer::Close()
+    {
+        // Held throughout, so none of them is destroyed underneath. Recursive: closing may report back right away.
+        _lock.lock();
+        const std::set<Connection*> connections(_connections);
+        for (Connection* connection : connections) {
+            connection->Close(0);
+        }
+        _lock.unlock();
+
+        _server.Close(WPEFramework::Core::infinite);
+    }
+
+    void SocketServer::Opened(Connection& connection)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_lock);
+        _connections.insert(&connection);
+    }
+
+    void SocketServer::Closed(Connection& connection)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_lock);
+        _connections.erase(&connection);
+    }
+
+    void UnitEnvironment::SetUp()
+    {
+        Transport<WPEFramework::Core::JSON::IElement>::Loopback([](const Server::Message& request, Server::Message& response) {
+            return Server::Instance().Respond(request, response);
+        });
+
+        const string config = _T("{\"waitTime\":") + std::to_string(WaitTime)
+            + _T(",\"logLevel\":\"Info\",\"workerPool\":{\"queueSize\":8,\"threadCount\":3},\"wsUrl\":\"")
+            + Transport<WPEFramework::Core::JSON::IElement>::LoopbackScheme + _T("\"}");
+        Accessor::Instance(config);
+
+        // Like an application that never calls Connect: the first call connects
+        ASSERT_NE(Accessor::Instance().GetTransport(), nullptr);
+    }
+
+    void UnitEnvironment::TearDown()
+    {
+        Accessor::Instance().Disconnect();
+        Accessor::Dispose();
+    }
+
+    /* static */ bool UnitEnvironment::Reconnect()
+    {
+        WPEFramework::Core::Event connected(false, true);
+        Firebolt::Error status = Accessor::Instance().Connect([&connected](const bool isConnected, const Firebolt::Error) {
+            if (isConnected == true) {
+                connected.SetEvent();
+            }
+        });
+        const bool result = ((status == Firebolt::Error::None) && (connected.Lock(WaitTime) == WPEFramework::Core::ERROR_NONE));
+        Accessor::Instance().UnregisterConnnectionChangeListener();
+        return (result);
+    }
+
+    static ::testing::Environment* const environment = ::testing::AddGlobalTestEnvironment(new UnitEnvironment());
+}
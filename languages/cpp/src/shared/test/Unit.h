@@ -0,0 +1,190 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "Module.h"
+#include "FireboltSDK.h"
+
+#include "gtest/gtest.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+class JsonEngine;
+
+namespace FireboltSDK {
+
+    /* Stands in for the server in the unit tests. The SDK is connected to "loopback://",
+       so every request it sends ends up in Respond(), on the sending thread. That answers
+       from the examples in the openrpc document, or with "Method not found", unless a test
+       put a responder of its own in front with a Server::Scope.
+    */
+    class Server {
+    public:
+        using Message = WPEFramework::Core::JSONRPC::Message;
+        using Responder = Transport<WPEFramework::Core::JSON::IElement>::Responder;
+
+        // Answers with responder for as long as it exists
+        class Scope {
+        public:
+            Scope() = delete;
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+            Scope(const Responder& responder)
+            {
+                Server::Instance().Override(responder);
+            }
+            ~Scope()
+            {
+                Server::Instance().Override(nullptr);
+            }
+        };
+
+    private:
+        Server();
+
+    public:
+        Server(const Server&) = delete;
+        Server& operator=(const Server&) = delete;
+        ~Server();
+
+        static Server& Instance();
+
+        bool Respond(const Message& request, Message& response);
+        void Override(const Responder& responder);
+
+        // How many requests for method came in since the last Reset()
+        uint32_t Requests(const string& method) const;
+        void Reset();
+
+        // Sends result as a notification of eventName, to whoever last started listening to it
+        bool Notify(const string& eventName, const string& result);
+
+    private:
+        mutable WPEFramework::Core::CriticalSection _adminLock;
+        Responder _override;
+        std::unique_ptr<JsonEngine> _engine;
+        std::unordered_map<string, uint32_t> _requests;
+        std::unordered_map<string, uint32_t> _listening; // event name to the id of its listen:true
+    };
+
+    // Checks request against the openrpc document of engine, each problem is a test failure
+    void MockRequest(const JsonEngine& engine, const Server::Message& request);
+    // Answers request from the examples in the document: a listening acknowledgement for an
+    // event, the example result for a method and "Method not found" for anything else
+    bool MockResponse(const JsonEngine& engine, const Server::Message& request, Server::Message& response);
+
+    /* Puts the Server behind a real websocket, on a TCP port or a unix socket path, for
+       the tests about what happens on and to the socket. Requests are answered on the
+       thread reading it. One at a time.
+    */
+    class SocketServer {
+    private:
+        class Factory {
+        public:
+            Factory(const Factory&) = delete;
+            Factory& operator=(const Factory&) = delete;
+
+            Factory()
+                : _messages(8)
+            {
+            }
+            ~Factory() = default;
+
+        public:
+            WPEFramework::Core::ProxyType<Server::Message> Element(const string&)
+            {
+                return (_messages.Element());
+            }
+
+        private:
+            WPEFramework::Core::ProxyPoolType<Server::Message> _messages;
+        };
+
+        class Connection : public WPEFramework::Core::StreamJSONType<WPEFramework::Web::WebSocketServerType<WPEFramework::Core::SocketStream>, Factory&, WPEFramework::Core::JSON::IElement> {
+        private:
+            typedef WPEFramework::Core::StreamJSONType<WPEFramework::Web::WebSocketServerType<WPEFramework::Core::SocketStream>, Factory&, WPEFramework::Core::JSON::IElement> BaseClass;
+
+        public:
+            Connection() = delete;
+            Connection(const Connection&) = delete;
+            Connection& operator=(const Connection&) = delete;
+
+            Connection(const SOCKET& socket, const WPEFramework::Core::NodeId& remoteNode, WPEFramework::Core::SocketServerType<Connection>*);
+            ~Connection() override;
+
+        public:
+            void Received(WPEFramework::Core::ProxyType<WPEFramework::Core::JSON::IElement>& element) override;
+            void Send(WPEFramework::Core::ProxyType<WPEFramework::Core::JSON::IElement>&) override
+            {
+            }
+            void StateChange() override;
+            bool IsIdle() const override
+            {
+                return (true);
+            }
+
+        private:
+            bool SpeaksJSON() const;
+        };
+
+    public:
+        SocketServer() = delete;
+        SocketServer(const SocketServer&) = delete;
+        SocketServer& operator=(const SocketServer&) = delete;
+
+        SocketServer(const WPEFramework::Core::NodeId& node);
+        ~SocketServer();
+
+    public:
+        uint32_t Open();
+        // Stops listening and drops every connection, as a server going away would
+        void Close();
+
+    private:
+        void Opened(Connection& connection);
+        void Closed(Connection& connection);
+
+    private:
+        Factory _factory;
+        WPEFramework::Core::SocketServerType<Connection> _server;
+        std::recursive_mutex _lock;
+        std::set<Connection*> _connections;
+        static SocketServer* _singleton;
+    };
+
+    // Connects the SDK to the Server before the first test, and disconnects it after the last
+    class UnitEnvironment : public ::testing::Environment {
+    public:
+        static constexpr uint32_t WaitTime = 1000;
+
+        UnitEnvironment() = default;
+        ~UnitEnvironment() override = default;
+
+        void SetUp() override;
+        void TearDown() override;
+
+        // Connects again, on a new transport, as after losing the connection. True once it is up.
+        static bool Reconnect();
+    };
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+#include "Properties/Properties.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Counts the allocations of the thread that asked for it, see Allocations below. This replaces
+// operator new for the whole executable, which is why these tests are built on their own.
+static thread_local bool counting = false;
+static thread_local uint64_t allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    if (counting == true) {
+        ++allocations;
+    }
+    void* result = std::malloc(size != 0 ? size : 1);
+    if (result == nullptr) {
+        throw std::bad_alloc();
+    }
+    return result;
+}
+
+void operator delete(void* data) noexcept
+{
+    std::free(data);
+}
+
+void operator delete(void* data, std::size_t) noexcept
+{
+    std::free(data);
+}
+
+namespace FireboltSDK {
+
+    // The allocations made by this thread while it exists
+    class Allocations {
+    public:
+        Allocations(const Allocations&) = delete;
+        Allocations& operator=(const Allocations&) = delete;
+
+        Allocations()
+            : _start(allocations)
+        {
+            counting = true;
+        }
+        ~Allocations()
+        {
+            counting = false;
+        }
+
+    public:
+        uint64_t Count() const
+        {
+            return (allocations - _start);
+        }
+
+    private:
+        const uint64_t _start;
+    };
+
+    class Device : public WPEFramework::Core::JSON::Container {
+    public:
+        Device(const Device&) = delete;
+        Device& operator=(const Device&) = delete;
+
+        Device()
+            : WPEFramework::Core::JSON::Container()
+            , Id()
+            , Name()
+            , Version()
+        {
+            Add(_T("id"), &Id);
+            Add(_T("name"), &Name);
+            Add(_T("version"), &Version);
+        }
+        ~Device() override = default;
+
+    public:
+        WPEFramework::Core::JSON::String Id;
+        WPEFramework::Core::JSON::String Name;
+        WPEFramework::Core::JSON::DecUInt32 Version;
+    };
+
+    static constexpr const TCHAR* DeviceResult = _T("{\"id\":\"123456789\",\"name\":\"living room\",\"version\":42}");
+
+    TEST(Allocation, PerCall)
+    {
+        static constexpr uint32_t Calls = 1000;
+        static constexpr uint32_t InvokeAllocations = 16;
+
+        Server::Scope scope([](const Server::Message&, Server::Message& response) {
+            response.Result = DeviceResult;
+            return true;
+        });
+
+        auto transport = Accessor::Instance().GetTransport();
+        ASSERT_NE(transport, nullptr);
+
+        JsonObject parameters;
+        {
+            // Pools and maps filled up front
+            Device device;
+            for (uint8_t index = 0; index < 16; ++index) {
+                transport->Invoke(_T("test.device"), parameters, device);
+            }
+        }
+
+        uint64_t parse = 0;
+        {
+            Server::Message message;
+            message.Result = DeviceResult;
+            Device device;
+            Allocations counted;
+            for (uint32_t index = 0; index < Calls; ++index) {
+                transport->FromMessage(&device, message);
+            }
+            parse = counted.Count();
+        }
+
+        uint64_t invoke = 0;
+        {
+            Device device;
+            Allocations counted;
+            for (uint32_t index = 0; index < Calls; ++index) {
+                EXPECT_EQ(transport->Invoke(_T("test.device"), parameters, device), Firebolt::Error::None);
+            }
+            invoke = counted.Count();
+        }
+
+        uint64_t property = 0;
+        {
+            Allocations counted;
+            for (uint32_t index = 0; index < Calls; ++index) {
+                WPEFramework::Core::ProxyType<Device> device;
+                EXPECT_EQ(Properties::Get(_T("test.device"), device), Firebolt::Error::None);
+            }
+            property = counted.Count();
+        }
+
+        printf("Allocations per call: deserialize %.1f, invoke %.1f, property get %.1f\n",
+            static_cast<double>(parse) / Calls, static_cast<double>(invoke) / Calls, static_cast<double>(property) / Calls);
+
+        // Parsing reuses the result buffer of the thread, it only grows on the first call. A
+        // call adds what its messages and the loopback server need, the bounds leave room for
+        // those but not for a string per response on top.
+        EXPECT_LE(parse, 1u);
+        EXPECT_LE(invoke, static_cast<uint64_t>(InvokeAllocations) * Calls);
+        EXPECT_LE(property, static_cast<uint64_t>(InvokeAllocations) * Calls);
+    }
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace FireboltSDK {
+
+    static bool WaitFor(const std::function<bool()>& condition, const uint32_t waitTime)
+    {
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(waitTime);
+        bool result = condition();
+        while ((result == false) && (std::chrono::steady_clock::now() < deadline)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            result = condition();
+        }
+        return (result);
+    }
+
+    TEST(Accessor, ConnectsOnFirstUse)
+    {
+        EXPECT_TRUE(Accessor::Instance().IsConnected());
+        EXPECT_NE(Accessor::Instance().GetTransport(), nullptr);
+    }
+
+    TEST(Accessor, TransportOutlivesReconnect)
+    {
+        Server::Scope scope([](const Server::Message&, Server::Message& response) {
+            response.Result = _T("true");
+            return true;
+        });
+
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> previous = Accessor::Instance().GetTransport();
+        ASSERT_NE(previous, nullptr);
+
+        ASSERT_TRUE(UnitEnvironment::Reconnect());
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> current = Accessor::Instance().GetTransport();
+        ASSERT_NE(current, nullptr);
+        EXPECT_NE(current, previous);
+
+        // Replaced, but still whole for whoever was in the middle of a call on it
+        JsonObject parameters;
+        WPEFramework::Core::JSON::Boolean response;
+        EXPECT_EQ(previous->Invoke(_T("test.previous"), parameters, response), Firebolt::Error::None);
+        EXPECT_TRUE(response.Value());
+        previous.reset();
+
+        EXPECT_EQ(current->Invoke(_T("test.current"), parameters, response), Firebolt::Error::None);
+    }
+
+    // Calls keep going while the transport is replaced underneath them: each one finishes on
+    // the transport it picked up, none of them sees one half replaced
+    TEST(Accessor, TransportIsReplacedWhileCallsAreInFlight)
+    {
+        static constexpr uint8_t Callers = 4;
+        static constexpr uint8_t Reconnects = 5;
+
+        Server::Scope scope([](const Server::Message&, Server::Message& response) {
+            response.Result = _T("true");
+            return true;
+        });
+
+        std::atomic<bool> done(false);
+        std::atomic<uint32_t> calls(0);
+        std::atomic<uint32_t> failures(0);
+        std::vector<std::thread> callers;
+        for (uint8_t index = 0; index < Callers; ++index) {
+            callers.emplace_back([&]() {
+                JsonObject parameters;
+                WPEFramework::Core::JSON::Boolean response;
+                while (done.load() == false) {
+                    // Nothing while the next one is not connected yet
+                    std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = Accessor::Instance().GetTransport();
+                    if (transport != nullptr) {
+                        if (transport->Invoke(_T("test.inflight"), parameters, response) == Firebolt::Error::None) {
+                            calls++;
+                        } else {
+                            failures++;
+                        }
+                    }
+                }
+            });
+        }
+
+        std::vector<std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>>> replaced;
+        for (uint8_t index = 0; index < Reconnects; ++index) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            replaced.push_back(Accessor::Instance().GetTransport());
+            EXPECT_TRUE(UnitEnvironment::Reconnect());
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        done = true;
+        for (std::thread& caller : callers) {
+            caller.join();
+        }
+
+        EXPECT_GT(calls.load(), 0u);
+        EXPECT_EQ(failures.load(), 0u);
+        for (uint8_t index = 1; index < replaced.size(); ++index) {
+            EXPECT_NE(replaced[index], replaced[index - 1]);
+        }
+        EXPECT_TRUE(Accessor::Instance().IsConnected());
+    }
+
+    // The channel of a transport that lost its server is shared with the next one to the
+    // same url, for as long as the old one is still held: the new one has to open it again.
+    TEST(Accessor, ReconnectsOverTheSameSocketChannel)
+    {
+        const string url = _T("ws://127.0.0.1:19998");
+        SocketServer server(WPEFramework::Core::NodeId(_T("127.0.0.1"), 19998));
+        ASSERT_EQ(server.Open(), WPEFramework::Core::ERROR_NONE);
+
+        Server::Scope scope([](const Server::Message&, Server::Message& response) {
+            response.Result = _T("true");
+            return true;
+        });
+        const Transport<WPEFramework::Core::JSON::IElement>::Listener ignore = [](const bool, const Firebolt::Error) {};
+
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> previous = std::make_shared<Transport<WPEFramework::Core::JSON::IElement>>(url, UnitEnvironment::WaitTime, ignore);
+        ASSERT_TRUE(WaitFor([&previous]() { return (previous->IsOpen() == true); }, UnitEnvironment::WaitTime));
+
+        server.Close();
+        ASSERT_TRUE(WaitFor([&previous]() { return (previous->IsOpen() == false); }, UnitEnvironment::WaitTime));
+        ASSERT_EQ(server.Open(), WPEFramework::Core::ERROR_NONE);
+
+        // previous is still around, like a call that has not let go of it yet
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> current = std::make_shared<Transport<WPEFramework::Core::JSON::IElement>>(url, UnitEnvironment::WaitTime, ignore);
+        ASSERT_TRUE(WaitFor([&current]() { return (current->IsOpen() == true); }, UnitEnvironment::WaitTime));
+
+        JsonObject parameters;
+        WPEFramework::Core::JSON::Boolean response;
+        EXPECT_EQ(current->Invoke(_T("test.socket"), parameters, response), Firebolt::Error::None);
+        EXPECT_TRUE(response.Value());
+
+        current.reset();
+        previous.reset();
+    }
+}
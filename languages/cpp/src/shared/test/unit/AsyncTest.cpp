@@ -0,0 +1,120 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+
+namespace FireboltSDK {
+
+    TEST(Async, FutureIsCompletedByTheResponse)
+    {
+        Server::Scope scope([](const Server::Message& request, Server::Message& response) {
+            response.Result = _T("\"") + request.Designator.Value() + _T("\"");
+            return true;
+        });
+
+        auto transport = Accessor::Instance().GetTransport();
+        ASSERT_NE(transport, nullptr);
+
+        // As the generated <method>Async() does it
+        std::shared_ptr<std::promise<Firebolt::Result<string>>> promise = std::make_shared<std::promise<Firebolt::Result<string>>>();
+        std::future<Firebolt::Result<string>> future = promise->get_future();
+        JsonObject parameters;
+        EXPECT_EQ(transport->InvokeAsync(_T("test.future"), parameters, [promise](const Firebolt::Error status, const Server::Message& response) {
+            WPEFramework::Core::JSON::String value;
+            value.FromString(response.Result.Value());
+            promise->set_value(Firebolt::Result<string>{ status, value.Value() });
+        }, transport->Sequence()), Firebolt::Error::None);
+
+        ASSERT_EQ(future.wait_for(std::chrono::milliseconds(UnitEnvironment::WaitTime)), std::future_status::ready);
+        const Firebolt::Result<string> result = future.get();
+        EXPECT_EQ(result.error, Firebolt::Error::None);
+        EXPECT_EQ(result.value, _T("test.future"));
+    }
+
+    TEST(Async, FailureIsPassedOn)
+    {
+        auto transport = Accessor::Instance().GetTransport();
+        ASSERT_NE(transport, nullptr);
+
+        std::shared_ptr<std::promise<Firebolt::Error>> promise = std::make_shared<std::promise<Firebolt::Error>>();
+        std::future<Firebolt::Error> future = promise->get_future();
+        JsonObject parameters;
+        EXPECT_EQ(transport->InvokeAsync(_T("test.unknownMethod"), parameters, [promise](const Firebolt::Error status, const Server::Message&) {
+            promise->set_value(status);
+        }), Firebolt::Error::None);
+
+        ASSERT_EQ(future.wait_for(std::chrono::milliseconds(UnitEnvironment::WaitTime)), std::future_status::ready);
+        EXPECT_EQ(future.get(), Firebolt::Error::MethodNotFound);
+    }
+
+    // Far more calls outstanding than the pending table has slots, none of them holding a thread
+    TEST(Async, ThousandsInFlight)
+    {
+        static constexpr uint32_t Calls = 2000;
+        static constexpr uint32_t WaitTime = 200;
+
+        // Never answers, every call stays outstanding until it times out
+        Server::Scope scope([](const Server::Message&, Server::Message&) {
+            return false;
+        });
+        Server::Instance().Reset();
+
+        auto transport = Accessor::Instance().GetTransport();
+        ASSERT_NE(transport, nullptr);
+
+        // Outlives the test should it fail with calls still outstanding
+        struct Outcome {
+            Outcome()
+                : completed(0)
+                , timedout(0)
+                , done(false, false)
+            {
+            }
+
+            std::atomic<uint32_t> completed;
+            std::atomic<uint32_t> timedout;
+            WPEFramework::Core::Event done;
+        };
+        std::shared_ptr<Outcome> outcome = std::make_shared<Outcome>();
+
+        JsonObject parameters;
+        uint32_t sent = 0;
+        for (uint32_t index = 0; index < Calls; ++index) {
+            uint32_t id;
+            const Firebolt::Error status = transport->InvokeAsync(_T("test.held"), parameters, [outcome](const Firebolt::Error status, const Server::Message&) {
+                if (status == Firebolt::Error::Timedout) {
+                    ++(outcome->timedout);
+                }
+                if (++(outcome->completed) == Calls) {
+                    outcome->done.SetEvent();
+                }
+            }, WaitTime, id);
+            EXPECT_EQ(status, Firebolt::Error::None);
+            sent += (status == Firebolt::Error::None ? 1 : 0);
+        }
+        ASSERT_EQ(sent, Calls);
+        EXPECT_EQ(Server::Instance().Requests(_T("test.held")), Calls);
+
+        ASSERT_EQ(outcome->done.Lock(WaitTime + UnitEnvironment::WaitTime * 5), WPEFramework::Core::ERROR_NONE);
+        EXPECT_EQ(outcome->timedout.load(), Calls);
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+
+namespace FireboltSDK {
+
+    TEST(Batch, EachPropertyInItsOwnType)
+    {
+        Server::Scope scope([](const Server::Message& request, Server::Message& response) {
+            if (request.Designator.Value() == _T("test.name")) {
+                response.Result = _T("\"firebolt\"");
+            } else if (request.Designator.Value() == _T("test.count")) {
+                response.Result = _T("42");
+            } else {
+                response.Error.Code = static_cast<int32_t>(Firebolt::Error::MethodNotFound);
+                response.Error.Text = _T("Method not found");
+            }
+            return true;
+        });
+        Server::Instance().Reset();
+
+        WPEFramework::Core::JSON::String name;
+        WPEFramework::Core::JSON::DecUInt32 count;
+        Properties::Batch batch = {
+            { _T("test.name"), _T("{}"), &name, Firebolt::Error::General },
+            { _T("test.count"), _T("{}"), &count, Firebolt::Error::General }
+        };
+        EXPECT_EQ(Properties::GetMany(batch), Firebolt::Error::None);
+        EXPECT_EQ(batch[0].status, Firebolt::Error::None);
+        EXPECT_EQ(name.Value(), _T("firebolt"));
+        EXPECT_EQ(batch[1].status, Firebolt::Error::None);
+        EXPECT_EQ(count.Value(), 42u);
+        EXPECT_EQ(Server::Instance().Requests(_T("test.name")), 1u);
+        EXPECT_EQ(Server::Instance().Requests(_T("test.count")), 1u);
+    }
+
+    TEST(Batch, FailuresAreKeptPerRequest)
+    {
+        Server::Scope scope([](const Server::Message& request, Server::Message& response) {
+            if (request.Designator.Value() == _T("test.name")) {
+                response.Result = _T("\"firebolt\"");
+            } else {
+                response.Error.Code = static_cast<int32_t>(Firebolt::Error::MethodNotFound);
+                response.Error.Text = _T("Method not found");
+            }
+            return true;
+        });
+
+        WPEFramework::Core::JSON::String name;
+        WPEFramework::Core::JSON::String missing;
+        Properties::Batch batch = {
+            { _T("test.missing"), _T("{}"), &missing, Firebolt::Error::General },
+            { _T("test.name"), _T("{}"), &name, Firebolt::Error::General }
+        };
+        EXPECT_EQ(Properties::GetMany(batch), Firebolt::Error::MethodNotFound);
+        EXPECT_EQ(batch[0].status, Firebolt::Error::MethodNotFound);
+        EXPECT_EQ(batch[1].status, Firebolt::Error::None);
+        EXPECT_EQ(name.Value(), _T("firebolt"));
+    }
+}
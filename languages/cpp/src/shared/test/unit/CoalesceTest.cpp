@@ -0,0 +1,199 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace FireboltSDK {
+
+    static constexpr uint8_t Callers = 8;
+
+    // Answers "test.coalesced" with how many requests for it came in so far, once all callers are under way
+    class Slow {
+    public:
+        Slow() = delete;
+        Slow(const Slow&) = delete;
+        Slow& operator=(const Slow&) = delete;
+
+        Slow(const std::atomic<uint8_t>& started)
+            : _started(started)
+            , _answered(0)
+        {
+        }
+        ~Slow() = default;
+
+    public:
+        bool Respond(const Server::Message&, Server::Message& response)
+        {
+            while (_started.load() < Callers) {
+                std::this_thread::yield();
+            }
+            // Give the last of them the time to find the call in progress
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            response.Result = std::to_string(++_answered);
+            return true;
+        }
+
+    private:
+        const std::atomic<uint8_t>& _started;
+        std::atomic<uint32_t> _answered;
+    };
+
+    TEST(Coalesce, IdenticalCallsShareOneRequest)
+    {
+        std::atomic<uint8_t> started(0);
+        Slow server(started);
+        Server::Scope scope([&server](const Server::Message& request, Server::Message& response) {
+            return server.Respond(request, response);
+        });
+        Server::Instance().Reset();
+
+        auto transport = Accessor::Instance().GetTransport();
+        ASSERT_NE(transport, nullptr);
+
+        Firebolt::Error status[Callers];
+        uint32_t value[Callers];
+        std::vector<std::thread> callers;
+        for (uint8_t index = 0; index < Callers; ++index) {
+            callers.emplace_back([&, index]() {
+                JsonObject parameters;
+                WPEFramework::Core::JSON::DecUInt32 response;
+                ++started;
+                status[index] = transport->InvokeCoalesced(_T("test.coalesced"), parameters, response);
+                value[index] = response.Value();
+            });
+        }
+        for (std::thread& caller : callers) {
+            caller.join();
+        }
+
+        EXPECT_EQ(Server::Instance().Requests(_T("test.coalesced")), 1u);
+        for (uint8_t index = 0; index < Callers; ++index) {
+            EXPECT_EQ(status[index], Firebolt::Error::None);
+            EXPECT_EQ(value[index], 1u);
+        }
+    }
+
+    TEST(Coalesce, CallsAfterTheAnswerSendAgain)
+    {
+        std::atomic<uint8_t> started(Callers);
+        Slow server(started);
+        Server::Scope scope([&server](const Server::Message& request, Server::Message& response) {
+            return server.Respond(request, response);
+        });
+        Server::Instance().Reset();
+
+        auto transport = Accessor::Instance().GetTransport();
+        ASSERT_NE(transport, nullptr);
+
+        JsonObject parameters;
+        WPEFramework::Core::JSON::DecUInt32 response;
+        EXPECT_EQ(transport->InvokeCoalesced(_T("test.coalesced"), parameters, response), Firebolt::Error::None);
+        EXPECT_EQ(response.Value(), 1u);
+        EXPECT_EQ(transport->InvokeCoalesced(_T("test.coalesced"), parameters, response), Firebolt::Error::None);
+        EXPECT_EQ(response.Value(), 2u);
+        EXPECT_EQ(Server::Instance().Requests(_T("test.coalesced")), 2u);
+    }
+
+    // A follower that joins late gives up when the leader does, not a whole wait time later
+    TEST(Coalesce, LateFollowerWaitsForTheLeadersDeadline)
+    {
+        // Never answers
+        Server::Scope scope([](const Server::Message&, Server::Message&) {
+            return false;
+        });
+
+        auto transport = Accessor::Instance().GetTransport();
+        ASSERT_NE(transport, nullptr);
+
+        Firebolt::Error leader = Firebolt::Error::None;
+        std::thread caller([&]() {
+            JsonObject parameters;
+            WPEFramework::Core::JSON::DecUInt32 response;
+            leader = transport->InvokeCoalesced(_T("test.coalescedLate"), parameters, response);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(UnitEnvironment::WaitTime / 2));
+
+        JsonObject parameters;
+        WPEFramework::Core::JSON::DecUInt32 response;
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        EXPECT_EQ(transport->InvokeCoalesced(_T("test.coalescedLate"), parameters, response), Firebolt::Error::Timedout);
+        const uint64_t waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count();
+        caller.join();
+
+        EXPECT_EQ(leader, Firebolt::Error::Timedout);
+        EXPECT_LT(waited, (UnitEnvironment::WaitTime * 3) / 4);
+    }
+
+    TEST(Coalesce, PropertiesGetCoalesced)
+    {
+        Server::Scope scope([](const Server::Message& request, Server::Message& response) {
+            response.Result = _T("\"") + request.Designator.Value() + _T("\"");
+            return true;
+        });
+
+        WPEFramework::Core::JSON::String response;
+        EXPECT_EQ(Properties::GetCoalesced(_T("test.coalescedProperty"), response), Firebolt::Error::None);
+        EXPECT_EQ(response.Value(), _T("test.coalescedProperty"));
+    }
+
+    TEST(Coalesce, TextParametersAreAKeyToo)
+    {
+        // Holds the first request until the second arrives, or it is clear it will not
+        std::atomic<uint32_t> arrived(0);
+        Server::Scope scope([&arrived](const Server::Message& request, Server::Message& response) {
+            ++arrived;
+            const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+            while ((arrived.load() < 2) && (std::chrono::steady_clock::now() < deadline)) {
+                std::this_thread::yield();
+            }
+            response.Result = request.Parameters.Value();
+            return true;
+        });
+        Server::Instance().Reset();
+
+        auto transport = Accessor::Instance().GetTransport();
+        ASSERT_NE(transport, nullptr);
+
+        const string parameters[2] = { _T("\"first\""), _T("\"second\"") };
+        Firebolt::Error status[2];
+        string value[2];
+        std::vector<std::thread> callers;
+        for (uint8_t index = 0; index < 2; ++index) {
+            callers.emplace_back([&, index]() {
+                WPEFramework::Core::JSON::String response;
+                status[index] = transport->InvokeCoalesced(_T("test.coalescedText"), parameters[index], response);
+                value[index] = response.Value();
+            });
+        }
+        for (std::thread& caller : callers) {
+            caller.join();
+        }
+
+        // Different parameters, different calls
+        EXPECT_EQ(Server::Instance().Requests(_T("test.coalescedText")), 2u);
+        EXPECT_EQ(status[0], Firebolt::Error::None);
+        EXPECT_EQ(value[0], _T("first"));
+        EXPECT_EQ(status[1], Firebolt::Error::None);
+        EXPECT_EQ(value[1], _T("second"));
+    }
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace FireboltSDK {
+
+    // What a transport told its listener, in order
+    class Notices {
+    public:
+        using Notice = std::pair<bool, Firebolt::Error>;
+
+        Notices(const Notices&) = delete;
+        Notices& operator=(const Notices&) = delete;
+
+        Notices() = default;
+        ~Notices() = default;
+
+    public:
+        Transport<WPEFramework::Core::JSON::IElement>::Listener Listener()
+        {
+            return [this](const bool connected, const Firebolt::Error status) {
+                std::lock_guard<std::mutex> lock(_lock);
+                _notices.emplace_back(connected, status);
+            };
+        }
+        std::vector<Notice> Get() const
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            return (_notices);
+        }
+
+    private:
+        mutable std::mutex _lock;
+        std::vector<Notice> _notices;
+    };
+
+    TEST(Connect, AnOpenLinkIsReportedAtOnce)
+    {
+        Notices notices;
+        {
+            Transport<WPEFramework::Core::JSON::IElement> transport([](const Server::Message&, Server::Message& response) {
+                response.Result = _T("null");
+                return true;
+            }, UnitEnvironment::WaitTime, notices.Listener());
+
+            // Told while it was created, no waiting involved
+            EXPECT_TRUE(transport.IsOpen());
+            ASSERT_EQ(notices.Get().size(), 1u);
+            EXPECT_EQ(notices.Get()[0], Notices::Notice(true, Firebolt::Error::None));
+
+            // Its connection job sees the link up too, instead of timing out on it
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        EXPECT_EQ(notices.Get().size(), 1u);
+    }
+
+    TEST(Connect, ConnectDoesNotWaitForAPollingSlice)
+    {
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        ASSERT_TRUE(UnitEnvironment::Reconnect());
+
+        // Waiting for the link used to go in 100ms slices
+        EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count(), 100);
+    }
+
+    // Time from creating a transport until its listener is told it is connected
+    TEST(Connect, StartupBenchmark)
+    {
+        static constexpr uint32_t Rounds = 20;
+        static constexpr uint16_t Port = 19997;
+
+        SocketServer server(WPEFramework::Core::NodeId(_T("127.0.0.1"), Port));
+        ASSERT_EQ(server.Open(), WPEFramework::Core::ERROR_NONE);
+        const string url = _T("ws://127.0.0.1:") + std::to_string(Port);
+
+        uint64_t loopback = 0;
+        uint64_t socket = 0;
+        for (uint32_t round = 0; round < Rounds; ++round) {
+            WPEFramework::Core::Event connected(false, true);
+            const Transport<WPEFramework::Core::JSON::IElement>::Listener listener = [&connected](const bool up, const Firebolt::Error) {
+                if (up == true) {
+                    connected.SetEvent();
+                }
+            };
+
+            std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            {
+                Transport<WPEFramework::Core::JSON::IElement> transport([](const Server::Message&, Server::Message& response) {
+                    response.Result = _T("null");
+                    return true;
+                }, UnitEnvironment::WaitTime, listener);
+                ASSERT_EQ(connected.Lock(UnitEnvironment::WaitTime), WPEFramework::Core::ERROR_NONE);
+                loopback += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+            }
+
+            connected.ResetEvent();
+            begin = std::chrono::steady_clock::now();
+            {
+                Transport<WPEFramework::Core::JSON::IElement> transport(url, UnitEnvironment::WaitTime, listener);
+                ASSERT_EQ(connected.Lock(UnitEnvironment::WaitTime), WPEFramework::Core::ERROR_NONE);
+                socket += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+            }
+        }
+        server.Close();
+
+        printf("Startup until connected: loopback %.0f us, websocket over tcp %.0f us\n",
+            static_cast<double>(loopback) / Rounds, static_cast<double>(socket) / Rounds);
+    }
+}
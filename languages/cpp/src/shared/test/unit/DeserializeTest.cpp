@@ -0,0 +1,39 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+
+namespace FireboltSDK {
+
+    TEST(Deserialize, LargeResultIsWhole)
+    {
+        const string value(100 * 1024, 'x');
+        Server::Scope scope([&value](const Server::Message&, Server::Message& response) {
+            response.Result = _T("\"") + value + _T("\"");
+            return true;
+        });
+
+        auto transport = Accessor::Instance().GetTransport();
+        ASSERT_NE(transport, nullptr);
+
+        JsonObject parameters;
+        WPEFramework::Core::JSON::String response;
+        EXPECT_EQ(transport->Invoke(_T("test.large"), parameters, response), Firebolt::Error::None);
+        EXPECT_EQ(response.Value().size(), value.size());
+    }
+}
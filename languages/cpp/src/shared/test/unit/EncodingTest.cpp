@@ -0,0 +1,234 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "Unit.h"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace FireboltSDK {
+
+    namespace {
+        // What results typically look like, from a bare value to a large list
+        const string Corpus[] = {
+            _T("true"),
+            _T("42"),
+            _T("\"Living Room\""),
+            _T("{\"id\":\"123456789\",\"name\":\"living room\",\"version\":42}"),
+            _T("{\"type\":\"wifi\",\"state\":\"connected\",\"ssid\":\"home\",\"signal\":{\"quality\":87,\"rssi\":-48},\"ipv4\":[\"192.168.1.20\"]}"),
+            _T("{\"closedCaptions\":{\"enabled\":true,\"styles\":{\"fontFamily\":\"monospaced_sanserif\",\"fontSize\":1.5,\"fontColor\":\"#ffffff\",\"backgroundOpacity\":50}},\"audioDescriptions\":{\"enabled\":false}}")
+        };
+
+        string Canonical(const string& text)
+        {
+            JsonValue value;
+            value.FromString(text);
+            string result;
+            value.ToString(result);
+            return (result);
+        }
+
+        // Any value of the corpus, as an object MessagePack can carry as well as JSON
+        string Wrapped(const string& text)
+        {
+            return (_T("{\"value\":") + text + _T("}"));
+        }
+
+        string Packed(const string& text)
+        {
+            JsonObject value;
+            value.FromString(Wrapped(text));
+            std::vector<uint8_t> buffer;
+            value.ToBuffer(buffer);
+            return (string(buffer.begin(), buffer.end()));
+        }
+
+        bool WaitFor(const std::function<bool()>& condition)
+        {
+            const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(4 * UnitEnvironment::WaitTime);
+            bool result = condition();
+            while ((result == false) && (std::chrono::steady_clock::now() < deadline)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                result = condition();
+            }
+            return (result);
+        }
+
+        string List(const uint32_t count)
+        {
+            string result = _T("[");
+            for (uint32_t index = 0; index < count; ++index) {
+                result += (index != 0 ? _T(",") : _T("")) + string(_T("{\"entityId\":\"")) + std::to_string(index) + _T("\",\"title\":\"Item\",\"progress\":") + std::to_string(index % 100) + _T("}");
+            }
+            return (result + _T("]"));
+        }
+    }
+
+    // Whatever the server sends comes out the same on our side
+    TEST(Encoding, CorpusRoundTrips)
+    {
+        const string list = List(1000);
+        string current;
+        Server::Scope scope([&current](const Server::Message&, Server::Message& response) {
+            response.Result = current;
+            return true;
+        });
+
+        auto transport = Accessor::Instance().GetTransport();
+        ASSERT_NE(transport, nullptr);
+
+        JsonObject parameters;
+        for (const string& text : Corpus) {
+            current = text;
+            JsonValue response;
+            EXPECT_EQ(transport->Invoke(_T("test.corpus"), parameters, response), Firebolt::Error::None);
+            string received;
+            response.ToString(received);
+            EXPECT_EQ(received, Canonical(text));
+        }
+
+        current = list;
+        JsonValue response;
+        EXPECT_EQ(transport->Invoke(_T("test.corpus"), parameters, response), Firebolt::Error::None);
+        string received;
+        response.ToString(received);
+        EXPECT_EQ(received.size(), Canonical(list).size());
+    }
+
+    // A MessagePack transport hands the packed results to the response as they are
+    TEST(Encoding, MessagePackCorpusRoundTrips)
+    {
+        using PackTransport = Transport<WPEFramework::Core::JSON::IMessagePack>;
+
+        string current;
+        const PackTransport::Listener ignore = [](const bool, const Firebolt::Error) {};
+        PackTransport transport([&current](const Server::Message&, Server::Message& response) {
+            response.Result = current;
+            return true;
+        }, UnitEnvironment::WaitTime, ignore);
+        ASSERT_TRUE(WaitFor([&transport]() { return (transport.IsOpen() == true); }));
+        EXPECT_STREQ(transport.Protocol(), _T("MessagePack"));
+
+        JsonObject parameters;
+        for (const string& text : Corpus) {
+            current = Packed(text);
+            JsonObject response;
+            EXPECT_EQ(transport.Invoke(_T("test.corpus"), parameters, response), Firebolt::Error::None);
+            string received;
+            response.ToString(received);
+            EXPECT_EQ(received, Canonical(Wrapped(text)));
+        }
+
+        // Larger than the 64 KiB Deserialize takes at once
+        const string list = List(4000);
+        current = Packed(list);
+        ASSERT_GT(current.size(), 65536u);
+        JsonObject response;
+        EXPECT_EQ(transport.Invoke(_T("test.corpus"), parameters, response), Firebolt::Error::None);
+        string received;
+        response.ToString(received);
+        EXPECT_EQ(received.size(), Canonical(Wrapped(list)).size());
+    }
+
+    // The server takes JSON only: the MessagePack transport settles on JSON and works on
+    TEST(Encoding, MessagePackFallsBackToJSON)
+    {
+        using PackTransport = Transport<WPEFramework::Core::JSON::IMessagePack>;
+
+        SocketServer server(WPEFramework::Core::NodeId(_T("127.0.0.1"), 19993));
+        ASSERT_EQ(server.Open(), WPEFramework::Core::ERROR_NONE);
+
+        Server::Scope scope([](const Server::Message&, Server::Message& response) {
+            response.Result = Wrapped(Corpus[3]);
+            return true;
+        });
+
+        const PackTransport::Listener ignore = [](const bool, const Firebolt::Error) {};
+        std::shared_ptr<PackTransport> transport = std::make_shared<PackTransport>(_T("ws://127.0.0.1:19993"), UnitEnvironment::WaitTime, ignore);
+        ASSERT_TRUE(WaitFor([&transport]() { return ((transport->IsOpen() == true) && (strcmp(transport->Protocol(), _T("JSON")) == 0)); }));
+
+        JsonObject parameters;
+        JsonObject response;
+        EXPECT_EQ(transport->Invoke(_T("test.corpus"), parameters, response), Firebolt::Error::None);
+        string received;
+        response.ToString(received);
+        EXPECT_EQ(received, Canonical(Wrapped(Corpus[3])));
+
+        transport.reset();
+        server.Close();
+    }
+
+    // Both encodings on the same corpus: the size on the wire, and the cost per message
+    TEST(Encoding, CorpusBenchmark)
+    {
+        static constexpr uint32_t Rounds = 10000;
+
+        struct Cost {
+            uint32_t bytes;
+            uint64_t parse;
+            uint64_t serialize;
+        };
+        Cost json = {};
+        Cost pack = {};
+        uint32_t messages = 0;
+        for (const string& text : Corpus) {
+            JsonObject value;
+            value.FromString(Wrapped(text));
+
+            string out;
+            std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            for (uint32_t round = 0; round < Rounds; ++round) {
+                out.clear();
+                value.ToString(out);
+            }
+            json.serialize += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+            begin = std::chrono::steady_clock::now();
+            for (uint32_t round = 0; round < Rounds; ++round) {
+                value.FromString(out);
+            }
+            json.parse += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+            json.bytes += static_cast<uint32_t>(out.size());
+
+            std::vector<uint8_t> buffer;
+            begin = std::chrono::steady_clock::now();
+            for (uint32_t round = 0; round < Rounds; ++round) {
+                buffer.clear();
+                value.ToBuffer(buffer);
+            }
+            pack.serialize += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+            begin = std::chrono::steady_clock::now();
+            for (uint32_t round = 0; round < Rounds; ++round) {
+                value.FromBuffer(buffer);
+            }
+            pack.parse += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+            pack.bytes += static_cast<uint32_t>(buffer.size());
+
+            // Either way the same value comes out
+            string decoded;
+            value.ToString(decoded);
+            EXPECT_EQ(decoded, Canonical(Wrapped(text)));
+
+            ++messages;
+        }
+
+        printf("JSON corpus: %u messages, %u bytes, parse %.0f ns, serialize %.0f ns per message\n",
+            messages, json.bytes, static_cast<double>(json.parse) / (Rounds * messages), static_cast<double>(json.serialize) / (Rounds * messages));
+        printf("MessagePack corpus: %u messages, %u bytes, parse %.0f ns, serialize %.0f ns per message\n",
+            messages, pack.bytes, static_cast<double>(pack.parse) / (Rounds * messages), static_cast<double>(pack.serialize) / (Rounds * messages));
+    }
+}
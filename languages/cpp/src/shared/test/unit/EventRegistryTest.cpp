@@ -0,0 +1,109 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Transport/EventRegistry.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace FireboltSDK {
+
+    TEST(EventRegistry, FindsTheEventOfANotification)
+    {
+        EventRegistry<> registry;
+        EXPECT_TRUE(registry.Add(1, "device.onNameChanged", "{\"listen\":true}"));
+        EXPECT_FALSE(registry.Add(1, "device.onNameChanged", "{\"listen\":true}"));
+
+        std::string eventName;
+        EXPECT_TRUE(registry.Find(1, eventName));
+        EXPECT_EQ(eventName, "device.onNameChanged");
+        EXPECT_FALSE(registry.Find(2, eventName));
+
+        EXPECT_TRUE(registry.Remove(1));
+        EXPECT_FALSE(registry.Find(1, eventName));
+    }
+
+    TEST(EventRegistry, StopsOnlyTheSubscriptionOfItsRequest)
+    {
+        EventRegistry<> registry;
+        registry.Add(1, "device.onNameChanged", "{\"listen\":true}");
+        registry.Add(2, "device.onNameChanged", "{\"room\":\"kitchen\",\"listen\":true}");
+        registry.Add(3, "device.onVolumeChanged", "{\"listen\":true}");
+
+        std::string eventName;
+        registry.Remove("device.onNameChanged", "{\"listen\":true}");
+        EXPECT_FALSE(registry.Find(1, eventName));
+        EXPECT_TRUE(registry.Find(2, eventName));
+        EXPECT_TRUE(registry.Find(3, eventName));
+
+        registry.Remove("device.onNameChanged");
+        EXPECT_FALSE(registry.Find(2, eventName));
+        EXPECT_TRUE(registry.Find(3, eventName));
+    }
+
+    TEST(EventRegistry, HoldsMoreThanItsCapacity)
+    {
+        EventRegistry<4> registry;
+        for (uint32_t id = 1; id <= 16; ++id) {
+            EXPECT_TRUE(registry.Add(id, "event." + std::to_string(id), "{}"));
+        }
+        for (uint32_t id = 1; id <= 16; ++id) {
+            std::string eventName;
+            EXPECT_TRUE(registry.Find(id, eventName));
+            EXPECT_EQ(eventName, "event." + std::to_string(id));
+        }
+        registry.Remove("event.9", "{}");
+        std::string eventName;
+        EXPECT_FALSE(registry.Find(9, eventName));
+    }
+
+    // Notifications are looked up while subscriptions come and go
+    TEST(EventRegistry, FindsWhileSubscriptionsChange)
+    {
+        static constexpr uint32_t Rounds = 20000;
+
+        EventRegistry<> registry;
+        registry.Add(1, "device.onNameChanged", "{}");
+
+        std::atomic<bool> done(false);
+        std::atomic<uint32_t> wrong(0);
+        std::thread reader([&]() {
+            std::string eventName;
+            while (done.load() == false) {
+                if ((registry.Find(1, eventName) == false) || (eventName != "device.onNameChanged")) {
+                    wrong++;
+                }
+                if ((registry.Find(2, eventName) == true) && (eventName != "device.onVolumeChanged")) {
+                    wrong++;
+                }
+            }
+        });
+
+        for (uint32_t round = 0; round < Rounds; ++round) {
+            registry.Add(2, "device.onVolumeChanged", "{}");
+            registry.Remove("device.onVolumeChanged", "{}");
+        }
+        done = true;
+        reader.join();
+
+        EXPECT_EQ(wrong.load(), 0u);
+    }
+}
@@ -0,0 +1,479 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace FireboltSDK {
+
+    namespace {
+        // Acknowledges subscriptions and counts how often listening was switched on and off
+        class Listens {
+        public:
+            Listens()
+                : on(0)
+                , off(0)
+            {
+            }
+
+            Server::Responder Responder()
+            {
+                return [this](const Server::Message& request, Server::Message& response) {
+                    const bool listen = (request.Parameters.Value().find(_T("\"listen\":true")) != string::npos);
+                    if (listen == false) {
+                        std::lock_guard<std::mutex> guard(lock);
+                        stopped.push_back(request.Parameters.Value());
+                    }
+                    (listen == true ? on : off)++;
+                    response.Result = string(_T("{\"listening\":")) + (listen == true ? _T("true") : _T("false")) + _T(",\"event\":\"") + request.Designator.Value() + _T("\"}");
+                    return true;
+                };
+            }
+
+            bool WaitForOn(const uint32_t expected)
+            {
+                const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(UnitEnvironment::WaitTime);
+                while ((on.load() < expected) && (std::chrono::steady_clock::now() < end)) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                }
+                return (on.load() == expected);
+            }
+
+            // The parameters of what was stopped, in order
+            std::vector<string> Stopped()
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                return (stopped);
+            }
+
+            std::atomic<uint32_t> on;
+            std::atomic<uint32_t> off;
+            std::mutex lock;
+            std::vector<string> stopped;
+        };
+
+        void Ignore(void*, const void*, void*)
+        {
+        }
+
+        Firebolt::Error Listen(const string& eventName, void* usercb, void (*callback)(void*, const void*, void*) = Ignore)
+        {
+            JsonObject parameters;
+            return (Event::Instance().Subscribe<WPEFramework::Core::JSON::String>(eventName, parameters, callback, usercb, nullptr));
+        }
+
+        Firebolt::Error ListenWith(const string& eventName, const string& parameters, void* usercb, void (*callback)(void*, const void*, void*) = Ignore)
+        {
+            JsonObject jsonParameters;
+            jsonParameters.FromString(parameters);
+            return (Event::Instance().Subscribe<WPEFramework::Core::JSON::String>(eventName, jsonParameters, callback, usercb, nullptr));
+        }
+
+        // What one listener was handed
+        struct Seen {
+            Seen()
+                : value()
+                , object(nullptr)
+                , calls(0)
+            {
+            }
+
+            string value;
+            const void* object;
+            std::atomic<uint32_t> calls;
+        };
+
+        void Record(void* usercb, const void*, void* parameters)
+        {
+            WPEFramework::Core::ProxyType<WPEFramework::Core::JSON::String>& inbound = *static_cast<WPEFramework::Core::ProxyType<WPEFramework::Core::JSON::String>*>(parameters);
+            Seen& seen = *static_cast<Seen*>(usercb);
+            seen.value = inbound->Value();
+            seen.object = static_cast<const void*>(inbound.operator->());
+            seen.calls++;
+        }
+
+        void Count(void* usercb, const void*, void*)
+        {
+            static_cast<Seen*>(usercb)->calls++;
+        }
+
+        class Playback : public WPEFramework::Core::JSON::Container {
+        public:
+            Playback(const Playback&) = delete;
+            Playback& operator=(const Playback&) = delete;
+
+            Playback()
+                : WPEFramework::Core::JSON::Container()
+                , State()
+                , Position()
+            {
+                Add(_T("state"), &State);
+                Add(_T("position"), &Position);
+            }
+            ~Playback() override = default;
+
+        public:
+            WPEFramework::Core::JSON::String State;
+            WPEFramework::Core::JSON::DecUInt32 Position;
+        };
+
+        // What a Playback listener was handed last
+        struct Played {
+            Played()
+                : object(nullptr)
+                , positionSet(false)
+                , calls(0)
+            {
+            }
+
+            const void* object;
+            bool positionSet;
+            std::atomic<uint32_t> calls;
+        };
+
+        void RecordPlayback(void* usercb, const void*, void* parameters)
+        {
+            WPEFramework::Core::ProxyType<Playback>& inbound = *static_cast<WPEFramework::Core::ProxyType<Playback>*>(parameters);
+            Played& played = *static_cast<Played*>(usercb);
+            played.object = static_cast<const void*>(inbound.operator->());
+            played.positionSet = inbound->Position.IsSet();
+            played.calls++;
+        }
+
+        // The callback has run, the dispatch still has to let go of the object: give it a moment
+        bool Released(const Played& played, const uint32_t expected)
+        {
+            const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(UnitEnvironment::WaitTime);
+            while ((played.calls.load() < expected) && (std::chrono::steady_clock::now() < end)) {
+                std::this_thread::yield();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            return (played.calls.load() == expected);
+        }
+
+        // Notifications are dispatched from the worker pool, give them the wait time to arrive
+        bool Delivered(const Seen seen[], const uint32_t listeners, const uint32_t expected)
+        {
+            const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(UnitEnvironment::WaitTime);
+            uint32_t index = 0;
+            while ((index < listeners) && (std::chrono::steady_clock::now() < end)) {
+                if (seen[index].calls.load() >= expected) {
+                    ++index;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            return (index == listeners);
+        }
+    }
+
+    TEST(Event, OnlyTheFirstListenerSubscribes)
+    {
+        Listens listens;
+        Server::Scope scope(listens.Responder());
+        int first = 0, second = 0;
+
+        EXPECT_EQ(Listen(_T("test.onRefcounted"), &first), Firebolt::Error::None);
+        EXPECT_EQ(Listen(_T("test.onRefcounted"), &second), Firebolt::Error::None);
+        EXPECT_EQ(listens.on.load(), 1u);
+
+        // The same listener twice is refused, and does not count
+        EXPECT_NE(Listen(_T("test.onRefcounted"), &second), Firebolt::Error::None);
+
+        EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onRefcounted"), &first), Firebolt::Error::None);
+        EXPECT_EQ(listens.off.load(), 0u);
+        EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onRefcounted"), &second), Firebolt::Error::None);
+        EXPECT_EQ(listens.off.load(), 1u);
+
+        // Gone for good: a new listener is the first again
+        EXPECT_EQ(Listen(_T("test.onRefcounted"), &first), Firebolt::Error::None);
+        EXPECT_EQ(listens.on.load(), 2u);
+        EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onRefcounted"), &first), Firebolt::Error::None);
+    }
+
+    TEST(Event, FailedSubscriptionIsRevoked)
+    {
+        Server::Scope scope([](const Server::Message&, Server::Message& response) {
+            response.Error.Code = static_cast<int32_t>(Firebolt::Error::CapabilityNotPermitted);
+            response.Error.Text = _T("Not permitted");
+            return true;
+        });
+        int listener = 0;
+
+        EXPECT_EQ(Listen(_T("test.onRefused"), &listener), Firebolt::Error::CapabilityNotPermitted);
+        // Nothing left behind that would stop the next attempt from subscribing
+        Listens listens;
+        Server::Scope accept(listens.Responder());
+        EXPECT_EQ(Listen(_T("test.onRefused"), &listener), Firebolt::Error::None);
+        EXPECT_EQ(listens.on.load(), 1u);
+        EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onRefused"), &listener), Firebolt::Error::None);
+    }
+
+    TEST(Event, ListenersSubscribeAgainAfterReconnect)
+    {
+        Listens listens;
+        Server::Scope scope(listens.Responder());
+        int first = 0, second = 0, other = 0;
+
+        EXPECT_EQ(Listen(_T("test.onReconnected"), &first), Firebolt::Error::None);
+        EXPECT_EQ(Listen(_T("test.onOther"), &other), Firebolt::Error::None);
+        EXPECT_EQ(listens.on.load(), 2u);
+
+        ASSERT_TRUE(UnitEnvironment::Reconnect());
+        // Once per event, on the new connection
+        EXPECT_TRUE(listens.WaitForOn(4));
+
+        // Still counted as listening: joining does not subscribe again
+        EXPECT_EQ(Listen(_T("test.onReconnected"), &second), Firebolt::Error::None);
+        EXPECT_EQ(listens.on.load(), 4u);
+
+        EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onReconnected"), &first), Firebolt::Error::None);
+        EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onReconnected"), &second), Firebolt::Error::None);
+        EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onOther"), &other), Firebolt::Error::None);
+        EXPECT_EQ(listens.off.load(), 2u);
+    }
+
+    TEST(Event, ListenersShareOneParsedPayload)
+    {
+        static constexpr uint8_t Listeners = 3;
+
+        Listens listens;
+        Server::Scope scope(listens.Responder());
+        Seen seen[Listeners];
+
+        for (Seen& listener : seen) {
+            ASSERT_EQ(Listen(_T("test.onParsed"), &listener, Record), Firebolt::Error::None);
+        }
+        ASSERT_TRUE(Server::Instance().Notify(_T("test.onParsed"), _T("\"parsed once\"")));
+        ASSERT_TRUE(Delivered(seen, Listeners, 1));
+
+        for (const Seen& listener : seen) {
+            EXPECT_EQ(listener.calls.load(), 1u);
+            EXPECT_EQ(listener.value, _T("parsed once"));
+            // One object, handed to all of them
+            EXPECT_EQ(listener.object, seen[0].object);
+        }
+
+        for (Seen& listener : seen) {
+            EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onParsed"), &listener), Firebolt::Error::None);
+        }
+    }
+
+    // Past the types kept in place, a payload still parses each type once
+    TEST(Event, PayloadKeepsEveryTypeItWasAskedFor)
+    {
+        Server::Message message;
+        message.Result = _T("42");
+        Event::Payload payload(message);
+
+        const void* first[6] = {
+            payload.Get<WPEFramework::Core::JSON::DecUInt8>().operator->(),
+            payload.Get<WPEFramework::Core::JSON::DecUInt16>().operator->(),
+            payload.Get<WPEFramework::Core::JSON::DecUInt32>().operator->(),
+            payload.Get<WPEFramework::Core::JSON::DecUInt64>().operator->(),
+            payload.Get<WPEFramework::Core::JSON::DecSInt32>().operator->(),
+            payload.Get<WPEFramework::Core::JSON::DecSInt64>().operator->()
+        };
+
+        EXPECT_EQ(payload.Get<WPEFramework::Core::JSON::DecUInt8>()->Value(), 42u);
+        EXPECT_EQ(payload.Get<WPEFramework::Core::JSON::DecUInt32>()->Value(), 42u);
+        EXPECT_EQ(payload.Get<WPEFramework::Core::JSON::DecSInt32>()->Value(), 42);
+        EXPECT_EQ(payload.Get<WPEFramework::Core::JSON::DecSInt64>()->Value(), 42);
+
+        EXPECT_EQ(payload.Get<WPEFramework::Core::JSON::DecUInt8>().operator->(), first[0]);
+        EXPECT_EQ(payload.Get<WPEFramework::Core::JSON::DecUInt16>().operator->(), first[1]);
+        EXPECT_EQ(payload.Get<WPEFramework::Core::JSON::DecUInt32>().operator->(), first[2]);
+        EXPECT_EQ(payload.Get<WPEFramework::Core::JSON::DecUInt64>().operator->(), first[3]);
+        EXPECT_EQ(payload.Get<WPEFramework::Core::JSON::DecSInt32>().operator->(), first[4]);
+        EXPECT_EQ(payload.Get<WPEFramework::Core::JSON::DecSInt64>().operator->(), first[5]);
+    }
+
+    // Once a notification is done with, the next one is parsed into the same object
+    TEST(Event, NotificationsReusePooledObjects)
+    {
+        static constexpr uint32_t Notifications = 20;
+
+        Listens listens;
+        Server::Scope scope(listens.Responder());
+        Played played;
+        JsonObject parameters;
+        ASSERT_EQ((Event::Instance().Subscribe<Playback>(_T("test.onPooled"), parameters, RecordPlayback, &played, nullptr)), Firebolt::Error::None);
+
+        const void* first = nullptr;
+        for (uint32_t index = 1; index <= Notifications; ++index) {
+            ASSERT_TRUE(Server::Instance().Notify(_T("test.onPooled"), _T("{\"state\":\"playing\",\"position\":") + std::to_string(index) + _T("}")));
+            ASSERT_TRUE(Released(played, index));
+            if (first == nullptr) {
+                first = played.object;
+            }
+            EXPECT_EQ(played.object, first);
+        }
+
+        EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onPooled"), &played), Firebolt::Error::None);
+    }
+
+    // A pooled object keeps nothing from the notification it was used for before
+    TEST(Event, PooledObjectsAreClearedBeforeReuse)
+    {
+        Listens listens;
+        Server::Scope scope(listens.Responder());
+        Played played;
+        JsonObject parameters;
+        ASSERT_EQ((Event::Instance().Subscribe<Playback>(_T("test.onCleared"), parameters, RecordPlayback, &played, nullptr)), Firebolt::Error::None);
+
+        ASSERT_TRUE(Server::Instance().Notify(_T("test.onCleared"), _T("{\"state\":\"playing\",\"position\":12}")));
+        ASSERT_TRUE(Released(played, 1));
+        EXPECT_TRUE(played.positionSet);
+        const void* first = played.object;
+
+        ASSERT_TRUE(Server::Instance().Notify(_T("test.onCleared"), _T("{\"state\":\"stopped\"}")));
+        ASSERT_TRUE(Released(played, 2));
+        EXPECT_EQ(played.object, first);
+        EXPECT_FALSE(played.positionSet);
+
+        EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onCleared"), &played), Firebolt::Error::None);
+    }
+
+    // Not a pass/fail on speed: with the payload parsed once, the cost per notification should
+    // hardly grow with the number of listeners
+    TEST(Event, FanOutBenchmark)
+    {
+        static constexpr uint32_t Notifications = 2000;
+
+        Listens listens;
+        Server::Scope scope(listens.Responder());
+
+        for (const uint32_t listeners : { 1u, 8u, 64u }) {
+            std::unique_ptr<Seen[]> seen(new Seen[listeners]);
+            for (uint32_t index = 0; index < listeners; ++index) {
+                ASSERT_EQ(Listen(_T("test.onFanOut"), &seen[index], Count), Firebolt::Error::None);
+            }
+
+            const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            for (uint32_t index = 0; index < Notifications; ++index) {
+                Server::Instance().Notify(_T("test.onFanOut"), _T("\"playing\""));
+            }
+            EXPECT_TRUE(Delivered(seen.get(), listeners, Notifications));
+            const double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+
+            printf("Event: %u listeners: %.2f us per notification\n", listeners, elapsed / Notifications);
+
+            for (uint32_t index = 0; index < listeners; ++index) {
+                EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onFanOut"), &seen[index]), Firebolt::Error::None);
+            }
+        }
+    }
+
+    // 10k notifications a second, one every 100us, for a second, next to 256 other subscribed events.
+    // Not a pass/fail on speed: it prints how long the last one took to come through after the last was sent.
+    TEST(Event, TenThousandPerSecondBenchmark)
+    {
+        static constexpr uint32_t Rate = 10000;
+        static constexpr uint32_t Others = 256;
+
+        Listens listens;
+        Server::Scope scope(listens.Responder());
+
+        std::unique_ptr<Seen[]> others(new Seen[Others]);
+        for (uint32_t index = 0; index < Others; ++index) {
+            ASSERT_EQ(Listen(_T("test.onOther") + std::to_string(index), &others[index], Count), Firebolt::Error::None);
+        }
+
+        for (const uint32_t listeners : { 1u, 16u }) {
+            std::unique_ptr<Seen[]> seen(new Seen[listeners]);
+            for (uint32_t index = 0; index < listeners; ++index) {
+                ASSERT_EQ(Listen(_T("test.onRate"), &seen[index], Count), Firebolt::Error::None);
+            }
+
+            const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            for (uint32_t index = 0; index < Rate; ++index) {
+                const std::chrono::steady_clock::time_point due = begin + std::chrono::microseconds(index * (1000000 / Rate));
+                while (std::chrono::steady_clock::now() < due) {
+                    std::this_thread::yield();
+                }
+                Server::Instance().Notify(_T("test.onRate"), _T("\"playing\""));
+            }
+            const std::chrono::steady_clock::time_point sent = std::chrono::steady_clock::now();
+            EXPECT_TRUE(Delivered(seen.get(), listeners, Rate));
+            const std::chrono::steady_clock::time_point delivered = std::chrono::steady_clock::now();
+
+            printf("Event: %u/s to %u listeners: sent in %.0f ms, all delivered %.2f ms later\n", Rate, listeners,
+                std::chrono::duration<double, std::milli>(sent - begin).count(),
+                std::chrono::duration<double, std::milli>(delivered - sent).count());
+
+            for (uint32_t index = 0; index < listeners; ++index) {
+                EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onRate"), &seen[index]), Firebolt::Error::None);
+            }
+        }
+
+        for (uint32_t index = 0; index < Others; ++index) {
+            EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onOther") + std::to_string(index), &others[index]), Firebolt::Error::None);
+            EXPECT_EQ(others[index].calls.load(), 0u);
+        }
+    }
+
+    // Listeners with other parameters are separate subscriptions, each stopped on its own
+    TEST(Event, UnsubscribeStopsItsOwnParameters)
+    {
+        Listens listens;
+        Server::Scope scope(listens.Responder());
+        Seen first, second;
+
+        EXPECT_EQ(ListenWith(_T("test.onKeyed"), _T("{\"appId\":\"first\"}"), &first, Count), Firebolt::Error::None);
+        EXPECT_EQ(ListenWith(_T("test.onKeyed"), _T("{\"appId\":\"second\"}"), &second, Count), Firebolt::Error::None);
+        EXPECT_EQ(listens.on.load(), 2u);
+
+        EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onKeyed"), &first), Firebolt::Error::None);
+        ASSERT_EQ(listens.off.load(), 1u);
+        const std::vector<string> stopped = listens.Stopped();
+        EXPECT_NE(stopped[0].find(_T("\"appId\":\"first\"")), string::npos);
+        EXPECT_NE(stopped[0].find(_T("\"listen\":false")), string::npos);
+
+        // The other subscription still delivers
+        ASSERT_TRUE(Server::Instance().Notify(_T("test.onKeyed"), _T("\"still\"")));
+        EXPECT_TRUE(Delivered(&second, 1, 1));
+        EXPECT_EQ(first.calls.load(), 0u);
+
+        EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onKeyed"), &second), Firebolt::Error::None);
+        ASSERT_EQ(listens.off.load(), 2u);
+        EXPECT_NE(listens.Stopped()[1].find(_T("\"appId\":\"second\"")), string::npos);
+    }
+
+    TEST(Event, UnknownListenerIsNotSubscribed)
+    {
+        Listens listens;
+        Server::Scope scope(listens.Responder());
+        int listener = 0, stranger = 0;
+
+        EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onNobody"), &stranger), Firebolt::Error::NotSubscribed);
+
+        EXPECT_EQ(Listen(_T("test.onSomebody"), &listener), Firebolt::Error::None);
+        EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onSomebody"), &stranger), Firebolt::Error::NotSubscribed);
+        EXPECT_EQ(listens.off.load(), 0u);
+
+        EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onSomebody"), &listener), Firebolt::Error::None);
+        EXPECT_EQ(Event::Instance().Unsubscribe(_T("test.onSomebody"), &listener), Firebolt::Error::NotSubscribed);
+        EXPECT_EQ(listens.off.load(), 1u);
+    }
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+#include "json_engine.h"
+
+#include <gtest/gtest-spi.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+namespace FireboltSDK {
+
+    namespace {
+        static constexpr const char* OpenRpc = R"({
+            "openrpc": "1.2.4",
+            "methods": [
+                {
+                    "name": "Device.name",
+                    "params": [],
+                    "examples": [ { "name": "Default", "params": [], "result": { "name": "Default", "value": "living room" } } ]
+                },
+                {
+                    "name": "Device.onNameChanged",
+                    "tags": [ { "name": "event" } ],
+                    "params": [ { "name": "listen", "schema": { "type": "boolean" } } ],
+                    "examples": [ { "name": "Default", "params": [], "result": { "name": "Default", "value": "kitchen" } } ]
+                },
+                {
+                    "name": "Device.setVolume",
+                    "params": [ { "name": "value", "schema": { "$ref": "#/components/schemas/Volume" } } ],
+                    "examples": [ { "name": "Default", "params": [], "result": { "name": "Default", "value": null } } ]
+                },
+                {
+                    "name": "Device.setBroken",
+                    "params": [ { "name": "value", "schema": { "$ref": "#/components/schemas/Missing" } } ]
+                }
+            ],
+            "components": {
+                "schemas": {
+                    "Volume": { "type": "integer", "minimum": 0, "maximum": 100 }
+                }
+            }
+        })";
+
+        // The engine of a document of its own, next to the one the Server answers from
+        const JsonEngine& Engine()
+        {
+            static const char* fileName = "/tmp/firebolt-unit-openrpc.json";
+            static const JsonEngine engine = [](const char* name) {
+                std::ofstream file(name);
+                file << OpenRpc;
+                file.close();
+                return JsonEngine(name);
+            }(fileName);
+            return (engine);
+        }
+
+        void Request(Server::Message& message, const string& method, const string& parameters)
+        {
+            message.Clear();
+            message.Id = 1;
+            message.Designator = method;
+            message.Parameters = parameters;
+        }
+
+        // What the Server does with a request it answers from the document
+        bool Respond(const Server::Message& request, Server::Message& response)
+        {
+            MockRequest(Engine(), request);
+            return (MockResponse(Engine(), request, response));
+        }
+    }
+
+    TEST(JsonEngine, FindsMethodsByName)
+    {
+        EXPECT_EQ(Engine().get_value(_T("Device.name")), _T("\"living room\""));
+        EXPECT_EQ(Engine().get_value(_T("Device.setVolume")), _T("null"));
+        EXPECT_EQ(Engine().get_value(_T("Device.unknown")), _T(""));
+    }
+
+    TEST(JsonEngine, TellsEventsApart)
+    {
+        EXPECT_TRUE(Engine().is_event(_T("Device.onNameChanged")));
+        EXPECT_FALSE(Engine().is_event(_T("Device.name")));
+        EXPECT_FALSE(Engine().is_event(_T("Device.unknown")));
+    }
+
+    TEST(JsonEngine, AnswersFromTheExamples)
+    {
+        Server::Message request;
+        Server::Message response;
+        Request(request, _T("device.name"), _T("{}"));
+        EXPECT_TRUE(Respond(request, response));
+        EXPECT_EQ(response.Result.Value(), _T("\"living room\""));
+        EXPECT_FALSE(response.Error.IsSet());
+    }
+
+    TEST(JsonEngine, AcknowledgesListening)
+    {
+        Server::Message request;
+        Server::Message response;
+        Request(request, _T("device.onNameChanged"), _T("{\"listen\":false}"));
+        EXPECT_TRUE(Respond(request, response));
+
+        const json result = json::parse(response.Result.Value());
+        EXPECT_EQ(result["listening"], false);
+        EXPECT_EQ(result["event"], "device.onNameChanged");
+    }
+
+    TEST(JsonEngine, UnknownMethodIsNotFound)
+    {
+        Server::Message request;
+        Server::Message response;
+        Request(request, _T("device.unknown"), _T("{}"));
+        EXPECT_TRUE(Respond(request, response));
+        EXPECT_EQ(response.Error.Code.Value(), -32601);
+        EXPECT_FALSE(response.Result.IsSet());
+    }
+
+    TEST(JsonEngine, ValidatesParametersAgainstResolvedReferences)
+    {
+        Server::Message request;
+        Server::Message response;
+
+        Request(request, _T("device.setVolume"), _T("{\"value\":42}"));
+        EXPECT_TRUE(Respond(request, response));
+
+        // Out of range, and a parameter whose $ref leads nowhere: both reported as failures
+        const string rejected[2][2] = {
+            { _T("device.setVolume"), _T("{\"value\":101}") },
+            { _T("device.setBroken"), _T("{\"value\":1}") }
+        };
+        for (const string (&call)[2] : rejected) {
+            ::testing::TestPartResultArray failures;
+            {
+                ::testing::ScopedFakeTestPartResultReporter reporter(::testing::ScopedFakeTestPartResultReporter::INTERCEPT_ONLY_CURRENT_THREAD, &failures);
+                Request(request, call[0], call[1]);
+                Respond(request, response);
+            }
+            ASSERT_EQ(failures.size(), 1);
+            EXPECT_NE(string(failures.GetTestPartResult(0).message()).find("Schema validation error"), string::npos);
+        }
+    }
+
+    TEST(JsonEngine, ExpandsReferences)
+    {
+        const json document = json::parse(OpenRpc);
+        const json expanded = JsonEngine::process_schema(document["methods"][2]["params"][0], document);
+        EXPECT_EQ(expanded["schema"]["maximum"], 100);
+        EXPECT_FALSE(expanded["schema"].contains("$ref"));
+
+        EXPECT_THROW(JsonEngine::resolve_reference(document, "#/components/schemas/Missing"), std::invalid_argument);
+        EXPECT_THROW(JsonEngine::resolve_reference(document, "other.json#/Volume"), std::invalid_argument);
+    }
+
+    // Not a pass/fail on speed: one hash lookup and a validator compiled up front per request
+    TEST(JsonEngine, RespondBenchmark)
+    {
+        static constexpr uint32_t Requests = 100000;
+
+        Server::Message request;
+        Server::Message response;
+        Request(request, _T("device.setVolume"), _T("{\"value\":42}"));
+
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        for (uint32_t index = 0; index < Requests; ++index) {
+            response.Clear();
+            Respond(request, response);
+        }
+        const uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+        printf("JsonEngine: %.0f ns per request\n", static_cast<double>(elapsed) / Requests);
+    }
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include <unistd.h>
+
+namespace FireboltSDK {
+
+    namespace {
+        // Keeps a worker busy until the gate opens
+        class Busy : public WPEFramework::Core::IDispatch {
+        public:
+            Busy() = delete;
+            Busy(const Busy&) = delete;
+            Busy& operator=(const Busy&) = delete;
+
+            Busy(WPEFramework::Core::Event& gate, std::atomic<uint32_t>& started)
+                : _gate(gate)
+                , _started(started)
+            {
+            }
+            ~Busy() override = default;
+
+        public:
+            void Dispatch() override
+            {
+                ++_started;
+                _gate.Lock(WPEFramework::Core::infinite);
+            }
+
+        private:
+            WPEFramework::Core::Event& _gate;
+            std::atomic<uint32_t>& _started;
+        };
+
+        bool WaitFor(const std::function<bool()>& condition)
+        {
+            const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(UnitEnvironment::WaitTime);
+            bool result = condition();
+            while ((result == false) && (std::chrono::steady_clock::now() < deadline)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                result = condition();
+            }
+            return (result);
+        }
+
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> Open(const string& url)
+        {
+            const Transport<WPEFramework::Core::JSON::IElement>::Listener ignore = [](const bool, const Firebolt::Error) {};
+            std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = std::make_shared<Transport<WPEFramework::Core::JSON::IElement>>(url, UnitEnvironment::WaitTime, ignore);
+            EXPECT_TRUE(WaitFor([&transport]() { return (transport->IsOpen() == true); }));
+            return (transport);
+        }
+
+        // Average time of a synchronous and of an a-synchronous call, one after the other, in us
+        void RoundTrips(Transport<WPEFramework::Core::JSON::IElement>& transport, const uint32_t calls, double& sync, double& async)
+        {
+            JsonObject parameters;
+            WPEFramework::Core::JSON::Boolean response;
+
+            std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            for (uint32_t index = 0; index < calls; ++index) {
+                EXPECT_EQ(transport.Invoke(_T("test.sync"), parameters, response), Firebolt::Error::None);
+            }
+            sync = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count() / calls;
+
+            WPEFramework::Core::Event completed(false, false);
+            begin = std::chrono::steady_clock::now();
+            for (uint32_t index = 0; index < calls; ++index) {
+                EXPECT_EQ(transport.InvokeAsync(_T("test.async"), parameters, [&completed](const Firebolt::Error, const Server::Message&) {
+                    completed.SetEvent();
+                }), Firebolt::Error::None);
+                EXPECT_EQ(completed.Lock(UnitEnvironment::WaitTime), WPEFramework::Core::ERROR_NONE);
+            }
+            async = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count() / calls;
+        }
+    }
+
+    // A blocked caller is woken on the thread that read its response, the worker pool is not involved
+    TEST(Latency, SyncCallCompletesWithTheWorkerPoolBusy)
+    {
+        static constexpr uint32_t Jobs = 16; // more than the pool can ever have minions for
+
+        Server::Scope scope([](const Server::Message&, Server::Message& response) {
+            response.Result = _T("true");
+            return true;
+        });
+        SocketServer server(WPEFramework::Core::NodeId(_T("127.0.0.1"), 19996));
+        ASSERT_EQ(server.Open(), WPEFramework::Core::ERROR_NONE);
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = Open(_T("ws://127.0.0.1:19996"));
+
+        WPEFramework::Core::Event gate(false, true);
+        std::atomic<uint32_t> started(0);
+        for (uint32_t index = 0; index < Jobs; ++index) {
+            WPEFramework::Core::IWorkerPool::Instance().Submit(WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>(WPEFramework::Core::ProxyType<Busy>::Create(gate, started)));
+        }
+        // Every minion there is, is taken
+        const uint32_t threads = Accessor::Instance().GetWorkerPoolMetrics().threads;
+        ASSERT_TRUE(WaitFor([&started, threads]() { return (started.load() >= threads); }));
+
+        JsonObject parameters;
+        WPEFramework::Core::JSON::Boolean response;
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        EXPECT_EQ(transport->Invoke(_T("test.busy"), parameters, response), Firebolt::Error::None);
+        EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count(), UnitEnvironment::WaitTime);
+        EXPECT_TRUE(response.Value());
+        EXPECT_LT(started.load(), Jobs);
+
+        gate.SetEvent();
+        EXPECT_TRUE(WaitFor([&started]() { return (started.load() == Jobs); }));
+        transport.reset();
+    }
+
+    // Not a pass/fail on speed: a synchronous call skips the hop through the worker pool
+    // an a-synchronous one still takes
+    TEST(Latency, RoundTripBenchmark)
+    {
+        static constexpr uint32_t Calls = 2000;
+
+        Server::Scope scope([](const Server::Message&, Server::Message& response) {
+            response.Result = _T("true");
+            return true;
+        });
+        SocketServer server(WPEFramework::Core::NodeId(_T("127.0.0.1"), 19996));
+        ASSERT_EQ(server.Open(), WPEFramework::Core::ERROR_NONE);
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = Open(_T("ws://127.0.0.1:19996"));
+
+        double sync = 0;
+        double async = 0;
+        RoundTrips(*transport, Calls, sync, async);
+        printf("Round trip over tcp: synchronous %.1f us, a-synchronous %.1f us\n", sync, async);
+
+        transport.reset();
+    }
+
+    TEST(Latency, UnixSocketCarriesCalls)
+    {
+        const string path = _T("/tmp/firebolt-unit.sock");
+        ::unlink(path.c_str());
+
+        Server::Scope scope([](const Server::Message&, Server::Message& response) {
+            response.Result = _T("true");
+            return true;
+        });
+        SocketServer server(WPEFramework::Core::NodeId(path.c_str()));
+        ASSERT_EQ(server.Open(), WPEFramework::Core::ERROR_NONE);
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = Open(Transport<WPEFramework::Core::JSON::IElement>::UnixScheme + path);
+        ASSERT_TRUE(transport->IsOpen());
+
+        JsonObject parameters;
+        WPEFramework::Core::JSON::Boolean response;
+        EXPECT_EQ(transport->Invoke(_T("test.unix"), parameters, response), Firebolt::Error::None);
+        EXPECT_TRUE(response.Value());
+        EXPECT_EQ(Server::Instance().Requests(_T("test.unix")), 1u);
+
+        transport.reset();
+        server.Close();
+        ::unlink(path.c_str());
+    }
+
+    // Not a pass/fail on speed: the same websocket, over a unix domain socket instead of tcp
+    TEST(Latency, UnixVersusTcpBenchmark)
+    {
+        static constexpr uint32_t Calls = 2000;
+
+        const string path = _T("/tmp/firebolt-unit.sock");
+        ::unlink(path.c_str());
+
+        Server::Scope scope([](const Server::Message&, Server::Message& response) {
+            response.Result = _T("true");
+            return true;
+        });
+
+        const std::pair<WPEFramework::Core::NodeId, string> endpoints[2] = {
+            { WPEFramework::Core::NodeId(_T("127.0.0.1"), 19996), _T("ws://127.0.0.1:19996") },
+            { WPEFramework::Core::NodeId(path.c_str()), Transport<WPEFramework::Core::JSON::IElement>::UnixScheme + path }
+        };
+        for (const std::pair<WPEFramework::Core::NodeId, string>& endpoint : endpoints) {
+            SocketServer server(endpoint.first);
+            ASSERT_EQ(server.Open(), WPEFramework::Core::ERROR_NONE);
+            std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = Open(endpoint.second);
+
+            double sync = 0;
+            double async = 0;
+            RoundTrips(*transport, Calls, sync, async);
+            printf("Round trip over %s: synchronous %.1f us, a-synchronous %.1f us\n", endpoint.second.c_str(), sync, async);
+
+            transport.reset();
+        }
+
+        ::unlink(path.c_str());
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "Unit.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+// Logging stops for good once flushed, the tests that flush do so in a death test's child
+namespace FireboltSDK {
+
+    namespace {
+        class LoggerTest {
+        };
+
+        // Counts the lines of path that contain marker
+        uint32_t Lines(const string& path, const string& marker)
+        {
+            uint32_t result = 0;
+            std::ifstream file(path);
+            string line;
+            while (std::getline(file, line)) {
+                result += (line.find(marker) != string::npos ? 1 : 0);
+            }
+            return (result);
+        }
+    }
+
+    // A burst beyond what the ring holds is dropped, and counted, instead of blocking
+    TEST(Logger, FullRingDropsAndCounts)
+    {
+        static constexpr uint32_t Burst = 1000;
+
+        ASSERT_TRUE(Logger::IsEnabled(Logger::LogLevel::Info));
+        const uint32_t before = Logger::Dropped();
+
+        // A thread of its own, so the ring starts out empty
+        std::thread burst([]() {
+            for (uint32_t index = 0; index < Burst; ++index) {
+                FIREBOLT_LOG_INFO(Logger::Category::Core, Logger::Module<LoggerTest>(), "burst %u", index);
+            }
+        });
+        burst.join();
+
+        const uint32_t dropped = Logger::Dropped() - before;
+        EXPECT_GT(dropped, 0u);
+        EXPECT_LT(dropped, Burst);
+    }
+
+    TEST(LoggerDeathTest, WrittenOutAtExit)
+    {
+        GTEST_FLAG_SET(death_test_style, "threadsafe");
+
+        EXPECT_EXIT({
+            Logger::SetLogLevel(Logger::LogLevel::Info);
+            FIREBOLT_LOG_INFO(Logger::Category::Core, Logger::Module<LoggerTest>(), "the last words");
+            std::exit(0);
+        }, ::testing::ExitedWithCode(0), "the last words");
+    }
+
+    // Records published while Flush() stops the writer are either written or counted as dropped
+    TEST(LoggerDeathTest, NothingLostAroundFlush)
+    {
+        GTEST_FLAG_SET(death_test_style, "threadsafe");
+
+        static constexpr uint32_t Threads = 4;
+        static constexpr uint32_t Messages = 200;
+        const string path = ::testing::TempDir() + "logger_flush.txt";
+
+        EXPECT_EXIT({
+            Logger::SetLogLevel(Logger::LogLevel::Info);
+            if (freopen(path.c_str(), "w", stderr) == nullptr) {
+                std::exit(2);
+            }
+            const uint32_t before = Logger::Dropped();
+
+            std::vector<std::thread> loggers;
+            for (uint32_t thread = 0; thread < Threads; ++thread) {
+                loggers.emplace_back([]() {
+                    for (uint32_t index = 0; index < Messages; ++index) {
+                        FIREBOLT_LOG_INFO(Logger::Category::Core, Logger::Module<LoggerTest>(), "around flush %u", index);
+                    }
+                });
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            Logger::Flush();
+            for (std::thread& logger : loggers) {
+                logger.join();
+            }
+            fflush(stderr);
+
+            const uint32_t accounted = Lines(path, "around flush") + (Logger::Dropped() - before);
+            std::remove(path.c_str());
+            std::exit(accounted == (Threads * Messages) ? 0 : 1);
+        }, ::testing::ExitedWithCode(0), "");
+    }
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace FireboltSDK {
+
+    TEST(Loopback, AnswersFromTheResponder)
+    {
+        Server::Scope scope([](const Server::Message& request, Server::Message& response) {
+            response.Result = _T("\"") + request.Designator.Value() + _T("\"");
+            return true;
+        });
+
+        auto transport = Accessor::Instance().GetTransport();
+        ASSERT_NE(transport, nullptr);
+
+        JsonObject parameters;
+        WPEFramework::Core::JSON::String response;
+        EXPECT_EQ(transport->Invoke(_T("test.echo"), parameters, response), Firebolt::Error::None);
+        EXPECT_EQ(response.Value(), _T("test.echo"));
+    }
+
+    TEST(Loopback, UnknownMethodIsNotFound)
+    {
+        auto transport = Accessor::Instance().GetTransport();
+        ASSERT_NE(transport, nullptr);
+
+        JsonObject parameters;
+        JsonValue response;
+        EXPECT_EQ(transport->Invoke(_T("test.unknownMethod"), parameters, response), Firebolt::Error::MethodNotFound);
+    }
+
+    TEST(Loopback, CountsRequests)
+    {
+        Server::Scope scope([](const Server::Message&, Server::Message& response) {
+            response.Result = _T("null");
+            return true;
+        });
+        Server::Instance().Reset();
+
+        auto transport = Accessor::Instance().GetTransport();
+        ASSERT_NE(transport, nullptr);
+
+        JsonObject parameters;
+        JsonValue response;
+        for (uint8_t index = 0; index < 3; ++index) {
+            EXPECT_EQ(transport->Invoke(_T("test.count"), parameters, response), Firebolt::Error::None);
+        }
+        EXPECT_EQ(Server::Instance().Requests(_T("test.count")), 3u);
+    }
+
+    // Not a pass/fail on speed: whole calls, serialization and dispatch included, with no socket
+    // in between, next to the same calls to a local websocket server
+    TEST(Loopback, EndToEndBenchmark)
+    {
+        static constexpr uint32_t Calls = 10000;
+
+        Server::Scope scope([](const Server::Message&, Server::Message& response) {
+            response.Result = _T("{\"id\":\"123456789\",\"name\":\"living room\"}");
+            return true;
+        });
+        SocketServer server(WPEFramework::Core::NodeId(_T("127.0.0.1"), 19995));
+        ASSERT_EQ(server.Open(), WPEFramework::Core::ERROR_NONE);
+
+        const Transport<WPEFramework::Core::JSON::IElement>::Listener ignore = [](const bool, const Firebolt::Error) {};
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> socket = std::make_shared<Transport<WPEFramework::Core::JSON::IElement>>(_T("ws://127.0.0.1:19995"), UnitEnvironment::WaitTime, ignore);
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(UnitEnvironment::WaitTime);
+        while ((socket->IsOpen() == false) && (std::chrono::steady_clock::now() < deadline)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_TRUE(socket->IsOpen());
+
+        const std::pair<const char*, std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>>> transports[2] = {
+            { "loopback", Accessor::Instance().GetTransport() },
+            { "websocket", socket }
+        };
+        for (const std::pair<const char*, std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>>>& transport : transports) {
+            ASSERT_NE(transport.second, nullptr);
+            for (const uint32_t threads : { 1u, 4u }) {
+                const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+                std::vector<std::thread> callers;
+                for (uint32_t thread = 0; thread < threads; ++thread) {
+                    callers.emplace_back([&transport, threads]() {
+                        JsonObject parameters;
+                        JsonValue response;
+                        for (uint32_t index = 0; index < (Calls / threads); ++index) {
+                            EXPECT_EQ(transport.second->Invoke(_T("test.device"), parameters, response), Firebolt::Error::None);
+                        }
+                    });
+                }
+                for (std::thread& caller : callers) {
+                    caller.join();
+                }
+                const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+                printf("Loopback: %s, %u threads: %.0f calls/s\n", transport.first, threads, Calls / elapsed);
+            }
+        }
+
+        socket.reset();
+    }
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+#include "MockServer.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <thread>
+
+namespace FireboltSDK {
+
+    namespace {
+        static constexpr const char* OpenRpc = R"({
+            "openrpc": "1.2.4",
+            "methods": [
+                {
+                    "name": "Device.name",
+                    "params": [],
+                    "examples": [ { "name": "Default", "params": [], "result": { "name": "Default", "value": "living room" } } ]
+                },
+                {
+                    "name": "Device.onNameChanged",
+                    "tags": [ { "name": "event" } ],
+                    "params": [ { "name": "listen", "schema": { "type": "boolean" } } ],
+                    "examples": [ { "name": "Default", "params": [], "result": { "name": "Default", "value": "kitchen" } } ]
+                }
+            ]
+        })";
+
+        static constexpr uint16_t Port = 19994;
+
+        MockServer::Config Configuration()
+        {
+            static const char* fileName = "/tmp/firebolt-unit-mock-openrpc.json";
+            std::ofstream file(fileName);
+            file << OpenRpc;
+            file.close();
+
+            MockServer::Config config;
+            config.port = Port;
+            config.openRpc = fileName;
+            config.threads = 2;
+            return (config);
+        }
+
+        // Counts the notifications of the events subscribed to through the transport
+        class Notifications : public IEventHandler {
+        public:
+            Notifications(const Notifications&) = delete;
+            Notifications& operator=(const Notifications&) = delete;
+
+            Notifications()
+                : _count(0)
+            {
+            }
+            ~Notifications() override = default;
+
+        public:
+            Firebolt::Error ValidateResponse(const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message>&, bool& enabled) override
+            {
+                enabled = true;
+                return (Firebolt::Error::None);
+            }
+            Firebolt::Error Dispatch(const string&, const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message>& notification) override
+            {
+                if (notification->Result.Value() == _T("\"kitchen\"")) {
+                    ++_count;
+                }
+                return (Firebolt::Error::None);
+            }
+
+            uint32_t Count() const
+            {
+                return (_count.load());
+            }
+
+        private:
+            std::atomic<uint32_t> _count;
+        };
+
+        bool WaitFor(const std::function<bool()>& condition)
+        {
+            const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(UnitEnvironment::WaitTime);
+            bool result = condition();
+            while ((result == false) && (std::chrono::steady_clock::now() < deadline)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                result = condition();
+            }
+            return (result);
+        }
+
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> Connect()
+        {
+            const Transport<WPEFramework::Core::JSON::IElement>::Listener ignore = [](const bool, const Firebolt::Error) {};
+            std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = std::make_shared<Transport<WPEFramework::Core::JSON::IElement>>(_T("ws://127.0.0.1:") + std::to_string(Port), UnitEnvironment::WaitTime, ignore);
+            EXPECT_TRUE(WaitFor([&transport]() { return (transport->IsOpen() == true); }));
+            return (transport);
+        }
+    }
+
+    TEST(MockServer, AnswersFromTheExamples)
+    {
+        MockServer server(Configuration());
+        ASSERT_EQ(server.Open(), WPEFramework::Core::ERROR_NONE);
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = Connect();
+
+        JsonObject parameters;
+        WPEFramework::Core::JSON::String name;
+        // Found whether the method is asked for with a capital or not
+        EXPECT_EQ(transport->Invoke(_T("device.name"), parameters, name), Firebolt::Error::None);
+        EXPECT_EQ(name.Value(), _T("living room"));
+        EXPECT_EQ(transport->Invoke(_T("Device.name"), parameters, name), Firebolt::Error::None);
+
+        JsonValue response;
+        EXPECT_EQ(transport->Invoke(_T("device.unknown"), parameters, response), Firebolt::Error::MethodNotFound);
+
+        transport.reset();
+    }
+
+    TEST(MockServer, InjectsErrors)
+    {
+        MockServer::Config config = Configuration();
+        config.errors = 100;
+        MockServer server(config);
+        ASSERT_EQ(server.Open(), WPEFramework::Core::ERROR_NONE);
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = Connect();
+
+        JsonObject parameters;
+        WPEFramework::Core::JSON::String name;
+        EXPECT_NE(transport->Invoke(_T("device.name"), parameters, name), Firebolt::Error::None);
+
+        transport.reset();
+    }
+
+    TEST(MockServer, HoldsResponsesBack)
+    {
+        static constexpr uint32_t Latency = 50; // ms
+
+        MockServer::Config config = Configuration();
+        config.latency = Latency * 1000;
+        MockServer server(config);
+        ASSERT_EQ(server.Open(), WPEFramework::Core::ERROR_NONE);
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = Connect();
+
+        JsonObject parameters;
+        WPEFramework::Core::JSON::String name;
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        EXPECT_EQ(transport->Invoke(_T("device.name"), parameters, name), Firebolt::Error::None);
+        EXPECT_GE(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count(), Latency);
+        EXPECT_EQ(name.Value(), _T("living room"));
+
+        transport.reset();
+    }
+
+    TEST(MockServer, SendsEventsWhileListened)
+    {
+        MockServer::Config config = Configuration();
+        config.eventRate = 1000;
+        MockServer server(config);
+        ASSERT_EQ(server.Open(), WPEFramework::Core::ERROR_NONE);
+        std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = Connect();
+        Notifications notifications;
+        transport->SetEventHandler(&notifications);
+
+        JsonValue response;
+        ASSERT_EQ(transport->Subscribe(_T("device.onNameChanged"), _T("{\"listen\":true}"), response), Firebolt::Error::None);
+        EXPECT_TRUE(WaitFor([&notifications]() { return (notifications.Count() >= 10); }));
+
+        // Once not listened to anymore, they stop
+        JsonObject parameters;
+        parameters.FromString(_T("{\"listen\":false}"));
+        EXPECT_EQ(transport->Invoke(_T("device.onNameChanged"), parameters, response), Firebolt::Error::None);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const uint32_t stopped = notifications.Count();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_EQ(notifications.Count(), stopped);
+
+        transport.reset();
+    }
+}
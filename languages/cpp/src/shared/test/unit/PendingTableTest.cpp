@@ -0,0 +1,271 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Transport/PendingTable.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace FireboltSDK {
+
+    namespace {
+        struct Request {
+            Request(const uint32_t value)
+                : value(value)
+                , visits(0)
+            {
+            }
+
+            uint32_t value;
+            std::atomic<uint32_t> visits;
+        };
+
+        using Table = PendingTable<Request>;
+
+        // What the table replaced: one lock around a map, for the benchmark to compare against
+        class LockedTable {
+        public:
+            bool Insert(const uint32_t id, const uint32_t value)
+            {
+                std::lock_guard<std::mutex> guard(_lock);
+                return (_map.emplace(id, std::unique_ptr<Request>(new Request(value))).second);
+            }
+            template <typename ACTION>
+            bool Visit(const uint32_t id, ACTION&& action)
+            {
+                std::lock_guard<std::mutex> guard(_lock);
+                auto index = _map.find(id);
+                if (index != _map.end()) {
+                    action(*(index->second));
+                }
+                return (index != _map.end());
+            }
+            bool Remove(const uint32_t id)
+            {
+                std::lock_guard<std::mutex> guard(_lock);
+                return (_map.erase(id) == 1);
+            }
+
+        private:
+            std::mutex _lock;
+            std::unordered_map<uint32_t, std::unique_ptr<Request>> _map;
+        };
+
+        // Every thread keeps inFlight requests of its own outstanding, visiting and retiring
+        // the oldest as it adds a new one, like callers waiting for their responses do.
+        template <typename TABLE>
+        double Churn(TABLE& table, const uint8_t threads, const uint32_t inFlight, const uint32_t rounds, uint32_t& failures)
+        {
+            std::atomic<uint32_t> sequence(0);
+            std::atomic<uint32_t> failed(0);
+
+            const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            std::vector<std::thread> workers;
+            for (uint8_t index = 0; index < threads; ++index) {
+                workers.emplace_back([&]() {
+                    std::vector<uint32_t> ids(inFlight, 0);
+                    for (uint32_t round = 0; round < rounds; ++round) {
+                        uint32_t& id = ids[round % inFlight];
+                        if (id != 0) {
+                            bool visited = table.Visit(id, [&](Request& request) { request.visits++; });
+                            if ((visited == false) || (table.Remove(id) == false)) {
+                                failed++;
+                            }
+                        }
+                        id = ++sequence;
+                        if (table.Insert(id, id) == false) {
+                            failed++;
+                        }
+                    }
+                    for (const uint32_t id : ids) {
+                        if ((id != 0) && (table.Remove(id) == false)) {
+                            failed++;
+                        }
+                    }
+                });
+            }
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+
+            failures = failed.load();
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            return ((static_cast<double>(threads) * rounds) / seconds);
+        }
+
+        // Gives the table the Insert signature of LockedTable
+        class TableAdapter {
+        public:
+            bool Insert(const uint32_t id, const uint32_t value)
+            {
+                return (_table.Insert(id, value) != nullptr);
+            }
+            template <typename ACTION>
+            bool Visit(const uint32_t id, ACTION&& action)
+            {
+                return (_table.Visit(id, std::forward<ACTION>(action)));
+            }
+            bool Remove(const uint32_t id)
+            {
+                return (_table.Remove(id));
+            }
+            uint32_t Spilled() const
+            {
+                return (_table.Spilled());
+            }
+
+        private:
+            Table _table;
+        };
+    }
+
+    TEST(PendingTable, RejectsReservedAndDuplicateIds)
+    {
+        Table table;
+        EXPECT_EQ(table.Insert(0, 1u), nullptr);
+        EXPECT_EQ(table.Insert(~static_cast<uint32_t>(0), 1u), nullptr);
+        EXPECT_NE(table.Insert(7, 1u), nullptr);
+        EXPECT_EQ(table.Insert(7, 2u), nullptr);
+        EXPECT_TRUE(table.Remove(7));
+        EXPECT_FALSE(table.Remove(7));
+    }
+
+    // An id stays unique when a slot ahead of it in its window, or any slot after it spilled, frees up
+    TEST(PendingTable, RejectsDuplicatesBehindAFreedSlot)
+    {
+        // Two slots probed from either end, so every two ids share a window
+        using Small = PendingTable<Request, 2, 2>;
+
+        for (const std::pair<uint32_t, uint32_t>& ids : { std::make_pair(2u, 3u), std::make_pair(3u, 2u) }) {
+            Small table;
+            ASSERT_NE(table.Insert(ids.first, 1u), nullptr);
+            ASSERT_NE(table.Insert(ids.second, 2u), nullptr);
+            EXPECT_TRUE(table.Remove(ids.first));
+            EXPECT_EQ(table.Insert(ids.second, 3u), nullptr);
+
+            uint32_t value = 0;
+            EXPECT_TRUE(table.Visit(ids.second, [&](Request& request) { value = request.value; }));
+            EXPECT_EQ(value, 2u);
+            EXPECT_TRUE(table.Remove(ids.second));
+            EXPECT_FALSE(table.Remove(ids.second));
+        }
+
+        Small table;
+        ASSERT_NE(table.Insert(2, 1u), nullptr);
+        ASSERT_NE(table.Insert(3, 2u), nullptr);
+        ASSERT_NE(table.Insert(1, 3u), nullptr);
+        EXPECT_EQ(table.Spilled(), 1u);
+        EXPECT_TRUE(table.Remove(2));
+        EXPECT_EQ(table.Insert(1, 4u), nullptr);
+        EXPECT_TRUE(table.Remove(1));
+        EXPECT_FALSE(table.Remove(1));
+        EXPECT_EQ(table.Spilled(), 0u);
+    }
+
+    TEST(PendingTable, HoldsMoreThanItsCapacity)
+    {
+        static constexpr uint32_t Outstanding = 1000;
+
+        Table table;
+        for (uint32_t id = 1; id <= Outstanding; ++id) {
+            ASSERT_NE(table.Insert(id, id), nullptr) << "id " << id;
+        }
+        EXPECT_GT(table.Spilled(), 0u);
+
+        for (uint32_t id = 1; id <= Outstanding; ++id) {
+            uint32_t value = 0;
+            EXPECT_TRUE(table.Visit(id, [&](Request& request) { value = request.value; }));
+            EXPECT_EQ(value, id);
+        }
+
+        uint32_t walked = 0;
+        table.ForEach([&](const uint32_t id, Request& request) { walked += (request.value == id ? 1 : 0); return (id % 2 == 0); },
+            [](const uint32_t, Request&) {});
+        EXPECT_EQ(walked, Outstanding);
+
+        for (uint32_t id = 1; id <= Outstanding; ++id) {
+            EXPECT_EQ(table.Remove(id), (id % 2 == 1)) << "id " << id;
+        }
+        EXPECT_EQ(table.Spilled(), 0u);
+    }
+
+    TEST(PendingTable, RemoveWaitsForVisitors)
+    {
+        Table table;
+        ASSERT_NE(table.Insert(1, 1u), nullptr);
+
+        std::atomic<bool> visiting(false);
+        std::atomic<bool> visited(false);
+        std::thread visitor([&]() {
+            table.Visit(1, [&](Request& request) {
+                visiting = true;
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                request.visits++;
+                visited = true;
+            });
+        });
+        while (visiting == false) {
+            std::this_thread::yield();
+        }
+
+        bool seen = false;
+        EXPECT_TRUE(table.Remove(1, [&](Request& request) { seen = (visited == true) && (request.visits == 1); }));
+        EXPECT_TRUE(seen);
+        visitor.join();
+    }
+
+    // Not a pass/fail on speed, the numbers are printed to compare the table with a locked map.
+    // The callers are swept from 1 to 64 threads. The table is sized for 256 in flight, 1024
+    // shows what happens once it spills.
+    TEST(PendingTable, ContentionBenchmark)
+    {
+        static constexpr uint32_t Calls = 800000;
+
+        for (const uint8_t threads : { 1, 2, 4, 8, 16, 32, 64 }) {
+            const uint32_t rounds = Calls / threads;
+            for (const uint32_t total : { 16u, 64u, 256u, 1024u }) {
+                // Every thread has at least one request in flight
+                if (total < threads) {
+                    continue;
+                }
+                const uint32_t inFlight = total / threads;
+                uint32_t failures = 0;
+
+                TableAdapter table;
+                const double lockFree = Churn(table, threads, inFlight, rounds, failures);
+                EXPECT_EQ(failures, 0u);
+                if (threads * inFlight <= 256) {
+                    EXPECT_EQ(table.Spilled(), 0u);
+                }
+
+                LockedTable locked;
+                const double mutex = Churn(locked, threads, inFlight, rounds, failures);
+                EXPECT_EQ(failures, 0u);
+
+                printf("PendingTable: %u threads, %u in flight: %.0f calls/s, locked map: %.0f calls/s\n",
+                    threads, (threads * inFlight), lockFree, mutex);
+            }
+        }
+    }
+}
@@ -0,0 +1,239 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+#include "Properties/Properties.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <thread>
+
+namespace FireboltSDK {
+
+    namespace {
+        // Acknowledges subscriptions, answers setters with null and getters with how often they were asked
+        class Properties_ {
+        public:
+            Properties_()
+                : _gets(0)
+                , _hold(false)
+            {
+            }
+
+            Server::Responder Responder()
+            {
+                return [this](const Server::Message& request, Server::Message& response) {
+                    const string method = request.Designator.Value();
+                    const string parameters = request.Parameters.Value();
+                    if (parameters.find(_T("\"listen\":")) != string::npos) {
+                        const bool listen = (parameters.find(_T("\"listen\":true")) != string::npos);
+                        response.Result = string(_T("{\"listening\":")) + (listen == true ? _T("true") : _T("false")) + _T(",\"event\":\"") + method + _T("\"}");
+                    } else if (method.find(_T(".set")) != string::npos) {
+                        response.Result = _T("null");
+                    } else {
+                        const uint32_t get = ++_gets;
+                        // The first one waits, for a test to do something while it is in flight
+                        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(UnitEnvironment::WaitTime);
+                        while ((get == 1) && (_hold.load() == true) && (std::chrono::steady_clock::now() < end)) {
+                            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                        }
+                        response.Result = std::to_string(get);
+                    }
+                    return true;
+                };
+            }
+
+            uint32_t Gets() const
+            {
+                return (_gets.load());
+            }
+            void Hold(const bool hold)
+            {
+                _hold = hold;
+            }
+
+        private:
+            std::atomic<uint32_t> _gets;
+            std::atomic<bool> _hold;
+        };
+
+        uint32_t Get(const string& propertyName)
+        {
+            WPEFramework::Core::JSON::DecUInt32 response;
+            EXPECT_EQ(Properties::Get(propertyName, response), Firebolt::Error::None);
+            return (response.Value());
+        }
+
+        bool WaitFor(const std::function<bool()>& condition)
+        {
+            const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(UnitEnvironment::WaitTime);
+            bool result = condition();
+            while ((result == false) && (std::chrono::steady_clock::now() < end)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                result = condition();
+            }
+            return (result);
+        }
+    }
+
+    TEST(PropertyCache, SecondGetIsAHit)
+    {
+        Properties_ server;
+        Server::Scope scope(server.Responder());
+        Properties::EnableCache(_T("cache.hit"));
+
+        const uint32_t hits = Properties::CacheHits();
+        EXPECT_EQ(Get(_T("cache.hit")), 1u);
+        EXPECT_EQ(Get(_T("cache.hit")), 1u);
+        EXPECT_EQ(server.Gets(), 1u);
+        EXPECT_EQ(Properties::CacheHits(), hits + 1);
+
+        Properties::DisableCache(_T("cache.hit"));
+    }
+
+    // Hits assign from the object parsed for their type, a hit of another type parses the text
+    TEST(PropertyCache, HitsOfEachTypeSeeTheValue)
+    {
+        Properties_ server;
+        Server::Scope scope(server.Responder());
+        Properties::EnableCache(_T("cache.kind"));
+
+        EXPECT_EQ(Get(_T("cache.kind")), 1u);
+        EXPECT_EQ(Get(_T("cache.kind")), 1u);
+
+        JsonValue value;
+        EXPECT_EQ(Properties::Get(_T("cache.kind"), value), Firebolt::Error::None);
+        EXPECT_EQ(value.Number(), 1);
+        WPEFramework::Core::ProxyType<WPEFramework::Core::JSON::DecUInt32> proxy;
+        EXPECT_EQ(Properties::Get(_T("cache.kind"), proxy), Firebolt::Error::None);
+        ASSERT_TRUE(proxy.IsValid());
+        EXPECT_EQ(proxy->Value(), 1u);
+        EXPECT_EQ(Get(_T("cache.kind")), 1u);
+        EXPECT_EQ(server.Gets(), 1u);
+
+        Properties::DisableCache(_T("cache.kind"));
+    }
+
+    TEST(PropertyCache, UncachedGetsAlwaysGoOut)
+    {
+        Properties_ server;
+        Server::Scope scope(server.Responder());
+
+        const uint32_t hits = Properties::CacheHits();
+        const uint32_t misses = Properties::CacheMisses();
+        EXPECT_EQ(Get(_T("cache.none")), 1u);
+        EXPECT_EQ(Get(_T("cache.none")), 2u);
+        EXPECT_EQ(Properties::CacheHits(), hits);
+        // Not a miss either: the cache was never asked
+        EXPECT_EQ(Properties::CacheMisses(), misses);
+    }
+
+    TEST(PropertyCache, SetInvalidates)
+    {
+        Properties_ server;
+        Server::Scope scope(server.Responder());
+        Properties::EnableCache(_T("cache.volume"));
+
+        EXPECT_EQ(Get(_T("cache.volume")), 1u);
+        JsonObject parameters;
+        EXPECT_EQ(Properties::Set(_T("cache.setVolume"), parameters), Firebolt::Error::None);
+        EXPECT_EQ(Get(_T("cache.volume")), 2u);
+        EXPECT_EQ(Get(_T("cache.volume")), 2u);
+
+        Properties::DisableCache(_T("cache.volume"));
+    }
+
+    TEST(PropertyCache, ChangeEventUpdates)
+    {
+        Properties_ server;
+        Server::Scope scope(server.Responder());
+        Properties::EnableCache(_T("cache.name"));
+
+        EXPECT_EQ(Get(_T("cache.name")), 1u);
+        ASSERT_TRUE(Server::Instance().Notify(_T("cache.onNameChanged"), _T("42")));
+
+        // Served from the notification, not from the server
+        EXPECT_TRUE(WaitFor([]() { return (Get(_T("cache.name")) == 42); }));
+        EXPECT_EQ(server.Gets(), 1u);
+
+        Properties::DisableCache(_T("cache.name"));
+    }
+
+    // A Set while a Get is on the wire: what that Get brings back may be from before the
+    // Set, so it must not be cached.
+    TEST(PropertyCache, GetOverlappingASetIsNotCached)
+    {
+        Properties_ server;
+        Server::Scope scope(server.Responder());
+        Properties::EnableCache(_T("cache.race"));
+
+        server.Hold(true);
+        uint32_t first = 0;
+        std::thread reader([&first]() {
+            first = Get(_T("cache.race"));
+        });
+        ASSERT_TRUE(WaitFor([&server]() { return (server.Gets() == 1); }));
+
+        JsonObject parameters;
+        EXPECT_EQ(Properties::Set(_T("cache.setRace"), parameters), Firebolt::Error::None);
+        server.Hold(false);
+        reader.join();
+        EXPECT_EQ(first, 1u);
+
+        EXPECT_EQ(Get(_T("cache.race")), 2u);
+        EXPECT_EQ(Get(_T("cache.race")), 2u);
+        EXPECT_EQ(server.Gets(), 2u);
+
+        Properties::DisableCache(_T("cache.race"));
+    }
+
+    TEST(PropertyCache, LookupBenchmark)
+    {
+        static constexpr uint32_t Lookups = 1000000;
+
+        Properties_ server;
+        Server::Scope scope(server.Responder());
+        Properties::EnableCache(_T("cache.bench"));
+        EXPECT_EQ(Get(_T("cache.bench")), 1u);
+
+        const string names[2] = { _T("cache.notCached"), _T("cache.bench") };
+        for (const string& name : names) {
+            string value;
+            uint32_t version;
+            const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            for (uint32_t index = 0; index < Lookups; ++index) {
+                PropertyCache::Instance().Lookup(name, value, version);
+            }
+            const uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+            printf("%s: %.1f ns per lookup\n", name.c_str(), static_cast<double>(elapsed) / Lookups);
+        }
+
+        // A hit as the application sees it, assigned from the parsed value
+        WPEFramework::Core::JSON::DecUInt32 response;
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        for (uint32_t index = 0; index < Lookups; ++index) {
+            Properties::Get(_T("cache.bench"), response);
+        }
+        const uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+        printf("Properties::Get hit: %.1f ns per get\n", static_cast<double>(elapsed) / Lookups);
+
+        Properties::DisableCache(_T("cache.bench"));
+    }
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Accessor/Published.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace FireboltSDK {
+
+    namespace {
+        // Counts how many exist, and knows whether it is still one of them
+        struct Counted {
+            Counted(std::atomic<int32_t>& alive, const uint32_t value)
+                : alive(alive)
+                , value(value)
+                , whole(true)
+            {
+                alive++;
+            }
+            ~Counted()
+            {
+                whole = false;
+                alive--;
+            }
+
+            std::atomic<int32_t>& alive;
+            const uint32_t value;
+            std::atomic<bool> whole;
+        };
+    }
+
+    TEST(Published, HandsOutWhatWasStored)
+    {
+        std::atomic<int32_t> alive(0);
+        Published<Counted> published;
+        EXPECT_FALSE(published.IsSet());
+        EXPECT_EQ(published.Load(), nullptr);
+
+        published.Store(std::make_shared<Counted>(alive, 1));
+        EXPECT_TRUE(published.IsSet());
+        EXPECT_EQ(published.Load()->value, 1u);
+
+        std::shared_ptr<Counted> previous = published.Exchange(std::make_shared<Counted>(alive, 2));
+        EXPECT_EQ(previous->value, 1u);
+        EXPECT_EQ(published.Load()->value, 2u);
+
+        // Released by whoever holds it last, not kept by the holder
+        previous.reset();
+        EXPECT_EQ(alive.load(), 1);
+        published.Store(nullptr);
+        EXPECT_EQ(alive.load(), 0);
+    }
+
+    // Readers never get hold of one that was released, and nothing is kept after the last one
+    TEST(Published, ReplacedWhileRead)
+    {
+        static constexpr uint8_t Readers = 4;
+        static constexpr uint32_t Replacements = 20000;
+
+        std::atomic<int32_t> alive(0);
+        {
+            Published<Counted> published;
+            published.Store(std::make_shared<Counted>(alive, 0));
+
+            std::atomic<bool> done(false);
+            std::atomic<uint32_t> broken(0);
+            std::vector<std::thread> readers;
+            for (uint8_t index = 0; index < Readers; ++index) {
+                readers.emplace_back([&]() {
+                    uint32_t last = 0;
+                    while (done.load() == false) {
+                        std::shared_ptr<Counted> current = published.Load();
+                        // Replacements only go up: never an older one after a newer one
+                        if ((current == nullptr) || (current->whole.load() == false) || (current->value < last)) {
+                            broken++;
+                        } else {
+                            last = current->value;
+                        }
+                    }
+                });
+            }
+
+            for (uint32_t value = 1; value <= Replacements; ++value) {
+                published.Store(std::make_shared<Counted>(alive, value));
+            }
+            done = true;
+            for (std::thread& reader : readers) {
+                reader.join();
+            }
+
+            EXPECT_EQ(broken.load(), 0u);
+            EXPECT_EQ(published.Load()->value, Replacements);
+            EXPECT_EQ(alive.load(), 1);
+        }
+        EXPECT_EQ(alive.load(), 0);
+    }
+
+    // Not a pass/fail on speed: a read is an increment of the reader count and of the reference
+    TEST(Published, ReadBenchmark)
+    {
+        static constexpr uint32_t Reads = 4000000;
+        static constexpr uint8_t Threads[] = { 1, 4, 16 };
+
+        std::atomic<int32_t> alive(0);
+        Published<Counted> published;
+        published.Store(std::make_shared<Counted>(alive, 1));
+        std::shared_ptr<Counted> shared = published.Load();
+
+        for (const uint8_t threads : Threads) {
+            const uint32_t perThread = Reads / threads;
+
+            const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            std::vector<std::thread> readers;
+            for (uint8_t index = 0; index < threads; ++index) {
+                readers.emplace_back([&]() {
+                    for (uint32_t read = 0; read < perThread; ++read) {
+                        std::shared_ptr<Counted> current = published.Load();
+                    }
+                });
+            }
+            for (std::thread& reader : readers) {
+                reader.join();
+            }
+            const uint64_t published_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+
+            const std::chrono::steady_clock::time_point again = std::chrono::steady_clock::now();
+            readers.clear();
+            for (uint8_t index = 0; index < threads; ++index) {
+                readers.emplace_back([&]() {
+                    for (uint32_t read = 0; read < perThread; ++read) {
+                        std::shared_ptr<Counted> current = std::atomic_load(&shared);
+                    }
+                });
+            }
+            for (std::thread& reader : readers) {
+                reader.join();
+            }
+            const uint64_t atomic_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - again).count();
+
+            printf("Published: %u threads, %.1f ns per read, std::atomic_load %.1f ns\n", threads,
+                static_cast<double>(published_ns) / (perThread * threads), static_cast<double>(atomic_ns) / (perThread * threads));
+        }
+    }
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "Unit.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace FireboltSDK {
+
+    namespace {
+        // Shaped like the JsonData_ containers the generator emits
+        class Settings : public WPEFramework::Core::JSON::Container {
+        public:
+            Settings()
+                : WPEFramework::Core::JSON::Container()
+            {
+                Init();
+            }
+            Settings(const Settings& other)
+                : WPEFramework::Core::JSON::Container()
+                , Name(other.Name)
+                , Volume(other.Volume)
+                , Enabled(other.Enabled)
+            {
+                Init();
+            }
+            Settings& operator=(const Settings& other)
+            {
+                Name = other.Name;
+                Volume = other.Volume;
+                Enabled = other.Enabled;
+                return (*this);
+            }
+            ~Settings() override = default;
+
+        private:
+            void Init()
+            {
+                Add(_T("name"), &Name);
+                Add(_T("volume"), &Volume);
+                Add(_T("enabled"), &Enabled);
+            }
+
+        public:
+            WPEFramework::Core::JSON::String Name;
+            WPEFramework::Core::JSON::DecUInt32 Volume;
+            WPEFramework::Core::JSON::Boolean Enabled;
+        };
+
+        static constexpr uint32_t Items = 16;
+
+        void Fill(Settings& settings, const uint32_t index)
+        {
+            settings.Name = _T("speaker ") + std::to_string(index);
+            settings.Volume = index * 5;
+            settings.Enabled = ((index % 2) == 0);
+        }
+
+        // What the templates generated before: through the text of every object, and a Variant
+        void Generated(string& message)
+        {
+            JsonObject jsonParameters;
+            Settings settingsContainer;
+            Fill(settingsContainer, 0);
+            string settingsStr;
+            settingsContainer.ToString(settingsStr);
+            WPEFramework::Core::JSON::VariantContainer settingsVariantContainer(settingsStr);
+            WPEFramework::Core::JSON::Variant settingsVariant = settingsVariantContainer;
+            jsonParameters.Set(_T("settings"), settingsVariant);
+
+            WPEFramework::Core::JSON::ArrayType<WPEFramework::Core::JSON::Variant> speakersArray;
+            for (uint32_t index = 0; index < Items; ++index) {
+                Settings speakersContainer;
+                Fill(speakersContainer, index);
+                string speakersStr;
+                speakersContainer.ToString(speakersStr);
+                WPEFramework::Core::JSON::VariantContainer speakersVariantContainer(speakersStr);
+                WPEFramework::Core::JSON::Variant speakersItemVariant = speakersVariantContainer;
+                speakersArray.Add() = speakersItemVariant;
+            }
+            WPEFramework::Core::JSON::Variant speakersVariant;
+            speakersVariant.Array(speakersArray);
+            jsonParameters.Set(_T("speakers"), speakersVariant);
+
+            jsonParameters.ToString(message);
+        }
+
+        // What they generate now: the typed containers, written once into the message
+        void Typed(string& message)
+        {
+            JsonObject jsonParameters;
+            Settings settingsContainer;
+            Fill(settingsContainer, 0);
+            jsonParameters.Add(_T("settings"), &settingsContainer);
+
+            WPEFramework::Core::JSON::ArrayType<Settings> speakersArray;
+            for (uint32_t index = 0; index < Items; ++index) {
+                Settings speakersContainer;
+                Fill(speakersContainer, index);
+                speakersArray.Add() = speakersContainer;
+            }
+            jsonParameters.Add(_T("speakers"), &speakersArray);
+
+            jsonParameters.ToString(message);
+        }
+
+        string Canonical(const string& text)
+        {
+            JsonValue value;
+            value.FromString(text);
+            string result;
+            value.ToString(result);
+            return (result);
+        }
+
+        template <typename SERIALIZE>
+        double NanosecondsPerCall(SERIALIZE&& serialize, const uint32_t calls)
+        {
+            string message;
+            const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            for (uint32_t index = 0; index < calls; ++index) {
+                message.clear();
+                serialize(message);
+            }
+            return (static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count()) / calls);
+        }
+    }
+
+    TEST(Serialize, TypedParametersMatchTheRoundTrip)
+    {
+        string generated, typed;
+        Generated(generated);
+        Typed(typed);
+        EXPECT_FALSE(typed.empty());
+        EXPECT_EQ(Canonical(typed), Canonical(generated));
+    }
+
+    // Parameters added by reference must still be there when the transport writes them
+    TEST(Serialize, TypedParametersReachTheServer)
+    {
+        string received;
+        Server::Scope scope([&received](const Server::Message& request, Server::Message& response) {
+            received = request.Parameters.Value();
+            response.Result = _T("null");
+            return true;
+        });
+
+        auto transport = Accessor::Instance().GetTransport();
+        ASSERT_NE(transport, nullptr);
+
+        JsonObject jsonParameters;
+        Settings settingsContainer;
+        Fill(settingsContainer, 3);
+        jsonParameters.Add(_T("settings"), &settingsContainer);
+        JsonValue response;
+        EXPECT_EQ(transport->Invoke(_T("test.configure"), jsonParameters, response), Firebolt::Error::None);
+
+        string expected;
+        jsonParameters.ToString(expected);
+        EXPECT_EQ(Canonical(received), Canonical(expected));
+        EXPECT_NE(received.find(_T("speaker 3")), string::npos);
+    }
+
+    TEST(Serialize, ParameterBenchmark)
+    {
+        static constexpr uint32_t Calls = 10000;
+
+        const double generated = NanosecondsPerCall(Generated, Calls);
+        const double typed = NanosecondsPerCall(Typed, Calls);
+        printf("Object plus %u item array parameters: %.0f ns through text and Variant, %.0f ns typed\n", Items, generated, typed);
+    }
+}
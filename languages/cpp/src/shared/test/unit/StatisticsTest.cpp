@@ -0,0 +1,120 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+#include "Transport/Statistics.h"
+
+#include <future>
+
+#include <nlohmann/json.hpp>
+
+namespace FireboltSDK {
+
+    TEST(Histogram, PercentilesWithinABucket)
+    {
+        Histogram histogram;
+        for (uint32_t value = 1; value <= 1000; ++value) {
+            histogram.Record(value);
+        }
+
+        EXPECT_EQ(histogram.Count(), 1000u);
+        EXPECT_EQ(histogram.Mean(), 500u);
+        EXPECT_EQ(histogram.Max(), 1000u);
+        // Reported within 12.5% over, never under
+        EXPECT_GE(histogram.Percentile(50.0), 500u);
+        EXPECT_LE(histogram.Percentile(50.0), 563u);
+        EXPECT_GE(histogram.Percentile(99.0), 990u);
+        EXPECT_LE(histogram.Percentile(99.0), 1000u);
+        EXPECT_EQ(histogram.Percentile(100.0), 1000u);
+    }
+
+    TEST(Histogram, EmptyReportsNothing)
+    {
+        Histogram histogram;
+        EXPECT_EQ(histogram.Count(), 0u);
+        EXPECT_EQ(histogram.Mean(), 0u);
+        EXPECT_EQ(histogram.Percentile(99.0), 0u);
+    }
+
+    TEST(Statistics, CountsPerMethod)
+    {
+        Server::Scope scope([](const Server::Message& request, Server::Message& response) {
+            if (request.Designator.Value() == _T("stats.fails")) {
+                response.Error.Code = static_cast<int32_t>(Firebolt::Error::InvalidParams);
+                response.Error.Text = _T("Invalid params");
+            } else if (request.Designator.Value() == _T("stats.succeeds")) {
+                response.Result = _T("true");
+            } else {
+                return false; // stats.never gets no answer
+            }
+            return true;
+        });
+
+        auto transport = Accessor::Instance().GetTransport();
+        ASSERT_NE(transport, nullptr);
+
+        JsonObject parameters;
+        WPEFramework::Core::JSON::Boolean response;
+        for (uint8_t index = 0; index < 3; ++index) {
+            EXPECT_EQ(transport->Invoke(_T("stats.succeeds"), parameters, response), Firebolt::Error::None);
+        }
+        EXPECT_EQ(transport->Invoke(_T("stats.fails"), parameters, response), Firebolt::Error::InvalidParams);
+
+        std::shared_ptr<std::promise<Firebolt::Error>> promise = std::make_shared<std::promise<Firebolt::Error>>();
+        std::future<Firebolt::Error> future = promise->get_future();
+        uint32_t id;
+        EXPECT_EQ(transport->InvokeAsync(_T("stats.never"), parameters, [promise](const Firebolt::Error status, const Server::Message&) {
+            promise->set_value(status);
+        }, 50, id), Firebolt::Error::None);
+        ASSERT_EQ(future.wait_for(std::chrono::milliseconds(UnitEnvironment::WaitTime)), std::future_status::ready);
+        EXPECT_EQ(future.get(), Firebolt::Error::Timedout);
+
+        string text;
+        Accessor::Instance().GetStatistics(text);
+        const nlohmann::json statistics = nlohmann::json::parse(text);
+        const nlohmann::json& methods = statistics["transport"]["methods"];
+
+        ASSERT_TRUE(methods.contains("stats.succeeds"));
+        EXPECT_EQ(methods["stats.succeeds"]["calls"], 3);
+        EXPECT_EQ(methods["stats.succeeds"]["errors"], 0);
+        EXPECT_EQ(methods["stats.succeeds"]["latency"]["count"], 3);
+        EXPECT_GT(methods["stats.succeeds"]["bytesIn"].get<uint64_t>(), 0u);
+
+        ASSERT_TRUE(methods.contains("stats.fails"));
+        EXPECT_EQ(methods["stats.fails"]["calls"], 1);
+        EXPECT_EQ(methods["stats.fails"]["errors"], 1);
+
+        ASSERT_TRUE(methods.contains("stats.never"));
+        EXPECT_EQ(methods["stats.never"]["calls"], 1);
+        EXPECT_EQ(methods["stats.never"]["timeouts"], 1);
+        EXPECT_EQ(methods["stats.never"]["latency"]["count"], 0);
+    }
+
+    TEST(Statistics, MethodNamesAreEscaped)
+    {
+        const string name = _T("stats.\"quoted\\\n");
+        Statistics::Instance().Find(name).Sent(1);
+
+        string text;
+        Accessor::Instance().GetStatistics(text);
+        const nlohmann::json statistics = nlohmann::json::parse(text, nullptr, false);
+        ASSERT_FALSE(statistics.is_discarded());
+        ASSERT_TRUE(statistics["transport"]["methods"].contains(name));
+        EXPECT_EQ(statistics["transport"]["methods"][name]["calls"], 1);
+    }
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "Transport/TimerWheel.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace FireboltSDK {
+
+    namespace {
+        using Wheel = TimerWheel<>;
+
+        static constexpr uint64_t Tick = 10000;
+        // Any point in time well past the first turn
+        static constexpr uint64_t Start = 1000000 * Tick;
+
+        std::vector<uint32_t> Advance(Wheel& wheel, const uint64_t now)
+        {
+            std::vector<uint32_t> due;
+            wheel.Advance(now, due);
+            return (due);
+        }
+    }
+
+    TEST(TimerWheel, FiresOnceExpired)
+    {
+        Wheel wheel;
+        EXPECT_TRUE(Advance(wheel, Start).empty());
+
+        wheel.Arm(1, Start + (5 * Tick) + 1);
+        EXPECT_TRUE(Advance(wheel, Start + (5 * Tick)).empty());
+        EXPECT_EQ(Advance(wheel, Start + (6 * Tick)), std::vector<uint32_t>({ 1 }));
+        EXPECT_TRUE(Advance(wheel, Start + (7 * Tick)).empty());
+        EXPECT_EQ(wheel.Count(), 0u);
+    }
+
+    TEST(TimerWheel, ReportsTheNextExpiry)
+    {
+        Wheel wheel;
+        std::vector<uint32_t> due;
+        EXPECT_EQ(wheel.Advance(Start, due), 0u);
+
+        wheel.Arm(1, Start + (3 * Tick));
+        wheel.Arm(2, Start + (8 * Tick));
+        EXPECT_EQ(wheel.Advance(Start, due), Start + (3 * Tick));
+        EXPECT_EQ(wheel.Advance(Start + (3 * Tick), due), Start + (8 * Tick));
+        EXPECT_EQ(due, std::vector<uint32_t>({ 1 }));
+    }
+
+    TEST(TimerWheel, ExpiredOnArmingFiresOnTheNextTick)
+    {
+        Wheel wheel;
+        EXPECT_TRUE(Advance(wheel, Start).empty());
+
+        wheel.Arm(1, Start - Tick);
+        EXPECT_EQ(Advance(wheel, Start + Tick), std::vector<uint32_t>({ 1 }));
+    }
+
+    // Further out than one turn: shares its slot with earlier timers, but waits its turn
+    TEST(TimerWheel, WrapsPastAllSlots)
+    {
+        Wheel wheel;
+        EXPECT_TRUE(Advance(wheel, Start).empty());
+
+        wheel.Arm(1, Start + (300 * Tick));
+        wheel.Arm(2, Start + (44 * Tick)); // the same slot, one turn earlier
+        for (uint32_t tick = 1; tick < 300; ++tick) {
+            const std::vector<uint32_t> due = Advance(wheel, Start + (tick * Tick));
+            EXPECT_EQ(due, (tick == 44 ? std::vector<uint32_t>({ 2 }) : std::vector<uint32_t>())) << "tick " << tick;
+        }
+        EXPECT_EQ(Advance(wheel, Start + (300 * Tick)), std::vector<uint32_t>({ 1 }));
+    }
+
+    // Nobody looked for longer than a turn: everything that came due in the mean time fires at once
+    TEST(TimerWheel, CatchesUpAfterAStall)
+    {
+        Wheel wheel;
+        EXPECT_TRUE(Advance(wheel, Start).empty());
+
+        wheel.Arm(1, Start + (10 * Tick));
+        wheel.Arm(2, Start + (600 * Tick));
+        wheel.Arm(3, Start + (2000 * Tick));
+        std::vector<uint32_t> due = Advance(wheel, Start + (1000 * Tick));
+        std::sort(due.begin(), due.end());
+        EXPECT_EQ(due, std::vector<uint32_t>({ 1, 2 }));
+        EXPECT_EQ(wheel.Count(), 1u);
+    }
+
+    TEST(TimerWheel, CancelledDoesNotFire)
+    {
+        Wheel wheel;
+        EXPECT_TRUE(Advance(wheel, Start).empty());
+
+        const Wheel::Handle first = wheel.Arm(1, Start + Tick);
+        wheel.Arm(2, Start + Tick);
+        wheel.Arm(3, Start + Tick);
+        EXPECT_TRUE(wheel.Cancel(first, 1));
+        EXPECT_EQ(wheel.Count(), 2u);
+
+        std::vector<uint32_t> due = Advance(wheel, Start + Tick);
+        std::sort(due.begin(), due.end());
+        EXPECT_EQ(due, std::vector<uint32_t>({ 2, 3 }));
+    }
+
+    TEST(TimerWheel, CancelAfterFiringIsANoOp)
+    {
+        Wheel wheel;
+        EXPECT_TRUE(Advance(wheel, Start).empty());
+
+        const Wheel::Handle timer = wheel.Arm(1, Start + Tick);
+        EXPECT_EQ(Advance(wheel, Start + Tick), std::vector<uint32_t>({ 1 }));
+        EXPECT_FALSE(wheel.Cancel(timer, 1));
+
+        // Cancelled twice, or with a handle long since passed on to another timer
+        const Wheel::Handle other = wheel.Arm(2, Start + (2 * Tick));
+        EXPECT_EQ(other, timer);
+        EXPECT_FALSE(wheel.Cancel(timer, 1));
+        EXPECT_TRUE(wheel.Cancel(other, 2));
+        EXPECT_FALSE(wheel.Cancel(other, 2));
+        EXPECT_FALSE(wheel.Cancel(Wheel::NoTimer, 2));
+
+        EXPECT_TRUE(Advance(wheel, Start + (3 * Tick)).empty());
+        EXPECT_EQ(wheel.Count(), 0u);
+    }
+
+    // Requests come and go, the timers they leave behind are reused
+    TEST(TimerWheel, ReusesCancelledTimers)
+    {
+        Wheel wheel;
+        EXPECT_TRUE(Advance(wheel, Start).empty());
+
+        Wheel::Handle highest = 0;
+        for (uint32_t id = 1; id <= 10000; ++id) {
+            const Wheel::Handle timer = wheel.Arm(id, Start + (((id % 500) + 1) * Tick));
+            highest = std::max(highest, timer);
+            if ((id % 4) != 0) {
+                EXPECT_TRUE(wheel.Cancel(timer, id));
+            }
+            if ((id % 16) == 0) {
+                // A quarter is left to expire
+                Advance(wheel, Start + ((id / 16) * Tick));
+            }
+        }
+        EXPECT_LT(highest, 2500u);
+    }
+}
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+#include "Tracer/Tracer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace FireboltSDK {
+
+    namespace {
+        // What Dump writes, read back as the Chrome trace event format
+        class Trace : public WPEFramework::Core::JSON::Container {
+        public:
+            class Arguments : public WPEFramework::Core::JSON::Container {
+            public:
+                Arguments(const Arguments&) = delete;
+                Arguments& operator=(const Arguments&) = delete;
+
+                Arguments()
+                    : WPEFramework::Core::JSON::Container()
+                    , Id()
+                    , Method()
+                {
+                    Add(_T("id"), &Id);
+                    Add(_T("method"), &Method);
+                }
+                ~Arguments() override = default;
+
+            public:
+                WPEFramework::Core::JSON::DecUInt32 Id;
+                WPEFramework::Core::JSON::String Method;
+            };
+
+            class Span : public WPEFramework::Core::JSON::Container {
+            public:
+                Span& operator=(const Span&) = delete;
+
+                Span()
+                    : WPEFramework::Core::JSON::Container()
+                    , Name()
+                    , Ph()
+                    , Ts()
+                    , Dur()
+                    , Args()
+                {
+                    Add(_T("name"), &Name);
+                    Add(_T("ph"), &Ph);
+                    Add(_T("ts"), &Ts);
+                    Add(_T("dur"), &Dur);
+                    Add(_T("args"), &Args);
+                }
+                Span(const Span& copy)
+                    : Span()
+                {
+                    Name = copy.Name;
+                    Ph = copy.Ph;
+                    Ts = copy.Ts;
+                    Dur = copy.Dur;
+                    Args.Id = copy.Args.Id;
+                    Args.Method = copy.Args.Method;
+                }
+                ~Span() override = default;
+
+            public:
+                WPEFramework::Core::JSON::String Name;
+                WPEFramework::Core::JSON::String Ph;
+                WPEFramework::Core::JSON::Float Ts;
+                WPEFramework::Core::JSON::Float Dur;
+                Arguments Args;
+            };
+
+        public:
+            Trace(const Trace&) = delete;
+            Trace& operator=(const Trace&) = delete;
+
+            Trace()
+                : WPEFramework::Core::JSON::Container()
+                , TraceEvents()
+            {
+                Add(_T("traceEvents"), &TraceEvents);
+            }
+            ~Trace() override = default;
+
+        public:
+            WPEFramework::Core::JSON::ArrayType<Span> TraceEvents;
+        };
+
+        static constexpr const TCHAR* FileName = _T("/tmp/firebolt-unit-trace.json");
+
+        bool Dump(Trace& trace)
+        {
+            bool result = false;
+            if (Tracer::Dump(FileName) == Firebolt::Error::None) {
+                std::ifstream file(FileName);
+                std::stringstream text;
+                text << file.rdbuf();
+                result = trace.FromString(text.str());
+                std::remove(FileName);
+            }
+            return (result);
+        }
+
+        // The spans dumped for id, nullptr if there are none
+        const Trace::Span* Find(const Trace& trace, const uint32_t id)
+        {
+            const Trace::Span* result = nullptr;
+            WPEFramework::Core::JSON::ArrayType<Trace::Span>::ConstIterator index = trace.TraceEvents.Elements();
+            while ((result == nullptr) && (index.Next() == true)) {
+                if (index.Current().Args.Id.Value() == id) {
+                    result = &index.Current();
+                }
+            }
+            return (result);
+        }
+    }
+
+    TEST(Tracer, SpansAreDumpedAsChromeTrace)
+    {
+        Tracer::Enable(true);
+        {
+            Tracer::Span span(Tracer::Phase::Deserialize, 0xF1EB0001, _T("test.dumped"));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        Tracer::Enable(false);
+
+        Trace trace;
+        ASSERT_TRUE(Dump(trace));
+        const Trace::Span* span = Find(trace, 0xF1EB0001);
+        ASSERT_NE(span, nullptr);
+        EXPECT_EQ(span->Name.Value(), _T("deserialize"));
+        EXPECT_EQ(span->Ph.Value(), _T("X"));
+        EXPECT_EQ(span->Args.Method.Value(), _T("test.dumped"));
+        // In us
+        EXPECT_GE(span->Dur.Value(), 1000.0);
+    }
+
+    TEST(Tracer, NothingIsRecordedWhileDisabled)
+    {
+        ASSERT_FALSE(Tracer::IsEnabled());
+        {
+            Tracer::Span span(Tracer::Phase::Callback, 0xF1EB0002, _T("test.disabled"));
+        }
+        Tracer::Submitted(0xF1EB0003);
+        Tracer::Written(0xF1EB0003);
+
+        Trace trace;
+        ASSERT_TRUE(Dump(trace));
+        EXPECT_EQ(Find(trace, 0xF1EB0002), nullptr);
+        EXPECT_EQ(Find(trace, 0xF1EB0003), nullptr);
+    }
+
+    // A Write span is opened on one thread and closed on another, without a name
+    TEST(Tracer, WriteSpansHaveNoName)
+    {
+        Tracer::Enable(true);
+        Tracer::Submitted(0xF1EB0004);
+        std::thread writer([]() {
+            Tracer::Written(0xF1EB0004);
+        });
+        writer.join();
+        Tracer::Enable(false);
+
+        Trace trace;
+        ASSERT_TRUE(Dump(trace));
+        const Trace::Span* span = Find(trace, 0xF1EB0004);
+        ASSERT_NE(span, nullptr);
+        EXPECT_EQ(span->Name.Value(), _T("write"));
+        EXPECT_EQ(span->Args.Method.Value(), _T(""));
+    }
+
+    // The spans of a thread that ended are kept, until the next thread takes its buffer over
+    TEST(Tracer, BufferOfAnEndedThreadIsReused)
+    {
+        Tracer::Enable(true);
+        std::thread first([]() {
+            Tracer::Span span(Tracer::Phase::Send, 0xF1EB0005, _T("test.first"));
+        });
+        first.join();
+
+        Trace before;
+        ASSERT_TRUE(Dump(before));
+        EXPECT_NE(Find(before, 0xF1EB0005), nullptr);
+
+        std::thread second([]() {
+            Tracer::Span span(Tracer::Phase::Send, 0xF1EB0006, _T("test.second"));
+        });
+        second.join();
+        Tracer::Enable(false);
+
+        Trace after;
+        ASSERT_TRUE(Dump(after));
+        EXPECT_EQ(Find(after, 0xF1EB0005), nullptr);
+        EXPECT_NE(Find(after, 0xF1EB0006), nullptr);
+    }
+
+    // Not a pass/fail on speed: tens of ns per span enabled, next to nothing disabled
+    TEST(Tracer, SpanBenchmark)
+    {
+        static constexpr uint32_t Spans = 1000000;
+
+        for (const bool enabled : { false, true }) {
+            Tracer::Enable(enabled);
+            const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            for (uint32_t index = 0; index < Spans; ++index) {
+                Tracer::Span span(Tracer::Phase::Serialize, index, _T("test.benchmark"));
+            }
+            const uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+            printf("Tracer %s: %.1f ns per span\n", (enabled == true ? "enabled" : "disabled"), static_cast<double>(elapsed) / Spans);
+        }
+        Tracer::Enable(false);
+    }
+}
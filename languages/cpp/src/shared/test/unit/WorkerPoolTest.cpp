@@ -0,0 +1,115 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Unit.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace FireboltSDK {
+
+    // Holds its minion until the gate opens
+    class Held : public WPEFramework::Core::IDispatch {
+    public:
+        Held() = delete;
+        Held(const Held&) = delete;
+        Held& operator=(const Held&) = delete;
+
+        Held(WPEFramework::Core::Event& gate, std::atomic<uint32_t>& started)
+            : _gate(gate)
+            , _started(started)
+        {
+        }
+        ~Held() override = default;
+
+    public:
+        void Dispatch() override
+        {
+            ++_started;
+            _gate.Lock(WPEFramework::Core::infinite);
+        }
+
+    private:
+        WPEFramework::Core::Event& _gate;
+        std::atomic<uint32_t>& _started;
+    };
+
+    static bool WaitFor(const std::atomic<uint32_t>& counter, const uint32_t expected)
+    {
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(UnitEnvironment::WaitTime);
+        while ((counter.load() < expected) && (std::chrono::steady_clock::now() < deadline)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return (counter.load() >= expected);
+    }
+
+    TEST(WorkerPool, SubmitDoesNotWaitForAFullLane)
+    {
+        static constexpr uint32_t QueueSize = 2;
+
+        WPEFramework::Core::Event gate(false, false);
+        std::atomic<uint32_t> started(0);
+        auto job = [&]() {
+            return WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>(WPEFramework::Core::ProxyType<Held>::Create(gate, started));
+        };
+
+        WPEFramework::Core::ProxyType<WorkerPoolImplementation> pool = WPEFramework::Core::ProxyType<WorkerPoolImplementation>::Create(1, WPEFramework::Core::Thread::DefaultStackSize(), QueueSize, 2);
+        pool->Run();
+
+        // Both minions busy
+        pool->Submit(job());
+        pool->Submit(job());
+        ASSERT_TRUE(WaitFor(started, 2));
+
+        // The lane full, and then some: the submitter could be the one reading the socket
+        for (uint32_t index = 0; index < QueueSize; ++index) {
+            pool->Submit(job());
+        }
+        EXPECT_EQ(pool->GetMetrics().overflows, 0u);
+
+        std::atomic<bool> submitted(false);
+        std::thread submitter([&]() {
+            pool->Submit(job());
+            submitted = true;
+        });
+        submitter.join();
+        EXPECT_EQ(submitted.load(), true);
+        EXPECT_EQ(pool->GetMetrics().normalDepth, QueueSize + 1);
+        EXPECT_EQ(pool->GetMetrics().overflows, 1u);
+
+        gate.SetEvent();
+        pool->Stop();
+        EXPECT_EQ(started.load(), 2 + QueueSize + 1);
+    }
+
+    TEST(WorkerPool, SubmitAfterStopIsRejected)
+    {
+        WPEFramework::Core::Event gate(true, false);
+        std::atomic<uint32_t> started(0);
+
+        WPEFramework::Core::ProxyType<WorkerPoolImplementation> pool = WPEFramework::Core::ProxyType<WorkerPoolImplementation>::Create(1, WPEFramework::Core::Thread::DefaultStackSize(), 0, 2);
+        pool->Run();
+        pool->Stop();
+
+        pool->Submit(WPEFramework::Core::ProxyType<WPEFramework::Core::IDispatch>(WPEFramework::Core::ProxyType<Held>::Create(gate, started)));
+        EXPECT_EQ(pool->GetMetrics().rejected, 1u);
+        EXPECT_EQ(pool->GetMetrics().normalDepth, 0u);
+        EXPECT_EQ(started.load(), 0u);
+    }
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Module.h"
+#include "FireboltSDK.h"
+
+#include <sys/resource.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace FireboltSDK {
+
+    /* Keeps a number of threads calling one method back to back through the SDK, for a
+       while, then reports what that achieved: calls per second, latency as seen by the
+       callers, the peak memory use of the process, and the statistics the SDK gathered
+       along the way, as one JSON document.
+    */
+    class LoadGenerator {
+    public:
+        struct Config {
+            string url = _T("ws://127.0.0.1:9998");
+            string method = _T("device.id");
+            string parameters = _T("{}");
+            uint8_t threads = 4;
+            uint32_t duration = 10; // s
+            uint8_t workers = 4;    // threads of the SDK worker pool
+            uint32_t waitTime = 1000;
+        };
+
+    public:
+        LoadGenerator() = delete;
+        LoadGenerator(const LoadGenerator&) = delete;
+        LoadGenerator& operator=(const LoadGenerator&) = delete;
+
+        LoadGenerator(const Config& config)
+            : _config(config)
+            , _latency()
+            , _errors(0)
+        {
+        }
+        ~LoadGenerator() = default;
+
+    public:
+        Firebolt::Error Run(string& report)
+        {
+            const string configLine = _T("{\"waitTime\":") + std::to_string(_config.waitTime)
+                + _T(",\"logLevel\":\"Error\",\"workerPool\":{\"queueSize\":64,\"threadCount\":") + std::to_string(_config.workers)
+                + _T("},\"wsUrl\":\"") + _config.url + _T("\"}");
+            Accessor::Instance(configLine);
+
+            WPEFramework::Core::Event connected(false, true);
+            Firebolt::Error status = Accessor::Instance().Connect([&connected](const bool isConnected, const Firebolt::Error) {
+                if (isConnected == true) {
+                    connected.SetEvent();
+                }
+            });
+            if ((status == Firebolt::Error::None) && (connected.Lock(_config.waitTime * 5) != WPEFramework::Core::ERROR_NONE)) {
+                status = Firebolt::Error::Timedout;
+            }
+
+            std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport = (status == Firebolt::Error::None ? Accessor::Instance().GetTransport() : nullptr);
+            if (transport == nullptr) {
+                status = (status == Firebolt::Error::None ? Firebolt::Error::NotConnected : status);
+            } else {
+                const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+                const std::chrono::steady_clock::time_point end = begin + std::chrono::seconds(_config.duration);
+
+                std::vector<std::thread> callers;
+                for (uint8_t index = 0; index < _config.threads; ++index) {
+                    callers.emplace_back(&LoadGenerator::Call, this, transport, end);
+                }
+                for (std::thread& caller : callers) {
+                    caller.join();
+                }
+
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+                Report(seconds, report);
+            }
+
+            transport.reset();
+            Accessor::Dispose();
+            return (status);
+        }
+
+    private:
+        void Call(const std::shared_ptr<Transport<WPEFramework::Core::JSON::IElement>> transport, const std::chrono::steady_clock::time_point end)
+        {
+            JsonObject parameters;
+            parameters.FromString(_config.parameters);
+
+            while (std::chrono::steady_clock::now() < end) {
+                JsonValue response;
+                const std::chrono::steady_clock::time_point sent = std::chrono::steady_clock::now();
+                const Firebolt::Error status = transport->Invoke(_config.method, parameters, response);
+                _latency.Record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sent).count());
+                if (status != Firebolt::Error::None) {
+                    _errors.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void Report(const double seconds, string& text) const
+        {
+            struct rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+
+            text += _T("{\"method\":\"") + _config.method + _T("\",\"threads\":") + std::to_string(_config.threads);
+            text += _T(",\"seconds\":") + std::to_string(seconds);
+            text += _T(",\"calls\":") + std::to_string(_latency.Count());
+            text += _T(",\"errors\":") + std::to_string(_errors.load(std::memory_order_relaxed));
+            text += _T(",\"callsPerSecond\":") + std::to_string(seconds > 0 ? _latency.Count() / seconds : 0.0);
+            text += _T(",\"latency\":");
+            _latency.ToString(text);
+            text += _T(",\"maxResidentKB\":") + std::to_string(usage.ru_maxrss);
+            text += _T(",\"sdk\":");
+            Accessor::Instance().GetStatistics(text);
+            text += _T("}");
+        }
+
+    private:
+        const Config _config;
+        Histogram _latency;
+        std::atomic<uint64_t> _errors;
+    };
+}
+
+static void Usage(const char* name)
+{
+    fprintf(stderr, "Usage: %s [--url ws://127.0.0.1:9998] [--method device.id] [--params {}] [--threads 4]\n"
+        "       [--duration s] [--workers 4] [--waittime ms]\n", name);
+}
+
+int main(int argc, char* argv[])
+{
+    FireboltSDK::LoadGenerator::Config config;
+
+    for (int index = 1; index < argc; index += 2) {
+        const string option(argv[index]);
+        if (index + 1 >= argc) {
+            Usage(argv[0]);
+            return (1);
+        }
+        const char* value = argv[index + 1];
+        if (option == "--url") {
+            config.url = value;
+        } else if (option == "--method") {
+            config.method = value;
+        } else if (option == "--params") {
+            config.parameters = value;
+        } else if (option == "--threads") {
+            config.threads = static_cast<uint8_t>(atoi(value));
+        } else if (option == "--duration") {
+            config.duration = static_cast<uint32_t>(atoi(value));
+        } else if (option == "--workers") {
+            config.workers = static_cast<uint8_t>(atoi(value));
+        } else if (option == "--waittime") {
+            config.waitTime = static_cast<uint32_t>(atoi(value));
+        } else {
+            Usage(argv[0]);
+            return (1);
+        }
+    }
+
+    string report;
+    FireboltSDK::LoadGenerator generator(config);
+    const Firebolt::Error status = generator.Run(report);
+    if (status != Firebolt::Error::None) {
+        fprintf(stderr, "Could not load %s: error %d\n", config.url.c_str(), static_cast<int>(status));
+    } else {
+        printf("%s\n", report.c_str());
+    }
+
+    WPEFramework::Core::Singleton::Dispose();
+    return (status == Firebolt::Error::None ? 0 : 1);
+}
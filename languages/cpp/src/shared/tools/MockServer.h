@@ -0,0 +1,348 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "Module.h"
+#include "json_engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace FireboltSDK {
+
+    /* Speaks JSON-RPC over a websocket the way a device does, answering every method with
+       the first example of the openrpc document. Listening to an event makes the server
+       send the example of that event at a steady rate, until the listener goes away.
+       Responses can be held back and turned into errors, to see how the SDK copes.
+    */
+    class MockServer {
+    public:
+        struct Config {
+            string host = _T("127.0.0.1");
+            uint16_t port = 9998;
+            string openRpc = _T("firebolt-open-rpc.json");
+            uint8_t threads = 4;
+            uint32_t latency = 0;   // us, before every response
+            uint32_t jitter = 0;    // us, at most, added to the latency at random
+            uint8_t errors = 0;     // % of the responses that are errors
+            uint32_t eventRate = 0; // per second, for every listener
+        };
+
+    private:
+        static constexpr int32_t MethodNotFound = -32601;
+        static constexpr int32_t InternalError = -32603;
+
+        using Clock = std::chrono::steady_clock;
+
+        class Factory {
+        public:
+            Factory(const Factory&) = delete;
+            Factory& operator=(const Factory&) = delete;
+
+            Factory()
+                : _messages(8)
+            {
+            }
+            ~Factory() = default;
+
+        public:
+            WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> Element(const string&)
+            {
+                return (_messages.Element());
+            }
+
+        private:
+            WPEFramework::Core::ProxyPoolType<WPEFramework::Core::JSONRPC::Message> _messages;
+        };
+
+        class Connection : public WPEFramework::Core::StreamJSONType<WPEFramework::Web::WebSocketServerType<WPEFramework::Core::SocketStream>, Factory&, WPEFramework::Core::JSON::IElement> {
+        private:
+            typedef WPEFramework::Core::StreamJSONType<WPEFramework::Web::WebSocketServerType<WPEFramework::Core::SocketStream>, Factory&, WPEFramework::Core::JSON::IElement> BaseClass;
+
+        public:
+            Connection() = delete;
+            Connection(const Connection&) = delete;
+            Connection& operator=(const Connection&) = delete;
+
+            Connection(const SOCKET& socket, const WPEFramework::Core::NodeId& remoteNode, WPEFramework::Core::SocketServerType<Connection>*)
+                : BaseClass(5, _singleton->_factory, false, false, false, socket, remoteNode, 1024, 1024)
+            {
+                _singleton->Opened(*this);
+            }
+            ~Connection() override
+            {
+                _singleton->Closed(*this);
+            }
+
+        public:
+            void Received(WPEFramework::Core::ProxyType<WPEFramework::Core::JSON::IElement>& element) override
+            {
+                WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> request(element);
+
+                ASSERT(request.IsValid() == true);
+                if (request.IsValid() == true) {
+                    _singleton->Received(*this, *request);
+                }
+            }
+            void Send(WPEFramework::Core::ProxyType<WPEFramework::Core::JSON::IElement>&) override
+            {
+            }
+            void StateChange() override
+            {
+                if (IsOpen() == false) {
+                    _singleton->Closed(*this);
+                }
+            }
+            bool IsIdle() const override
+            {
+                return (true);
+            }
+        };
+
+        // A response on its way out, or the next occurrence of an event while its listener is there
+        struct Job {
+            Connection* connection;
+            WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> response;
+            string event;
+            uint32_t id;
+        };
+        using Listener = std::pair<const Connection*, string>;
+
+    public:
+        MockServer() = delete;
+        MockServer(const MockServer&) = delete;
+        MockServer& operator=(const MockServer&) = delete;
+
+        MockServer(const Config& config)
+            : _config(config)
+            , _engine(config.openRpc)
+            , _factory()
+            , _server(WPEFramework::Core::NodeId(config.host.c_str(), config.port))
+            , _lock()
+            , _wakeup()
+            , _queue()
+            , _listeners()
+            , _connectionLock()
+            , _connections()
+            , _workers()
+            , _running(false)
+        {
+            ASSERT(_singleton == nullptr);
+            _singleton = this;
+        }
+        ~MockServer()
+        {
+            Close();
+
+            ASSERT(_singleton != nullptr);
+            _singleton = nullptr;
+        }
+
+    public:
+        uint32_t Open()
+        {
+            _running = true;
+            for (uint8_t index = 0; index < std::max(_config.threads, static_cast<uint8_t>(1)); ++index) {
+                _workers.emplace_back(&MockServer::Worker, this);
+            }
+            return (_server.Open(WPEFramework::Core::infinite));
+        }
+        void Close()
+        {
+            _server.Close(WPEFramework::Core::infinite);
+
+            std::unique_lock<std::mutex> lock(_lock);
+            _running = false;
+            _wakeup.notify_all();
+            lock.unlock();
+
+            for (std::thread& worker : _workers) {
+                worker.join();
+            }
+            _workers.clear();
+            _queue.clear();
+        }
+
+    private:
+        void Opened(Connection& connection)
+        {
+            std::unique_lock<std::shared_mutex> lock(_connectionLock);
+            _connections.insert(&connection);
+        }
+        void Closed(Connection& connection)
+        {
+            std::unique_lock<std::shared_mutex> lock(_connectionLock);
+            if (_connections.erase(&connection) != 0) {
+                std::lock_guard<std::mutex> guard(_lock);
+                std::map<Listener, uint32_t>::iterator index = _listeners.begin();
+                while (index != _listeners.end()) {
+                    index = (index->first.first == &connection ? _listeners.erase(index) : std::next(index));
+                }
+            }
+        }
+
+        // On the thread reading the socket, keep it short
+        void Received(Connection& connection, const WPEFramework::Core::JSONRPC::Message& request)
+        {
+            WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message> response(_factory.Element(string()));
+            response->Clear();
+            response->Id = request.Id.Value();
+
+            const string method = Find(request.Designator.Value());
+            if (method.empty() == true) {
+                response->Error.Code = MethodNotFound;
+                response->Error.Text = _T("Method not found");
+            } else if ((_config.errors != 0) && (Random(100) < _config.errors)) {
+                response->Error.Code = InternalError;
+                response->Error.Text = _T("Injected by the mock server");
+            } else if (_engine.is_event(method) == true) {
+                const json parameters = json::parse(request.Parameters.Value(), nullptr, false);
+                const bool listen = (parameters.is_object() == true ? parameters.value("listen", true) : true);
+                Listen(connection, request.Designator.Value(), request.Id.Value(), listen);
+                response->Result = json({ { "listening", listen }, { "event", request.Designator.Value() } }).dump();
+            } else {
+                response->Result = _engine.get_value(method);
+            }
+
+            const uint32_t delay = _config.latency + (_config.jitter != 0 ? Random(_config.jitter + 1) : 0);
+            if (delay == 0) {
+                Submit(&connection, response);
+            } else {
+                std::lock_guard<std::mutex> lock(_lock);
+                Schedule(Clock::now() + std::chrono::microseconds(delay), { &connection, response, string(), 0 });
+            }
+        }
+
+        void Listen(Connection& connection, const string& event, const uint32_t id, const bool listen)
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            const Listener listener(&connection, event);
+            if (listen == false) {
+                _listeners.erase(listener);
+            } else {
+                _listeners[listener] = id;
+                if (_config.eventRate != 0) {
+                    Schedule(Clock::now() + Period(), { &connection, WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message>(), event, id });
+                }
+            }
+        }
+
+        void Worker()
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            while (_running == true) {
+                if (_queue.empty() == true) {
+                    _wakeup.wait(lock);
+                } else if (_queue.begin()->first > Clock::now()) {
+                    _wakeup.wait_until(lock, _queue.begin()->first);
+                } else {
+                    const Clock::time_point due = _queue.begin()->first;
+                    Job job = _queue.begin()->second;
+                    _queue.erase(_queue.begin());
+
+                    if (job.event.empty() == false) {
+                        // Stops once the listener is gone, or has listened again under another id
+                        std::map<Listener, uint32_t>::const_iterator listener = _listeners.find(Listener(job.connection, job.event));
+                        if ((listener == _listeners.end()) || (listener->second != job.id)) {
+                            continue;
+                        }
+                        Schedule(due + Period(), job);
+
+                        job.response = _factory.Element(string());
+                        job.response->Clear();
+                        job.response->Id = job.id;
+                        job.response->Result = _engine.get_value(Find(job.event));
+                    }
+
+                    lock.unlock();
+                    Submit(job.connection, job.response);
+                    lock.lock();
+                }
+            }
+        }
+
+        // Only to connections still there
+        void Submit(Connection* connection, const WPEFramework::Core::ProxyType<WPEFramework::Core::JSONRPC::Message>& message)
+        {
+            std::shared_lock<std::shared_mutex> lock(_connectionLock);
+            if (_connections.find(connection) != _connections.end()) {
+                connection->Submit(WPEFramework::Core::ProxyType<WPEFramework::Core::JSON::IElement>(message));
+            }
+        }
+
+        // Call with _lock taken
+        void Schedule(const Clock::time_point& due, const Job& job)
+        {
+            const bool earliest = ((_queue.empty() == true) || (due < _queue.begin()->first));
+            _queue.emplace(due, job);
+            if (earliest == true) {
+                _wakeup.notify_one();
+            }
+        }
+
+        // The name of method in the openrpc document, which may start with a capital
+        string Find(const string& method) const
+        {
+            string result;
+            if (_engine.get_value(method).empty() == false) {
+                result = method;
+            } else if (_engine.get_value(capitalizeFirstChar(method)).empty() == false) {
+                result = capitalizeFirstChar(method);
+            }
+            return (result);
+        }
+        std::chrono::microseconds Period() const
+        {
+            // Above a million events per second, as fast as the scheduler goes
+            return (std::chrono::microseconds(std::max(1000000 / _config.eventRate, static_cast<uint32_t>(1))));
+        }
+        static uint32_t Random(const uint32_t range)
+        {
+            static thread_local std::minstd_rand generator(std::random_device {}());
+            return (static_cast<uint32_t>(generator() % range));
+        }
+
+    private:
+        const Config _config;
+        const JsonEngine _engine;
+        Factory _factory;
+        WPEFramework::Core::SocketServerType<Connection> _server;
+
+        std::mutex _lock;
+        std::condition_variable _wakeup;
+        std::multimap<Clock::time_point, Job> _queue;
+        std::map<Listener, uint32_t> _listeners;
+
+        std::shared_mutex _connectionLock;
+        std::set<const Connection*> _connections;
+
+        std::vector<std::thread> _workers;
+        bool _running;
+
+        static MockServer* _singleton;
+    };
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "Module.h"
+#include "MockServer.h"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+
+static void Usage(const char* name)
+{
+    fprintf(stderr, "Usage: %s [--host 127.0.0.1] [--port 9998] [--openrpc firebolt-open-rpc.json] [--threads 4]\n"
+        "       [--latency us] [--jitter us] [--errors percent] [--events per second]\n", name);
+}
+
+int main(int argc, char* argv[])
+{
+    FireboltSDK::MockServer::Config config;
+
+    for (int index = 1; index < argc; index += 2) {
+        const string option(argv[index]);
+        if (index + 1 >= argc) {
+            Usage(argv[0]);
+            return (1);
+        }
+        const char* value = argv[index + 1];
+        if (option == "--host") {
+            config.host = value;
+        } else if (option == "--port") {
+            config.port = static_cast<uint16_t>(atoi(value));
+        } else if (option == "--openrpc") {
+            config.openRpc = value;
+        } else if (option == "--threads") {
+            config.threads = static_cast<uint8_t>(atoi(value));
+        } else if (option == "--latency") {
+            config.latency = static_cast<uint32_t>(atoi(value));
+        } else if (option == "--jitter") {
+            config.jitter = static_cast<uint32_t>(atoi(value));
+        } else if (option == "--errors") {
+            config.errors = static_cast<uint8_t>(std::min(atoi(value), 100));
+        } else if (option == "--events") {
+            config.eventRate = static_cast<uint32_t>(atoi(value));
+        } else {
+            Usage(argv[0]);
+            return (1);
+        }
+    }
+
+    // Serve until asked to stop
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    int result = 0;
+    {
+        FireboltSDK::MockServer server(config);
+        if (server.Open() != WPEFramework::Core::ERROR_NONE) {
+            fprintf(stderr, "Could not listen on %s:%u\n", config.host.c_str(), config.port);
+            result = 1;
+        } else {
+            printf("Serving %s on ws://%s:%u\n", config.openRpc.c_str(), config.host.c_str(), config.port);
+            int signal = 0;
+            sigwait(&signals, &signal);
+        }
+    }
+
+    WPEFramework::Core::Singleton::Dispose();
+    return (result);
+}
@@ -1,7 +1,7 @@
     static void ProviderInvokeSession(std::string& methodName, JsonObject& jsonParameters, Firebolt::Error *err = nullptr)
     {
         Firebolt::Error status = Firebolt::Error::NotConnected;
-        FireboltSDK::Transport<WPEFramework::Core::JSON::IElement>* transport = FireboltSDK::Accessor::Instance().GetTransport();
+        std::shared_ptr<FireboltSDK::Transport<WPEFramework::Core::JSON::IElement>> transport = FireboltSDK::Accessor::Instance().GetTransport();
         if (transport != nullptr) {
 
             JsonObject jsonResult;
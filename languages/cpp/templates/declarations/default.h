@@ -3,4 +3,18 @@
      ${method.description}
      ${method.params.annotations}${if.deprecated} * @deprecated ${method.deprecation}${end.if.deprecated}
      */
-    virtual ${method.signature.result} ${method.name}( ${method.signature.params}${if.params}, ${end.if.params}Firebolt::Error *err = nullptr )${if.result.nonvoid}${if.params.empty} const${end.if.params.empty}${end.if.result.nonvoid} = 0;
\ No newline at end of file
+    virtual ${method.signature.result} ${method.name}( ${method.signature.params}${if.params}, ${end.if.params}Firebolt::Error *err = nullptr )${if.result.nonvoid}${if.params.empty} const${end.if.params.empty}${end.if.result.nonvoid} = 0;
+    /*
+     ${method.name}Async
+     Non-blocking ${method.name}: the future becomes ready once the response arrived or the call failed.
+     Implementations without a non-blocking path of their own, mocks among them, get one that makes
+     the blocking call and hands back a future that is ready.
+     */
+    virtual std::future<Firebolt::Result<${method.signature.result}>> ${method.name}Async( ${method.signature.params} ) const
+    {
+        Firebolt::Result<${method.signature.result}> result{};
+        ${if.result.nonvoid}result.value = ${end.if.result.nonvoid}const_cast<I${info.Title}*>(this)->${method.name}( ${method.params.list}${if.params}, ${end.if.params}&result.error );
+        std::promise<Firebolt::Result<${method.signature.result}>> promise;
+        promise.set_value(std::move(result));
+        return promise.get_future();
+    }
\ No newline at end of file
@@ -3,13 +3,16 @@
     {
         Firebolt::Error statusError = Firebolt::Error::NotConnected;
 ${if.result.nonvoid}${method.result.initialization}${end.if.result.nonvoid}
-        FireboltSDK::Transport<WPEFramework::Core::JSON::IElement>* transport = FireboltSDK::Accessor::Instance().GetTransport();
+        std::shared_ptr<FireboltSDK::Transport<WPEFramework::Core::JSON::IElement>> transport = FireboltSDK::Accessor::Instance().GetTransport();
         if (transport != nullptr) {
         
             JsonObject jsonParameters;
+            const uint32_t id = transport->Sequence();
+            FireboltSDK::Tracer::Span serialize(FireboltSDK::Tracer::Phase::Serialize, id, "${info.title}.${method.name}");
     ${method.params.serialization.with.indent}
+            serialize.End();
             ${method.result.json.type} jsonResult;
-            statusError = transport->Invoke("${info.title}.${method.name}", jsonParameters, jsonResult);
+            statusError = transport->Invoke${if.coalesce}Coalesced${end.if.coalesce}("${info.title}.${method.name}", jsonParameters, jsonResult, id);
             if (statusError == Firebolt::Error::None) {
                 FIREBOLT_LOG_INFO(FireboltSDK::Logger::Category::OpenRPC, FireboltSDK::Logger::Module<FireboltSDK::Accessor>(), "${info.Title}.${method.name} is successfully invoked");
     ${if.result.nonvoid}${method.result.instantiation.with.indent}${end.if.result.nonvoid}
@@ -24,3 +27,39 @@ ${if.result.nonvoid}${method.result.initialization}${end.if.result.nonvoid}
 
         return${if.result.nonvoid} ${method.result.name}${end.if.result.nonvoid};
     }
+    std::future<Firebolt::Result<${method.signature.result}>> ${info.Title}Impl::${method.name}Async( ${method.signature.params} ) const
+    {
+        std::shared_ptr<std::promise<Firebolt::Result<${method.signature.result}>>> promise = std::make_shared<std::promise<Firebolt::Result<${method.signature.result}>>>();
+        std::future<Firebolt::Result<${method.signature.result}>> future = promise->get_future();
+
+        Firebolt::Error statusError = Firebolt::Error::NotConnected;
+        std::shared_ptr<FireboltSDK::Transport<WPEFramework::Core::JSON::IElement>> transport = FireboltSDK::Accessor::Instance().GetTransport();
+        if (transport != nullptr) {
+
+            JsonObject jsonParameters;
+            const uint32_t id = transport->Sequence();
+            FireboltSDK::Tracer::Span serialize(FireboltSDK::Tracer::Phase::Serialize, id, "${info.title}.${method.name}");
+    ${method.params.serialization.with.indent}
+            serialize.End();
+            // Completed on the thread that receives the response, no thread waits for it
+            statusError = transport->InvokeAsync("${info.title}.${method.name}", jsonParameters, [promise](const Firebolt::Error status, const WPEFramework::Core::JSONRPC::Message& response) {
+                Firebolt::Result<${method.signature.result}> result{};
+                result.error = status;
+${if.result.nonvoid}                if (status == Firebolt::Error::None) {
+                    ${method.result.json.type} jsonResult;
+                    jsonResult.FromString(FireboltSDK::ResultOf(response));
+${method.result.initialization}
+    ${method.result.instantiation.with.indent}
+                    result.value = ${method.result.name};
+                }
+${end.if.result.nonvoid}                promise->set_value(std::move(result));
+            }, id);
+        } else {
+            FIREBOLT_LOG_ERROR(FireboltSDK::Logger::Category::OpenRPC, FireboltSDK::Logger::Module<FireboltSDK::Accessor>(), "Error in getting Transport err = %d", statusError);
+        }
+        if (statusError != Firebolt::Error::None) {
+            promise->set_value(Firebolt::Result<${method.signature.result}>{ statusError });
+        }
+
+        return future;
+    }
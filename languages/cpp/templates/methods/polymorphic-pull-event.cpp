@@ -12,7 +12,7 @@ ${method.pulls.response.instantiation}
             I${info.Title}::I${method.Name}Notification& notifier = *(reinterpret_cast<I${info.Title}::I${method.Name}Notification*>(notification));
             ${method.pulls.type} element = notifier.${method.rpc.name}(${method.pulls.param.title});
             Firebolt::Error status = Firebolt::Error::NotConnected;
-            FireboltSDK::Transport<WPEFramework::Core::JSON::IElement>* transport = FireboltSDK::Accessor::Instance().GetTransport();
+            std::shared_ptr<FireboltSDK::Transport<WPEFramework::Core::JSON::IElement>> transport = FireboltSDK::Accessor::Instance().GetTransport();
             if (transport != nullptr) {
                 JsonObject jsonParameters;
                 WPEFramework::Core::JSON::Variant CorrelationId = proxyResponse->CorrelationId.Value();
@@ -21,11 +21,7 @@ ${method.pulls.response.instantiation}
                 {
         ${method.pulls.result.serialization.with.indent}
                 }
-                string resultStr;
-                ${method.pulls.result.title}Container.ToString(resultStr);
-                WPEFramework::Core::JSON::VariantContainer resultContainer(resultStr);
-                WPEFramework::Core::JSON::Variant Result = resultContainer;
-                jsonParameters.Set(_T("result"), Result);
+                jsonParameters.Add(_T("result"), &${method.pulls.result.title}Container);
                 WPEFramework::Core::JSON::Boolean jsonResult;
 
                 status = transport->Invoke("${info.title.lowercase}.${method.pulls.for}", jsonParameters, jsonResult);
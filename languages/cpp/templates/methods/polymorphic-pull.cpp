@@ -3,7 +3,7 @@
     {
         Firebolt::Error status = Firebolt::Error::NotConnected;
 ${if.result.nonvoid}${method.result.initialization}${end.if.result.nonvoid}
-        FireboltSDK::Transport<WPEFramework::Core::JSON::IElement>* transport = FireboltSDK::Accessor::Instance().GetTransport();
+        std::shared_ptr<FireboltSDK::Transport<WPEFramework::Core::JSON::IElement>> transport = FireboltSDK::Accessor::Instance().GetTransport();
         if (transport != nullptr) {
             string correlationId = "";
             JsonObject jsonParameters;
@@ -19,6 +19,9 @@
 #pragma once
 
 #include "error.h"
+#include <future>
+#include <string>
+#include <vector>
 /* ${IMPORTS} */
 
 ${if.declarations}namespace Firebolt {
@@ -37,6 +40,22 @@ ${if.methods}struct I${info.Title} {
 
     // Methods & Events
     /* ${METHODS:declarations} */
+
+    /*
+     getProperties
+     Reads several ${info.Title} properties, by their short name, in one round trip. values gets the
+     JSON text of each, empty for the ones that failed, and errors (if given) their own outcome.
+     Returns the first failure. Implementations without a batch path of their own, mocks among
+     them, report every property as not found.
+     */
+    virtual Firebolt::Error getProperties( const std::vector<std::string>& properties, std::vector<std::string>& values, std::vector<Firebolt::Error>* errors = nullptr ) const
+    {
+        values.assign(properties.size(), std::string());
+        if (errors != nullptr) {
+            errors->assign(properties.size(), Firebolt::Error::MethodNotFound);
+        }
+        return (properties.empty() ? Firebolt::Error::None : Firebolt::Error::MethodNotFound);
+    }
 };${end.if.methods}
 
 } //namespace ${info.Title}
@@ -28,6 +28,33 @@ ${if.providers}
 
     // Events
     /* ${EVENTS} */
+${if.methods}
+    Firebolt::Error ${info.Title}Impl::getProperties( const std::vector<std::string>& properties, std::vector<std::string>& values, std::vector<Firebolt::Error>* errors ) const
+    {
+        std::vector<JsonValue> results(properties.size());
+
+        FireboltSDK::Properties::Batch batch;
+        batch.reserve(properties.size());
+        for (uint32_t index = 0; index < properties.size(); ++index) {
+            batch.push_back({ _T("${info.title.lowercase}.") + properties[index], _T("{}"), &results[index], Firebolt::Error::General });
+        }
+
+        const Firebolt::Error status = FireboltSDK::Properties::GetMany(batch);
+
+        values.assign(properties.size(), std::string());
+        if (errors != nullptr) {
+            errors->resize(properties.size());
+        }
+        for (uint32_t index = 0; index < properties.size(); ++index) {
+            if (batch[index].status == Firebolt::Error::None) {
+                results[index].ToString(values[index]);
+            }
+            if (errors != nullptr) {
+                (*errors)[index] = batch[index].status;
+            }
+        }
+        return status;
+    }${end.if.methods}
 
 }//namespace ${info.Title}
 }${end.if.implementations}
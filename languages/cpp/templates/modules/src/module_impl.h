@@ -43,6 +43,9 @@ ${if.types}
 
         // Methods & Events
         /* ${METHODS:declarations-override} */
+
+        // Fetch several ${info.Title} properties, by their short name, in one round trip
+        Firebolt::Error getProperties( const std::vector<std::string>& properties, std::vector<std::string>& values, std::vector<Firebolt::Error>* errors = nullptr ) const override;
     };${end.if.methods}
 
 }//namespace ${info.Title}
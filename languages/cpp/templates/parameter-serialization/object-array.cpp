@@ -2,8 +2,4 @@
         {
 ${properties}
         }
-        string ${property}Str;
-        ${property}Container.ToString(${property}Str);
-        WPEFramework::Core::JSON::VariantContainer ${property}VariantContainer(${property}Str);
-        WPEFramework::Core::JSON::Variant ${property}Variant = ${property}VariantContainer;
-        ${property}Array.Add() = ${property}Variant;
\ No newline at end of file
+        ${property}Array.Add() = ${property}Container;
\ No newline at end of file
@@ -40,6 +40,7 @@ struct IFireboltAccessor {
      * @brief Inititalize the Firebolt SDK. Sets up the Transport, WorkerPool and Logging Subsystems.
      *
      * @param configLine JSON String with configuration options. At a minimum the user is expected to pass in the Websocket URL.
+     *                   An endpoint on the same host can also be reached over a unix domain socket, e.g. "unix:///run/firebolt.sock".
      *
      * CONFIG Format:
      *  {
@@ -47,11 +48,21 @@ struct IFireboltAccessor {
      *     "logLevel": "Info",
      *     "workerPool":{
      *       "queueSize": 8,
-     *       "threadCount": 3
+     *       "threadCount": 3,
+     *       "maxThreadCount": 8,
+     *       "idleTime": 5000
      *      },
-     *     "wsUrl": "ws://127.0.0.1:9998"
+     *     "wsUrl": "ws://127.0.0.1:9998",
+     *     "cachedProperties": [ "device.id" ],
+     *     "reconnectDelay": 500,
+     *     "maxReconnectDelay": 30000
      *  }
      *
+     *  workerPool.maxThreadCount: above threadCount, the pool grows with its backlog up to this many threads
+     *  workerPool.idleTime: ms a thread above threadCount waits for work before it stops
+     *  cachedProperties: properties read from memory after the first call, kept current by their change event
+     *  reconnectDelay: ms to wait before connecting again once the connection is lost, doubled after every failed attempt
+     *  maxReconnectDelay: ms the reconnect delay grows up to
      *
      * @return Firebolt::Error
      *
@@ -146,6 +157,48 @@ struct IFireboltAccessor {
     */
     virtual void ErrorListener(OnError notification) = 0;
 
+    /**
+     * @brief Statistics of the calls made so far, as a JSON document: per method the number of calls, errors,
+     * timeouts, payload bytes sent and received and a latency distribution from sending a request until its
+     * response came in, plus how long responses waited for a worker thread. Times are in microseconds.
+     *
+     * Format:
+     *  {
+     *     "transport": {
+     *       "methods": {
+     *         "Device.id": { "calls": 2, "errors": 0, "timeouts": 0, "bytesOut": 11, "bytesIn": 16,
+     *                        "latency": { "count": 2, "mean": 812, "p50": 767, "p90": 895, "p99": 895, "p999": 895, "max": 858 } }
+     *       },
+     *       "queueWait": { "count": 2, ... }
+     *     },
+     *     "workerPool": { "threads": 3, "busy": 0, ... }
+     *  }
+     *
+     * @return std::string
+     */
+    virtual std::string Statistics ( ) const = 0;
+
+    /**
+     * @brief Start or stop recording where the time of each call goes: parameter serialization, sending,
+     * the socket write, waiting for the response, the worker queue, deserialization and user callbacks.
+     * Off by default.
+     *
+     * @param enabled true to record
+     *
+     * @return None
+     */
+    virtual void EnableTracing ( const bool enabled ) = 0;
+
+    /**
+     * @brief Write the recorded trace to a file in Chrome trace format, to be opened in chrome://tracing or ui.perfetto.dev.
+     * Each thread keeps its last 2048 spans.
+     *
+     * @param fileName Path of the file to write
+     *
+     * @return Firebolt::Error
+     */
+    virtual Firebolt::Error DumpTrace ( const std::string& fileName ) const = 0;
+
 
     // Module Instance methods goes here.
     // Instances are owned by the FireboltAcccessor and linked with its lifecycle.
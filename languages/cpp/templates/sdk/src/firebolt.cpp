@@ -113,6 +113,25 @@ namespace Firebolt {
         {
         }
 
+        std::string Statistics() const override
+        {
+            std::string statistics;
+            if (_accessor != nullptr) {
+                _accessor->GetStatistics(statistics);
+            }
+            return statistics;
+        }
+
+        void EnableTracing(const bool enabled) override
+        {
+            FireboltSDK::Tracer::Enable(enabled);
+        }
+
+        Firebolt::Error DumpTrace(const std::string& fileName) const override
+        {
+            return FireboltSDK::Tracer::Dump(fileName);
+        }
+
 ${module.init}
     private:
         FireboltSDK::Accessor* _accessor;
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2021 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+import { readFileSync } from 'fs'
+import path from 'path'
+import Ajv from 'ajv'
+import { expect } from '@jest/globals';
+
+const fireboltOpenRpcSpec = JSON.parse(readFileSync(path.join(process.cwd(), 'src', 'firebolt-openrpc.json')))
+const ajv = new Ajv({ strict: false })
+ajv.addSchema(fireboltOpenRpcSpec)
+
+const tag = ajv.compile({ $ref: fireboltOpenRpcSpec.$id + '#/definitions/CoalesceTag' })
+const method = ajv.compile({ $ref: fireboltOpenRpcSpec.$id + '#/definitions/CoalesceMethod' })
+
+test('Coalesce tag is valid', () => {
+    expect(tag({ name: 'coalesce' })).toBe(true)
+});
+
+test('Coalesce tag accepts x-since', () => {
+    expect(tag({ name: 'coalesce', 'x-since': '1.0.0' })).toBe(true)
+});
+
+test('Coalesce tag rejects unknown attributes', () => {
+    expect(tag({ name: 'coalesce', 'x-setter-for': 'Simple.setProperty' })).toBe(false)
+});
+
+test('Coalesce tag must be named coalesce', () => {
+    expect(tag({ name: 'calls-metrics' })).toBe(false)
+});
+
+test('Coalesce method has the coalesce tag', () => {
+    expect(method({ name: 'property', tags: [ { name: 'property' }, { name: 'coalesce' } ] })).toBe(true)
+    expect(method({ name: 'property', tags: [ { name: 'property' } ] })).toBe(false)
+});